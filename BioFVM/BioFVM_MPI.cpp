@@ -0,0 +1,584 @@
+/*
+#############################################################################
+# If you use BioFVM in your project, please cite BioFVM and the version     #
+# number, such as below:                                                    #
+#                                                                           #
+# We solved the diffusion equations using BioFVM (Version 1.1.7) [1]        #
+#                                                                           #
+# [1] A. Ghaffarizadeh, S.H. Friedman, and P. Macklin, BioFVM: an efficient #
+#    parallelized diffusive transport solver for 3-D biological simulations,#
+#    Bioinformatics 32(8): 1256-8, 2016. DOI: 10.1093/bioinformatics/btv730 #
+#                                                                           #
+#############################################################################
+#                                                                           #
+# BSD 3-Clause License (see https://opensource.org/licenses/BSD-3-Clause)   #
+#                                                                           #
+# Copyright (c) 2015-2025, Paul Macklin and the BioFVM Project              #
+# All rights reserved.                                                      #
+#                                                                           #
+# Redistribution and use in source and binary forms, with or without        #
+# modification, are permitted provided that the following conditions are    #
+# met:                                                                      #
+#                                                                           #
+# 1. Redistributions of source code must retain the above copyright notice, #
+# this list of conditions and the following disclaimer.                     #
+#                                                                           #
+# 2. Redistributions in binary form must reproduce the above copyright      #
+# notice, this list of conditions and the following disclaimer in the       #
+# documentation and/or other materials provided with the distribution.      #
+#                                                                           #
+# 3. Neither the name of the copyright holder nor the names of its          #
+# contributors may be used to endorse or promote products derived from this #
+# software without specific prior written permission.                       #
+#                                                                           #
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       #
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED #
+# TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A           #
+# PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER #
+# OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,  #
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,       #
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR        #
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF    #
+# LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING      #
+# NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS        #
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.              #
+#                                                                           #
+#############################################################################
+*/
+
+#ifdef BioFVM_MPI 
+
+#include "BioFVM_MPI.h" 
+#include "BioFVM_solvers.h" 
+
+#include <iostream>
+#include <cmath>
+#include <omp.h>
+
+namespace BioFVM{
+
+Domain_Decomposition::Domain_Decomposition()
+{
+	communicator = MPI_COMM_WORLD; 
+	rank = 0; 
+	size = 1; 
+	
+	global_bounding_box.assign( 6 , 0.0 ); 
+	global_z_nodes = 1; 
+	z_offsets.assign( 2 , 0 ); 
+	z_offsets[1] = 1; 
+	z_offset = 0; 
+	local_z_nodes = 1; 
+	
+	pipeline_chunks = 1; 
+	
+	return; 
+}
+
+void Domain_Decomposition::setup( Microenvironment& M , MPI_Comm comm , 
+	double x_start, double x_end, double y_start, double y_end, double z_start, double z_end , 
+	double dx, double dy, double dz )
+{
+	communicator = comm; 
+	MPI_Comm_rank( communicator , &rank ); 
+	MPI_Comm_size( communicator , &size ); 
+	
+	global_bounding_box[0] = x_start; 
+	global_bounding_box[1] = y_start; 
+	global_bounding_box[2] = z_start; 
+	global_bounding_box[3] = x_end; 
+	global_bounding_box[4] = y_end; 
+	global_bounding_box[5] = z_end; 
+	
+	// same node count as Cartesian_Mesh::resize 
+	double eps = 1e-16; 
+	global_z_nodes = (int) ceil( eps + (z_end-z_start)/dz ); 
+	if( global_z_nodes < size )
+	{
+		std::cout << "Error: only " << global_z_nodes << " z-planes for " << size << " ranks. " 
+			<< "Each rank needs at least one z-plane." << std::endl; 
+		MPI_Abort( communicator , -1 ); 
+	}
+	
+	// split the z-planes as evenly as possible 
+	z_offsets.assign( size+1 , 0 ); 
+	for( int r=0 ; r < size ; r++ )
+	{
+		int planes = global_z_nodes / size; 
+		if( r < global_z_nodes % size )
+		{ planes++; }
+		z_offsets[r+1] = z_offsets[r] + planes; 
+	}
+	z_offset = z_offsets[rank]; 
+	local_z_nodes = z_offsets[rank+1] - z_offsets[rank]; 
+	
+	// Cartesian_Mesh::resize rounds the node count up, so ask for half a 
+	// plane less and then restore the true upper bound 
+	double local_z_start = z_start + z_offset*dz; 
+	double local_z_end = local_z_start + local_z_nodes*dz; 
+	M.resize_space( x_start, x_end, y_start, y_end, local_z_start, local_z_end - 0.5*dz , dx, dy, dz ); 
+	M.mesh.bounding_box[5] = local_z_end; 
+	
+	M.decomposition = this; 
+	M.diffusion_decay_solver = diffusion_decay_solver__constant_coefficients_LOD_3D_MPI; 
+	M.diffusion_solver_setup_done = false; 
+	
+	int ny = M.mesh.y_coordinates.size(); 
+	pipeline_chunks = 4*size; 
+	if( pipeline_chunks > ny )
+	{ pipeline_chunks = ny; } 
+	
+	return; 
+}
+
+int Domain_Decomposition::owner_rank( double z )
+{
+	double dz = (global_bounding_box[5] - global_bounding_box[2]) / (double) global_z_nodes; 
+	int k = (int) floor( (z - global_bounding_box[2]) / dz ); 
+	
+	// agents outside the domain stay with the first or last rank 
+	if( k < 0 )
+	{ return 0; }
+	if( k >= global_z_nodes )
+	{ return size-1; }
+	
+	int r = 0; 
+	while( z_offsets[r+1] <= k )
+	{ r++; }
+	return r; 
+}
+
+bool Domain_Decomposition::is_local( std::vector<double>& position )
+{ return owner_rank( position[2] ) == rank; }
+
+void Domain_Decomposition::precompute_z_coefficients( Microenvironment& M )
+{
+	// the z-part of LOD_3D_precompute_coefficients, for the global z-lines 
+	thomas_cz.assign( global_z_nodes , M.thomas_constant1a ); 
+	thomas_denomz.assign( global_z_nodes , M.thomas_constant3 ); 
+	thomas_denomz[0] = M.thomas_constant3a; 
+	thomas_denomz[ global_z_nodes-1 ] = M.thomas_constant3a; 
+	if( global_z_nodes == 1 )
+	{ thomas_denomz[0] = M.one; thomas_denomz[0] += M.thomas_constant2; } 
+
+	thomas_cz[0] /= thomas_denomz[0]; 
+	for( int i=1 ; i <= global_z_nodes-1 ; i++ )
+	{ 
+		axpy( &thomas_denomz[i] , M.thomas_constant1 , thomas_cz[i-1] ); 
+		thomas_cz[i] /= thomas_denomz[i]; // the value at  size-1 is not actually used  
+	}
+	
+	return; 
+}
+
+void Domain_Decomposition::exchange_halos( Microenvironment& M )
+{
+	int nq = M.number_of_densities(); 
+	int plane_voxels = M.mesh.x_coordinates.size() * M.mesh.y_coordinates.size(); 
+	int plane_size = plane_voxels * nq; 
+	
+	int lower = rank > 0 ? rank-1 : MPI_PROC_NULL; 
+	int upper = rank < size-1 ? rank+1 : MPI_PROC_NULL; 
+	
+	std::vector<double> first_plane( plane_size ); 
+	std::vector<double> last_plane( plane_size ); 
+	int last = (local_z_nodes-1)*plane_voxels; 
+	for( int n=0 ; n < plane_voxels ; n++ )
+	{
+		std::vector<double>& first_density = M.density_vector( n ); 
+		std::vector<double>& last_density = M.density_vector( last+n ); 
+		for( int q=0 ; q < nq ; q++ )
+		{
+			first_plane[n*nq+q] = first_density[q]; 
+			last_plane[n*nq+q] = last_density[q]; 
+		}
+	}
+	
+	lower_halo.assign( plane_size , 0.0 ); 
+	upper_halo.assign( plane_size , 0.0 ); 
+	
+	MPI_Sendrecv( last_plane.data() , plane_size , MPI_DOUBLE , upper , 0 , 
+		lower_halo.data() , plane_size , MPI_DOUBLE , lower , 0 , communicator , MPI_STATUS_IGNORE ); 
+	MPI_Sendrecv( first_plane.data() , plane_size , MPI_DOUBLE , lower , 1 , 
+		upper_halo.data() , plane_size , MPI_DOUBLE , upper , 1 , communicator , MPI_STATUS_IGNORE ); 
+
+	return; 
+}
+
+void Domain_Decomposition::compute_all_gradient_vectors( Microenvironment& M )
+{
+	M.compute_all_gradient_vectors(); 
+	exchange_halos( M ); 
+	
+	int nq = M.number_of_densities(); 
+	int plane_voxels = M.mesh.x_coordinates.size() * M.mesh.y_coordinates.size(); 
+	double dz = M.mesh.dz; 
+	double two_dz = 2.0 * dz; 
+	
+	// redo the z-derivatives on the first and last local planes, where 
+	// compute_all_gradient_vectors only saw one side 
+	std::vector<int> planes( 1 , 0 ); 
+	if( local_z_nodes > 1 )
+	{ planes.push_back( local_z_nodes-1 ); }
+	
+	for( unsigned int p=0 ; p < planes.size() ; p++ )
+	{
+		int k = planes[p]; 
+		bool has_lower = ( k > 0 || rank > 0 ); 
+		bool has_upper = ( k < local_z_nodes-1 || rank < size-1 ); 
+		
+		#pragma omp parallel for 
+		for( int m=0 ; m < plane_voxels ; m++ )
+		{
+			int n = k*plane_voxels + m; 
+			std::vector<double>& center = M.density_vector(n); 
+			for( int q=0 ; q < nq ; q++ )
+			{
+				double below = center[q]; 
+				double above = center[q]; 
+				if( k > 0 )
+				{ below = M.density_vector(n-plane_voxels)[q]; }
+				else if( has_lower )
+				{ below = lower_halo[m*nq+q]; }
+				if( k < local_z_nodes-1 )
+				{ above = M.density_vector(n+plane_voxels)[q]; }
+				else if( has_upper )
+				{ above = upper_halo[m*nq+q]; }
+				
+				double& gradient_z = M.gradient_vectors[n][q][2]; 
+				gradient_z = above; 
+				gradient_z -= below; 
+				if( has_lower && has_upper )
+				{ gradient_z /= two_dz; }
+				else 
+				{ gradient_z /= dz; }
+			}
+			M.gradient_vector_epochs[n] = M.gradient_epoch; 
+		}
+	}
+	
+	return; 
+}
+
+int Domain_Decomposition::migrate_basic_agents( Microenvironment& M )
+{
+	int nq = M.number_of_densities(); 
+	// ID, type, volume, position, velocity, then five rate vectors 
+	int record_size = 9 + 5*nq; 
+	
+	std::vector< std::vector<double> > outgoing( size ); 
+	for( int i = all_basic_agents.size()-1 ; i >= 0 ; i-- )
+	{
+		Basic_Agent* pAgent = all_basic_agents[i]; 
+		int destination = owner_rank( pAgent->position[2] ); 
+		if( destination == rank )
+		{ continue; } 
+		
+		std::vector<double>& record = outgoing[destination]; 
+		record.push_back( pAgent->ID ); 
+		record.push_back( pAgent->type ); 
+		record.push_back( pAgent->get_total_volume() ); 
+		record.insert( record.end() , pAgent->position.begin() , pAgent->position.end() ); 
+		record.insert( record.end() , pAgent->velocity.begin() , pAgent->velocity.end() ); 
+		record.insert( record.end() , pAgent->secretion_rates->begin() , pAgent->secretion_rates->end() ); 
+		record.insert( record.end() , pAgent->saturation_densities->begin() , pAgent->saturation_densities->end() ); 
+		record.insert( record.end() , pAgent->uptake_rates->begin() , pAgent->uptake_rates->end() ); 
+		record.insert( record.end() , pAgent->net_export_rates->begin() , pAgent->net_export_rates->end() ); 
+		record.insert( record.end() , pAgent->internalized_substrates->begin() , pAgent->internalized_substrates->end() ); 
+		
+		delete_basic_agent( i ); 
+	}
+	
+	std::vector<int> send_counts( size , 0 ); 
+	std::vector<int> send_offsets( size , 0 ); 
+	std::vector<double> send_buffer; 
+	for( int r=0 ; r < size ; r++ )
+	{
+		send_counts[r] = outgoing[r].size(); 
+		send_offsets[r] = send_buffer.size(); 
+		send_buffer.insert( send_buffer.end() , outgoing[r].begin() , outgoing[r].end() ); 
+	}
+	
+	std::vector<int> receive_counts( size , 0 ); 
+	MPI_Alltoall( send_counts.data() , 1 , MPI_INT , receive_counts.data() , 1 , MPI_INT , communicator ); 
+	
+	std::vector<int> receive_offsets( size , 0 ); 
+	int total = 0; 
+	for( int r=0 ; r < size ; r++ )
+	{
+		receive_offsets[r] = total; 
+		total += receive_counts[r]; 
+	}
+	std::vector<double> incoming( total ); 
+	
+	MPI_Alltoallv( send_buffer.data() , send_counts.data() , send_offsets.data() , MPI_DOUBLE , 
+		incoming.data() , receive_counts.data() , receive_offsets.data() , MPI_DOUBLE , communicator ); 
+	
+	int number_received = total / record_size; 
+	for( int a=0 ; a < number_received ; a++ )
+	{
+		double* pRecord = incoming.data() + a*record_size; 
+		
+		Basic_Agent* pAgent = create_basic_agent(); 
+		pAgent->register_microenvironment( &M ); 
+		pAgent->ID = (int) pRecord[0]; 
+		pAgent->type = (int) pRecord[1]; 
+		pAgent->set_total_volume( pRecord[2] ); 
+		pAgent->velocity.assign( pRecord+6 , pRecord+9 ); 
+		
+		double* pRates = pRecord + 9; 
+		pAgent->secretion_rates->assign( pRates , pRates+nq ); 
+		pAgent->saturation_densities->assign( pRates+nq , pRates+2*nq ); 
+		pAgent->uptake_rates->assign( pRates+2*nq , pRates+3*nq ); 
+		pAgent->net_export_rates->assign( pRates+3*nq , pRates+4*nq ); 
+		pAgent->internalized_substrates->assign( pRates+4*nq , pRates+5*nq ); 
+		
+		if( pAgent->assign_position( pRecord[3] , pRecord[4] , pRecord[5] ) == false )
+		{
+			// outside the global domain: keep the position, but leave it inactive 
+			pAgent->position.assign( pRecord+3 , pRecord+6 ); 
+			pAgent->update_voxel_index(); 
+		}
+	}
+	
+	return number_received; 
+}
+
+void Domain_Decomposition::exchange_ghost_agents( double cutoff , std::vector<Ghost_Agent>& ghosts )
+{
+	double dz = (global_bounding_box[5] - global_bounding_box[2]) / (double) global_z_nodes; 
+	double local_z_start = global_bounding_box[2] + z_offset*dz; 
+	double local_z_end = local_z_start + local_z_nodes*dz; 
+	
+	// ID, type, volume, position 
+	const int record_size = 6; 
+	std::vector<double> to_lower; 
+	std::vector<double> to_upper; 
+	for( unsigned int i=0 ; i < all_basic_agents.size() ; i++ )
+	{
+		Basic_Agent* pAgent = all_basic_agents[i]; 
+		double record[record_size] = { (double) pAgent->ID , (double) pAgent->type , pAgent->get_total_volume() , 
+			pAgent->position[0] , pAgent->position[1] , pAgent->position[2] }; 
+		if( rank > 0 && pAgent->position[2] < local_z_start + cutoff )
+		{ to_lower.insert( to_lower.end() , record , record+record_size ); }
+		if( rank < size-1 && pAgent->position[2] > local_z_end - cutoff )
+		{ to_upper.insert( to_upper.end() , record , record+record_size ); }
+	}
+	
+	int lower = rank > 0 ? rank-1 : MPI_PROC_NULL; 
+	int upper = rank < size-1 ? rank+1 : MPI_PROC_NULL; 
+	
+	int send_lower = to_lower.size(); 
+	int send_upper = to_upper.size(); 
+	int receive_lower = 0; 
+	int receive_upper = 0; 
+	MPI_Sendrecv( &send_upper , 1 , MPI_INT , upper , 2 , &receive_lower , 1 , MPI_INT , lower , 2 , communicator , MPI_STATUS_IGNORE ); 
+	MPI_Sendrecv( &send_lower , 1 , MPI_INT , lower , 3 , &receive_upper , 1 , MPI_INT , upper , 3 , communicator , MPI_STATUS_IGNORE ); 
+	
+	std::vector<double> from_lower( receive_lower ); 
+	std::vector<double> from_upper( receive_upper ); 
+	MPI_Sendrecv( to_upper.data() , send_upper , MPI_DOUBLE , upper , 4 , 
+		from_lower.data() , receive_lower , MPI_DOUBLE , lower , 4 , communicator , MPI_STATUS_IGNORE ); 
+	MPI_Sendrecv( to_lower.data() , send_lower , MPI_DOUBLE , lower , 5 , 
+		from_upper.data() , receive_upper , MPI_DOUBLE , upper , 5 , communicator , MPI_STATUS_IGNORE ); 
+	
+	from_lower.insert( from_lower.end() , from_upper.begin() , from_upper.end() ); 
+	ghosts.resize( from_lower.size() / record_size ); 
+	for( unsigned int g=0 ; g < ghosts.size() ; g++ )
+	{
+		double* pRecord = from_lower.data() + g*record_size; 
+		ghosts[g].ID = (int) pRecord[0]; 
+		ghosts[g].type = (int) pRecord[1]; 
+		ghosts[g].volume = pRecord[2]; 
+		ghosts[g].position.assign( pRecord+3 , pRecord+6 ); 
+	}
+	
+	return; 
+}
+
+std::vector<double> Domain_Decomposition::gather_densities( Microenvironment& M )
+{
+	int nq = M.number_of_densities(); 
+	int plane_size = M.mesh.x_coordinates.size() * M.mesh.y_coordinates.size() * nq; 
+	
+	std::vector<double> local( M.mesh.voxels.size() * nq ); 
+	for( unsigned int n=0 ; n < M.mesh.voxels.size() ; n++ )
+	{
+		for( int q=0 ; q < nq ; q++ )
+		{ local[n*nq+q] = M.density_vector(n)[q]; }
+	}
+	
+	std::vector<int> counts( size ); 
+	std::vector<int> offsets( size ); 
+	for( int r=0 ; r < size ; r++ )
+	{
+		counts[r] = ( z_offsets[r+1] - z_offsets[r] ) * plane_size; 
+		offsets[r] = z_offsets[r] * plane_size; 
+	}
+	
+	std::vector<double> global; 
+	if( rank == 0 )
+	{ global.resize( global_z_nodes * plane_size ); }
+	MPI_Gatherv( local.data() , local.size() , MPI_DOUBLE , 
+		global.data() , counts.data() , offsets.data() , MPI_DOUBLE , 0 , communicator ); 
+	
+	return global; 
+}
+
+void diffusion_decay_solver__constant_coefficients_LOD_3D_MPI( Microenvironment& M, double dt )
+{
+	Domain_Decomposition* pD = M.decomposition; 
+	if( pD == NULL )
+	{
+		std::cout << "Warning: the MPI diffusion solver needs a Domain_Decomposition. " 
+			<< "Falling back to the serial LOD_3D solver." << std::endl; 
+		diffusion_decay_solver__constant_coefficients_LOD_3D( M , dt ); 
+		return; 
+	}
+	
+	if( !M.diffusion_solver_setup_done )
+	{
+		if( pD->rank == 0 )
+		{
+			std::cout << std::endl << "Using method " << __FUNCTION__ << " (implicit 3-D LOD with Thomas Algorithm, " 
+				<< pD->size << " MPI ranks) ... " << std::endl << std::endl;  
+		}
+		LOD_3D_precompute_coefficients( M , dt ); 
+		pD->precompute_z_coefficients( M ); 
+		M.diffusion_solver_setup_done = true; 
+	}
+	
+	Contiguous_Density_Storage& D = M.gather_contiguous_densities( density_storage_voxel_major ); 
+	double* pData = D.data(); 
+	
+	int nx = M.mesh.x_coordinates.size(); 
+	int ny = M.mesh.y_coordinates.size(); 
+	int nz = pD->local_z_nodes; 
+	size_t vs = D.voxel_stride; 
+	unsigned int nq = D.number_of_densities; 
+	
+	// x- and y-diffusion: whole lines on this rank 
+	
+	M.apply_dirichlet_conditions( D ); 
+	#pragma omp parallel for 
+	for( int line=0 ; line < ny*nz ; line++ )
+	{
+		contiguous_thomas_solve( pData + line*nx*vs , vs , nx , 1 , nq , 
+			M.thomas_denomx , M.thomas_cx , M.thomas_constant1 ); 
+	}
+	
+	M.apply_dirichlet_conditions( D ); 
+	#pragma omp parallel for 
+	for( int line=0 ; line < nx*nz ; line++ )
+	{
+		int i = line % nx; 
+		int k = line / nx; 
+		contiguous_thomas_solve( pData + (k*nx*ny+i)*vs , nx*vs , ny , 1 , nq , 
+			M.thomas_denomy , M.thomas_cy , M.thomas_constant1 ); 
+	}
+	
+	// z-diffusion: the z-lines cross the ranks. Forward elimination passes 
+	// the last plane of rank r to rank r+1, back substitution passes the 
+	// first plane of rank r+1 back to rank r. The plane is sent in chunks 
+	// of y-rows so that neighboring ranks work at the same time. 
+	
+	M.apply_dirichlet_conditions( D ); 
+	
+	int lower = pD->rank > 0 ? pD->rank-1 : MPI_PROC_NULL; 
+	int upper = pD->rank < pD->size-1 ? pD->rank+1 : MPI_PROC_NULL; 
+	int plane = nx*ny*vs; 
+	int chunks = pD->pipeline_chunks; 
+	std::vector< std::vector<double> >& denom = pD->thomas_denomz; 
+	std::vector< std::vector<double> >& c = pD->thomas_cz; 
+	std::vector<double>& constant1 = M.thomas_constant1; 
+	std::vector<double>& buffer = pD->receive_buffer; 
+	buffer.resize( plane ); 
+	int K0 = pD->z_offset; 
+	
+	for( int chunk=0 ; chunk < chunks ; chunk++ )
+	{
+		int start = ( (chunk*ny) / chunks ) * nx; 
+		int end = ( ((chunk+1)*ny) / chunks ) * nx; 
+		int count = (end-start)*vs; 
+		
+		if( lower != MPI_PROC_NULL )
+		{ MPI_Recv( buffer.data() , count , MPI_DOUBLE , lower , chunk , pD->communicator , MPI_STATUS_IGNORE ); }
+		
+		#pragma omp parallel for 
+		for( int m=start ; m < end ; m++ )
+		{
+			double* pV = pData + m*vs; 
+			if( lower == MPI_PROC_NULL )
+			{
+				for( unsigned int q=0 ; q < nq ; q++ )
+				{ pV[q] /= denom[0][q]; }
+			}
+			else
+			{
+				double* pPrevious = buffer.data() + (m-start)*vs; 
+				for( unsigned int q=0 ; q < nq ; q++ )
+				{
+					pV[q] += constant1[q] * pPrevious[q]; 
+					pV[q] /= denom[K0][q]; 
+				}
+			}
+			for( int k=1 ; k < nz ; k++ )
+			{
+				pV += plane; 
+				double* pPrevious = pV - plane; 
+				const double* pDenom = denom[K0+k].data(); 
+				for( unsigned int q=0 ; q < nq ; q++ )
+				{
+					pV[q] += constant1[q] * pPrevious[q]; 
+					pV[q] /= pDenom[q]; 
+				}
+			}
+		}
+		
+		if( upper != MPI_PROC_NULL )
+		{ MPI_Send( pData + (nz-1)*plane + start*vs , count , MPI_DOUBLE , upper , chunk , pD->communicator ); }
+	}
+	
+	for( int chunk=0 ; chunk < chunks ; chunk++ )
+	{
+		int start = ( (chunk*ny) / chunks ) * nx; 
+		int end = ( ((chunk+1)*ny) / chunks ) * nx; 
+		int count = (end-start)*vs; 
+		
+		if( upper != MPI_PROC_NULL )
+		{ MPI_Recv( buffer.data() , count , MPI_DOUBLE , upper , chunks+chunk , pD->communicator , MPI_STATUS_IGNORE ); }
+		
+		#pragma omp parallel for 
+		for( int m=start ; m < end ; m++ )
+		{
+			double* pV = pData + (nz-1)*plane + m*vs; 
+			if( upper != MPI_PROC_NULL )
+			{
+				double* pNext = buffer.data() + (m-start)*vs; 
+				const double* pC = c[K0+nz-1].data(); 
+				for( unsigned int q=0 ; q < nq ; q++ )
+				{ pV[q] -= pC[q] * pNext[q]; }
+			}
+			for( int k=nz-2 ; k >= 0 ; k-- )
+			{
+				pV -= plane; 
+				double* pNext = pV + plane; 
+				const double* pC = c[K0+k].data(); 
+				for( unsigned int q=0 ; q < nq ; q++ )
+				{ pV[q] -= pC[q] * pNext[q]; }
+			}
+		}
+		
+		if( lower != MPI_PROC_NULL )
+		{ MPI_Send( pData + start*vs , count , MPI_DOUBLE , lower , chunks+chunk , pD->communicator ); }
+	}
+	
+	M.apply_dirichlet_conditions( D ); 
+	M.scatter_contiguous_densities(); 
+	
+	return; 
+}
+
+};
+
+#endif
@@ -0,0 +1,154 @@
+/*
+#############################################################################
+# If you use BioFVM in your project, please cite BioFVM and the version     #
+# number, such as below:                                                    #
+#                                                                           #
+# We solved the diffusion equations using BioFVM (Version 1.1.7) [1]        #
+#                                                                           #
+# [1] A. Ghaffarizadeh, S.H. Friedman, and P. Macklin, BioFVM: an efficient #
+#    parallelized diffusive transport solver for 3-D biological simulations,#
+#    Bioinformatics 32(8): 1256-8, 2016. DOI: 10.1093/bioinformatics/btv730 #
+#                                                                           #
+#############################################################################
+#                                                                           #
+# BSD 3-Clause License (see https://opensource.org/licenses/BSD-3-Clause)   #
+#                                                                           #
+# Copyright (c) 2015-2025, Paul Macklin and the BioFVM Project              #
+# All rights reserved.                                                      #
+#                                                                           #
+# Redistribution and use in source and binary forms, with or without        #
+# modification, are permitted provided that the following conditions are    #
+# met:                                                                      #
+#                                                                           #
+# 1. Redistributions of source code must retain the above copyright notice, #
+# this list of conditions and the following disclaimer.                     #
+#                                                                           #
+# 2. Redistributions in binary form must reproduce the above copyright      #
+# notice, this list of conditions and the following disclaimer in the       #
+# documentation and/or other materials provided with the distribution.      #
+#                                                                           #
+# 3. Neither the name of the copyright holder nor the names of its          #
+# contributors may be used to endorse or promote products derived from this #
+# software without specific prior written permission.                       #
+#                                                                           #
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       #
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED #
+# TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A           #
+# PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER #
+# OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,  #
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,       #
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR        #
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF    #
+# LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING      #
+# NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS        #
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.              #
+#                                                                           #
+#############################################################################
+*/
+
+#ifndef __BioFVM_MPI_h__
+#define __BioFVM_MPI_h__
+
+/* Distributed-memory BioFVM (new in 1.14.3). Only compiled when the 
+   project is built with mpicxx and -DBioFVM_MPI; see tests/mpi. 
+   
+   Scope: BioFVM only. The mesh, the LOD solver, the gradients, and 
+   Basic_Agent objects are distributed. PhysiCell is not: Cell objects 
+   (their phenotypes are not serialized), Cell_Container and its mechanics 
+   grid, and all_cells stay process-global. So a PhysiCell model still 
+   runs on one node. */ 
+
+#ifdef BioFVM_MPI 
+
+#include <mpi.h>
+
+#include "BioFVM_microenvironment.h" 
+#include "BioFVM_basic_agent.h" 
+
+namespace BioFVM{
+
+/*! A lightweight copy of an agent owned by a neighboring rank, close 
+    enough to the slab boundary to matter for local neighbor searches. */ 
+
+struct Ghost_Agent
+{
+	int ID; 
+	int type; 
+	double volume; 
+	std::vector<double> position; 
+};
+
+/*! Slab decomposition of a 3-D Cartesian microenvironment along z. 
+    Each rank holds a contiguous range of z-planes in its own 
+    Microenvironment: the x- and y-sweeps of the LOD solver stay local, 
+    and the z-sweep runs a pipelined Thomas solve across the ranks, so 
+    the result is identical to the serial LOD_3D solver. */ 
+
+class Domain_Decomposition
+{
+ private:
+	// Thomas coefficients of the global z-lines 
+	std::vector< std::vector<double> > thomas_denomz; 
+	std::vector< std::vector<double> > thomas_cz; 
+	
+	std::vector<double> receive_buffer; 
+	
+	void precompute_z_coefficients( Microenvironment& M ); 
+	
+ public:
+	MPI_Comm communicator; 
+	int rank; 
+	int size; 
+	
+	std::vector<double> global_bounding_box; 
+	int global_z_nodes; 
+	
+	// rank r owns the z-planes z_offsets[r] <= k < z_offsets[r+1] 
+	std::vector<int> z_offsets; 
+	int z_offset; 
+	int local_z_nodes; 
+	
+	// number of pieces a z-sweep is split into, so that rank r+1 can 
+	// start on the first piece while rank r works on the next 
+	int pipeline_chunks; 
+	
+	// densities of the planes just below and above the local slab 
+	// (voxel-major), filled by exchange_halos 
+	std::vector<double> lower_halo; 
+	std::vector<double> upper_halo; 
+	
+	Domain_Decomposition(); 
+	
+	// resize M to the local slab of the global domain, and select the MPI solver 
+	void setup( Microenvironment& M , MPI_Comm comm , 
+		double x_start, double x_end, double y_start, double y_end, double z_start, double z_end , 
+		double dx, double dy, double dz ); 
+	
+	int owner_rank( double z ); 
+	bool is_local( std::vector<double>& position ); 
+	
+	void exchange_halos( Microenvironment& M ); 
+	// Microenvironment::compute_all_gradient_vectors, plus central z-differences 
+	// across the slab boundaries 
+	void compute_all_gradient_vectors( Microenvironment& M ); 
+	
+	// send every Basic_Agent whose position left the local slab to its new 
+	// owner; returns the number of agents received 
+	int migrate_basic_agents( Microenvironment& M ); 
+	// collect copies of the neighbors' agents within cutoff of the local slab 
+	void exchange_ghost_agents( double cutoff , std::vector<Ghost_Agent>& ghosts ); 
+	
+	// gather a voxel-major copy of all densities on rank 0 (empty on other ranks) 
+	std::vector<double> gather_densities( Microenvironment& M ); 
+	
+	friend void diffusion_decay_solver__constant_coefficients_LOD_3D_MPI( Microenvironment& M, double dt ); 
+};
+
+// /*! diffusion-decay solver: 3D LOD implicit on a Domain_Decomposition slab */ 
+void diffusion_decay_solver__constant_coefficients_LOD_3D_MPI( Microenvironment& M, double dt ); 
+
+};
+
+#endif
+
+#endif
@@ -93,6 +93,30 @@ Basic_Agent::Basic_Agent()
 	return;	
 }
 
+void Basic_Agent::reinitialize( void )
+{
+	ID = max_basic_agent_ID; 
+	max_basic_agent_ID++; 
+	is_active=true;
+	
+	volume = 1.0; 
+	
+	position.assign( 3 , 0.0 ); 
+	velocity.assign( 3 , 0.0 );
+	previous_velocity.assign( 3 , 0.0 ); 
+	
+	// the rate vectors are kept (they may already be linked to a phenotype), 
+	// but the solver temporaries must start over as in register_microenvironment 
+	cell_source_sink_solver_temp1.clear(); 
+	cell_source_sink_solver_temp2.clear(); 
+	cell_source_sink_solver_temp_export1.clear(); 
+	cell_source_sink_solver_temp_export2.clear(); 
+	total_extracellular_substrate_change.clear(); 
+	register_microenvironment( get_default_microenvironment() );
+	
+	return; 
+}
+
 void Basic_Agent::update_position(double dt){ 
 //make sure to update current_voxel_index if you are implementing this function
 };
@@ -321,27 +345,47 @@ void Basic_Agent::simulate_secretion_and_uptake( Microenvironment* pS, double dt
 		volume_is_changed = false;
 	}
 	
+	// one fused pass over the substrates, with the same operations in the 
+	// same order as the former BioFVM vector operations 
+	std::vector<double>& rho = (*pS)(current_voxel_index); 
+	const double* c1 = cell_source_sink_solver_temp1.data(); 
+	const double* c2 = cell_source_sink_solver_temp2.data(); 
+	const double* export2 = cell_source_sink_solver_temp_export2.data(); 
+	int number_of_densities = rho.size(); 
+	
 	if( default_microenvironment_options.track_internalized_substrates_in_each_agent == true )
 	{
-		total_extracellular_substrate_change.assign( total_extracellular_substrate_change.size() , 1.0 ); // 1
-
-		total_extracellular_substrate_change -= cell_source_sink_solver_temp2; // 1-c2
-		total_extracellular_substrate_change *= (*pS)(current_voxel_index); // (1-c2)*rho 
-		total_extracellular_substrate_change += cell_source_sink_solver_temp1; // (1-c2)*rho+c1 
-		total_extracellular_substrate_change /= cell_source_sink_solver_temp2; // ((1-c2)*rho+c1)/c2
-		total_extracellular_substrate_change *= pS->voxels(current_voxel_index).volume; // W*((1-c2)*rho+c1)/c2 
+		const double* export1 = cell_source_sink_solver_temp_export1.data(); 
+		double voxel_volume = pS->voxels(current_voxel_index).volume; 
+		std::vector<double>& internal = *internalized_substrates; 
 		
-		*internalized_substrates -= total_extracellular_substrate_change; // opposite of net extracellular change 	
+		for( int q=0 ; q < number_of_densities ; q++ )
+		{
+			double change = 1.0; // 1
+			change -= c2[q]; // 1-c2
+			change *= rho[q]; // (1-c2)*rho 
+			change += c1[q]; // (1-c2)*rho+c1 
+			change /= c2[q]; // ((1-c2)*rho+c1)/c2
+			change *= voxel_volume; // W*((1-c2)*rho+c1)/c2 
+			total_extracellular_substrate_change[q] = change; 
+			
+			internal[q] -= change; // opposite of net extracellular change 
+			
+			// rho = (rho + c1)/c2, then net export 
+			rho[q] += c1[q]; 
+			rho[q] /= c2[q]; 
+			rho[q] += export2[q]; 
+			
+			internal[q] -= export1[q]; 
+		}
+		return; 
 	}
 	
-	(*pS)(current_voxel_index) += cell_source_sink_solver_temp1; 
-	(*pS)(current_voxel_index) /= cell_source_sink_solver_temp2; 
-	
-	// now do net export 
-	(*pS)(current_voxel_index) += cell_source_sink_solver_temp_export2; 
-	if( default_microenvironment_options.track_internalized_substrates_in_each_agent == true ) 
+	for( int q=0 ; q < number_of_densities ; q++ )
 	{
-		*internalized_substrates -= cell_source_sink_solver_temp_export1; 
+		rho[q] += c1[q]; 
+		rho[q] /= c2[q]; 
+		rho[q] += export2[q]; 
 	}
 
 	return; 
@@ -114,6 +114,9 @@ class Basic_Agent
 	
 	Basic_Agent(); 
 	virtual ~Basic_Agent(){};
+	// give a recycled agent a new ID and the state of a newly constructed one, 
+	// but keep the storage of its vectors (new in 1.14.3) 
+	void reinitialize( void ); 
 	// simulate secretion and uptake at the nearest voxel at the indicated microenvironment.
 	// if no microenvironment indicated, use the currently selected microenvironment. 
 	void simulate_secretion_and_uptake( Microenvironment* M, double dt ); 
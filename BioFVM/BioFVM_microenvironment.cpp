@@ -50,6 +50,9 @@
 #include "BioFVM_solvers.h"
 #include "BioFVM_vector.h"
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <omp.h>
 
 #include "BioFVM_basic_agent.h"
 
@@ -105,6 +108,233 @@ void empty_diffusion_solver( Microenvironment& S, double dt )
 	return; 
 }
 
+std::string gradient_mode_name( int mode )
+{
+	if( mode == gradient_mode_occupied_voxels )
+	{ return "occupied_voxels"; }
+	if( mode == gradient_mode_on_demand )
+	{ return "on_demand"; }
+	return "all_voxels"; 
+}
+
+int gradient_mode_from_name( std::string name )
+{
+	if( name == "occupied_voxels" )
+	{ return gradient_mode_occupied_voxels; }
+	if( name == "on_demand" )
+	{ return gradient_mode_on_demand; }
+	if( name != "all_voxels" && name != "" )
+	{
+		std::cout << "Warning: unknown gradient mode " << name 
+			<< ". Using all_voxels." << std::endl; 
+	}
+	return gradient_mode_all_voxels; 
+}
+
+// true if two axes with more than one voxel have different spacings 
+bool mesh_spacing_is_anisotropic( Cartesian_Mesh& mesh )
+{
+	std::vector<double> spacings; 
+	if( mesh.x_coordinates.size() > 1 )
+	{ spacings.push_back( mesh.dx ); }
+	if( mesh.y_coordinates.size() > 1 )
+	{ spacings.push_back( mesh.dy ); }
+	if( mesh.z_coordinates.size() > 1 )
+	{ spacings.push_back( mesh.dz ); }
+	
+	for( unsigned int i=1 ; i < spacings.size() ; i++ )
+	{
+		if( fabs( spacings[i] - spacings[0] ) > 1e-12 * spacings[0] )
+		{ return true; }
+	}
+	return false; 
+}
+
+// the constant-coefficient solvers, which would ignore voxel diffusion coefficients 
+static bool solver_ignores_voxel_diffusion_coefficients( void (*solver)(Microenvironment&,double) )
+{
+	return ( solver == diffusion_decay_solver__constant_coefficients_LOD_3D || 
+		solver == diffusion_decay_solver__constant_coefficients_LOD_2D || 
+		solver == diffusion_decay_solver__constant_coefficients_LOD_3D_vectorized || 
+		solver == diffusion_decay_solver__constant_coefficients_LOD_3D_tiled || 
+		solver == diffusion_decay_solver__constant_coefficients_LOD_subcycled || 
+		solver == diffusion_decay_solver__constant_coefficients_LOD_active_region || 
+		solver == diffusion_decay_solver__constant_coefficients_multigrid ); 
+}
+
+Contiguous_Density_Storage::Contiguous_Density_Storage()
+{
+	aligned_data = NULL; 
+	layout = density_storage_voxel_major; 
+	number_of_voxels = 0; 
+	number_of_densities = 0; 
+	voxel_stride = 0; 
+	substrate_stride = 0; 
+	return; 
+}
+
+Contiguous_Density_Storage::Contiguous_Density_Storage( const Contiguous_Density_Storage& copy_me )
+{
+	*this = copy_me; 
+	return; 
+}
+
+Contiguous_Density_Storage& Contiguous_Density_Storage::operator=( const Contiguous_Density_Storage& copy_me )
+{
+	if( this == &copy_me )
+	{ return *this; }
+	
+	layout = copy_me.layout; 
+	number_of_voxels = copy_me.number_of_voxels; 
+	number_of_densities = copy_me.number_of_densities; 
+	voxel_stride = copy_me.voxel_stride; 
+	substrate_stride = copy_me.substrate_stride; 
+	
+	// the copied buffer can land on a different alignment 
+	buffer.assign( copy_me.buffer.size() , 0.0 ); 
+	align(); 
+	if( copy_me.aligned_data != NULL )
+	{
+		size_t size = buffer.size() - 64/sizeof(double); 
+		std::memcpy( aligned_data , copy_me.aligned_data , size*sizeof(double) ); 
+	}
+	return *this; 
+}
+
+void Contiguous_Density_Storage::align( void )
+{
+	aligned_data = NULL; 
+	if( buffer.size() == 0 )
+	{ return; }
+	
+	std::uintptr_t misalignment = ((std::uintptr_t) buffer.data()) % 64; 
+	aligned_data = buffer.data(); 
+	if( misalignment != 0 )
+	{ aligned_data += (64-misalignment)/sizeof(double); }
+	return; 
+}
+
+void Contiguous_Density_Storage::resize( int new_layout , unsigned int voxels , unsigned int densities )
+{
+	layout = new_layout; 
+	number_of_voxels = voxels; 
+	number_of_densities = densities; 
+	
+	size_t size = (size_t) voxels*densities; 
+	if( layout == density_storage_substrate_major )
+	{
+		// pad each substrate so that every substrate block starts on a cache line 
+		size_t padded_voxels = 8*( ((size_t) voxels+7)/8 ); 
+		voxel_stride = 1; 
+		substrate_stride = padded_voxels; 
+		size = padded_voxels*densities; 
+	}
+	else
+	{
+		layout = density_storage_voxel_major; 
+		voxel_stride = densities; 
+		substrate_stride = 1; 
+	}
+	
+	// extra room to shift the start onto a 64-byte boundary 
+	buffer.assign( size + 64/sizeof(double) , 0.0 ); 
+	align(); 
+	return; 
+}
+
+double* Contiguous_Density_Storage::data( void )
+{ return aligned_data; }
+
+double& Contiguous_Density_Storage::operator()( unsigned int voxel_index , unsigned int substrate_index )
+{ return aligned_data[ voxel_index*voxel_stride + substrate_index*substrate_stride ]; }
+
+void Contiguous_Density_Storage::gather( std::vector< std::vector<double> >& source )
+{
+	#pragma omp parallel for 
+	for( unsigned int n=0 ; n < number_of_voxels ; n++ )
+	{
+		double* pD = aligned_data + n*voxel_stride; 
+		const double* pS = source[n].data(); 
+		for( unsigned int q=0 ; q < number_of_densities ; q++ )
+		{ pD[q*substrate_stride] = pS[q]; }
+	}
+	return; 
+}
+
+void Contiguous_Density_Storage::scatter( std::vector< std::vector<double> >& destination )
+{
+	#pragma omp parallel for 
+	for( unsigned int n=0 ; n < number_of_voxels ; n++ )
+	{
+		const double* pS = aligned_data + n*voxel_stride; 
+		double* pD = destination[n].data(); 
+		for( unsigned int q=0 ; q < number_of_densities ; q++ )
+		{ pD[q] = pS[q*substrate_stride]; }
+	}
+	return; 
+}
+
+void Contiguous_Density_Storage::gather( std::vector< std::vector<double> >& source , std::vector<int>& substrate_indices )
+{
+	#pragma omp parallel for 
+	for( unsigned int n=0 ; n < number_of_voxels ; n++ )
+	{
+		double* pD = aligned_data + n*voxel_stride; 
+		const double* pS = source[n].data(); 
+		for( unsigned int s=0 ; s < substrate_indices.size() ; s++ )
+		{
+			int q = substrate_indices[s]; 
+			pD[q*substrate_stride] = pS[q]; 
+		}
+	}
+	return; 
+}
+
+void Contiguous_Density_Storage::scatter( std::vector< std::vector<double> >& destination , std::vector<int>& substrate_indices )
+{
+	#pragma omp parallel for 
+	for( unsigned int n=0 ; n < number_of_voxels ; n++ )
+	{
+		const double* pS = aligned_data + n*voxel_stride; 
+		double* pD = destination[n].data(); 
+		for( unsigned int s=0 ; s < substrate_indices.size() ; s++ )
+		{
+			int q = substrate_indices[s]; 
+			pD[q] = pS[q*substrate_stride]; 
+		}
+	}
+	return; 
+}
+
+Multigrid_Level::Multigrid_Level()
+{
+	nx = 0; 
+	ny = 0; 
+	nz = 0; 
+	dx = 1.0; 
+	dy = 1.0; 
+	dz = 1.0; 
+	return; 
+}
+
+void Multigrid_Level::resize( int x_nodes , int y_nodes , int z_nodes , double x_spacing , double y_spacing , double z_spacing )
+{
+	nx = x_nodes; 
+	ny = y_nodes; 
+	nz = z_nodes; 
+	dx = x_spacing; 
+	dy = y_spacing; 
+	dz = z_spacing; 
+	
+	unsigned int cells = nx*ny*nz; 
+	solution.assign( cells , 0.0 ); 
+	right_hand_side.assign( cells , 0.0 ); 
+	residual.assign( cells , 0.0 ); 
+	diagonal.assign( cells , 0.0 ); 
+	fixed.assign( cells , 0 ); 
+	return; 
+}
+
 Microenvironment::Microenvironment()
 {	
 	name = "unnamed"; 
@@ -112,8 +342,27 @@ Microenvironment::Microenvironment()
 	time_units = "none";
 	
 	bulk_source_sink_solver_setup_done = false; 
+	bulk_source_sink_cache_enabled = false; 
+	bulk_source_sink_cache_is_current = false; 
+	bulk_source_sink_cache_dt = 0.0; 
 	thomas_setup_done = false; 
 	diffusion_solver_setup_done = false; 
+	diffusion_step_counter = 0; 
+	quasi_static_max_factor = 16; 
+	multigrid_tolerance = 1e-8; 
+	multigrid_max_cycles = 50; 
+	variable_thomas_setup_done = false; 
+	variable_thomas_dt = 0.0; 
+	active_region_tile_size = 8; 
+	active_region_tolerance = 1e-6; 
+	active_region_refresh_interval = 100; 
+	active_region_step_counter = 0; 
+	
+#ifdef BioFVM_MPI 
+	decomposition = NULL; 
+#endif 
+	gradient_epoch = 1; 
+	gradient_mode = gradient_mode_all_voxels; 
 
 	diffusion_decay_solver = empty_diffusion_solver;
 	diffusion_decay_solver = diffusion_decay_solver__constant_coefficients_LOD_3D; 
@@ -133,7 +382,7 @@ Microenvironment::Microenvironment()
 		gradient_vectors[k].resize( 1 ); 
 		(gradient_vectors[k])[0].resize( 3, 0.0 );
 	}
-	gradient_vector_computed.resize( mesh.voxels.size() , false ); 
+	gradient_vector_epochs.resize( mesh.voxels.size() , 0 ); 
 
 	bulk_supply_rate_function = zero_function; 
 	bulk_supply_target_densities_function = zero_function; 
@@ -155,6 +404,7 @@ Microenvironment::Microenvironment()
 	dirichlet_activation_vector.assign( 1 , false );
 	
 	dirichlet_activation_vectors.assign( 1 , dirichlet_activation_vector ); 
+	dirichlet_indices_are_current = false; 
 	
 	default_microenvironment_options.Dirichlet_all.assign( 1 , true ); 
 	default_microenvironment_options.Dirichlet_xmin.assign( 1 , false ); 
@@ -188,12 +438,8 @@ Microenvironment::Microenvironment(std::string name)
 void Microenvironment::add_dirichlet_node( int voxel_index, std::vector<double>& value )
 {
 	mesh.voxels[voxel_index].is_Dirichlet=true;
-	/*
-	dirichlet_indices.push_back( voxel_index );
-	dirichlet_value_vectors.push_back( value ); 
-	*/
-	
 	dirichlet_value_vectors[voxel_index] = value; // .assign( mesh.voxels.size(), one ); 
+	dirichlet_indices_are_current = false; 
 	
 	return; 
 }
@@ -202,6 +448,7 @@ void Microenvironment::update_dirichlet_node( int voxel_index , std::vector<doub
 {
 	mesh.voxels[voxel_index].is_Dirichlet = true; 
 	dirichlet_value_vectors[voxel_index] = new_value; 
+	dirichlet_indices_are_current = false; 
 	
 	return; 
 }
@@ -212,6 +459,7 @@ void Microenvironment::update_dirichlet_node( int voxel_index , int substrate_in
 	dirichlet_value_vectors[voxel_index][substrate_index] = new_value; 
 	
 	dirichlet_activation_vectors[voxel_index][substrate_index] = true; 
+	dirichlet_indices_are_current = false; 
 
 	return; 
 }
@@ -219,12 +467,15 @@ void Microenvironment::update_dirichlet_node( int voxel_index , int substrate_in
 void Microenvironment::remove_dirichlet_node( int voxel_index )
 {
 	mesh.voxels[voxel_index].is_Dirichlet = false; 
+	dirichlet_indices_are_current = false; 
 	
 	return; 
 }
 
 bool& Microenvironment::is_dirichlet_node( int voxel_index )
 {
+	// the caller may write through the reference 
+	dirichlet_indices_are_current = false; 
 	return mesh.voxels[voxel_index].is_Dirichlet; 
 }
 
@@ -234,6 +485,7 @@ void Microenvironment::set_substrate_dirichlet_activation( int substrate_index ,
 	
 	for( int n = 0 ; n < mesh.voxels.size() ; n++ )
 	{ dirichlet_activation_vectors[n][substrate_index] = new_value; }
+	dirichlet_indices_are_current = false; 
 	
 	return; 
 }
@@ -241,6 +493,7 @@ void Microenvironment::set_substrate_dirichlet_activation( int substrate_index ,
 void Microenvironment::set_substrate_dirichlet_activation( int index, std::vector<bool>& new_value )
 {
 	dirichlet_activation_vectors[index] = new_value; 
+	dirichlet_indices_are_current = false; 
 	return; 
 }
 
@@ -261,6 +514,7 @@ double Microenvironment::get_substrate_dirichlet_value( int substrate_index, int
 void Microenvironment::set_substrate_dirichlet_activation( int substrate_index , int index, bool new_value )
 {
 	dirichlet_activation_vectors[index][substrate_index] = new_value; 
+	dirichlet_indices_are_current = false; 
 	return; 
 }
 
@@ -268,32 +522,89 @@ bool Microenvironment::get_substrate_dirichlet_activation( int substrate_index,
 { return dirichlet_activation_vectors[index][substrate_index]; }
 
 
-void Microenvironment::apply_dirichlet_conditions( void )
+void Microenvironment::update_dirichlet_indices( void )
 {
-	/*
-	#pragma omp parallel for 
-	for( unsigned int i=0 ; i < dirichlet_indices.size() ; i++ )
-	{ density_vector( dirichlet_indices[i] ) = dirichlet_value_vectors[i]; }
-	*/
-
-	// #pragma omp parallel for 
+	dirichlet_indices.clear(); 
 	for( unsigned int i=0 ; i < mesh.voxels.size() ;i++ )
 	{
-		/*
-		if( mesh.voxels[i].is_Dirichlet == true )
-		{ density_vector(i) = dirichlet_value_vectors[i]; }
-		*/
 		if( mesh.voxels[i].is_Dirichlet == true )
+		{ dirichlet_indices.push_back( i ); }
+	}
+	
+	// runs of consecutive voxels with the same values and activations. 
+	// A z-face on a Cartesian mesh is one run; a y-face is one run per z-slice. 
+	dirichlet_run_starts.clear(); 
+	dirichlet_run_lengths.clear(); 
+	for( unsigned int n=0 ; n < dirichlet_indices.size() ; n++ )
+	{
+		int i = dirichlet_indices[n]; 
+		if( dirichlet_run_starts.size() > 0 )
+		{
+			int first = dirichlet_run_starts.back(); 
+			int& length = dirichlet_run_lengths.back(); 
+			if( i == first + length && 
+				dirichlet_value_vectors[i] == dirichlet_value_vectors[first] && 
+				dirichlet_activation_vectors[i] == dirichlet_activation_vectors[first] )
+			{ length++; continue; }
+		}
+		dirichlet_run_starts.push_back( i ); 
+		dirichlet_run_lengths.push_back( 1 ); 
+	}
+	
+	dirichlet_indices_are_current = true; 
+	return; 
+}
+
+void Microenvironment::apply_dirichlet_conditions( void )
+{
+	if( dirichlet_indices_are_current == false )
+	{ update_dirichlet_indices(); }
+	
+	#pragma omp parallel for 
+	for( unsigned int r=0 ; r < dirichlet_run_starts.size() ; r++ )
+	{
+		int first = dirichlet_run_starts[r]; 
+		int last = first + dirichlet_run_lengths[r]; 
+		std::vector<double>& values = dirichlet_value_vectors[first]; 
+		std::vector<bool>& active = dirichlet_activation_vectors[first]; 
+		
+		for( int i=first ; i < last ; i++ )
 		{
-			for( unsigned int j=0; j < dirichlet_value_vectors[i].size(); j++ )
+			std::vector<double>& density = (*p_density_vectors)[i]; 
+			for( unsigned int j=0; j < values.size(); j++ )
 			{
-				// if( dirichlet_activation_vector[j] == true )
-				if( dirichlet_activation_vectors[i][j] == true )
-				{
-					density_vector(i)[j] = dirichlet_value_vectors[i][j]; 
-				}
+				if( active[j] == true )
+				{ density[j] = values[j]; }
 			}
+		}
+	}
+	return; 
+}
+
+void Microenvironment::apply_dirichlet_conditions( Contiguous_Density_Storage& densities )
+{
+	if( dirichlet_indices_are_current == false )
+	{ update_dirichlet_indices(); }
 	
+	// plane writes: contiguous for the substrate-major layout 
+	#pragma omp parallel for 
+	for( unsigned int r=0 ; r < dirichlet_run_starts.size() ; r++ )
+	{
+		int first = dirichlet_run_starts[r]; 
+		int length = dirichlet_run_lengths[r]; 
+		std::vector<double>& values = dirichlet_value_vectors[first]; 
+		std::vector<bool>& active = dirichlet_activation_vectors[first]; 
+		
+		for( unsigned int j=0; j < values.size(); j++ )
+		{
+			if( active[j] == false )
+			{ continue; }
+			
+			double* pOut = &( densities(first,j) ); 
+			size_t stride = densities.voxel_stride; 
+			double value = values[j]; 
+			for( int n=0 ; n < length ; n++ )
+			{ pOut[n*stride] = value; }
 		}
 	}
 	return; 
@@ -322,11 +633,13 @@ void Microenvironment::resize_voxels( int new_number_of_voxes )
 			(gradient_vectors[k])[i].resize( 3, 0.0 );
 		}
 	}
-	gradient_vector_computed.resize( mesh.voxels.size() , false ); 	
+	gradient_vector_epochs.resize( mesh.voxels.size() , 0 ); 	
 	
 	dirichlet_value_vectors.assign( mesh.voxels.size(), one ); 
 
 	dirichlet_activation_vectors.assign( mesh.voxels.size() , dirichlet_activation_vector ); 
+	dirichlet_indices_are_current = false; 
+	bulk_source_sink_cache_is_current = false; 
 	
 	return; 
 }
@@ -348,11 +661,13 @@ void Microenvironment::resize_space( int x_nodes, int y_nodes, int z_nodes )
 			(gradient_vectors[k])[i].resize( 3, 0.0 );
 		}
 	}
-	gradient_vector_computed.resize( mesh.voxels.size() , false ); 	
+	gradient_vector_epochs.resize( mesh.voxels.size() , 0 ); 	
 	
 	dirichlet_value_vectors.assign( mesh.voxels.size(), one ); 
 	
 	dirichlet_activation_vectors.assign( mesh.voxels.size() , dirichlet_activation_vector ); 
+	dirichlet_indices_are_current = false; 
+	bulk_source_sink_cache_is_current = false; 
 	
 	return;  
 }
@@ -373,11 +688,13 @@ void Microenvironment::resize_space( double x_start, double x_end, double y_star
 			(gradient_vectors[k])[i].resize( 3, 0.0 );
 		}
 	}
-	gradient_vector_computed.resize( mesh.voxels.size() , false ); 	
+	gradient_vector_epochs.resize( mesh.voxels.size() , 0 ); 	
 
 	dirichlet_value_vectors.assign( mesh.voxels.size(), one ); 
 	
 	dirichlet_activation_vectors.assign( mesh.voxels.size() , dirichlet_activation_vector ); 	
+	dirichlet_indices_are_current = false; 
+	bulk_source_sink_cache_is_current = false; 
 	
 	return;  
 }
@@ -398,11 +715,13 @@ void Microenvironment::resize_space( double x_start, double x_end, double y_star
 			(gradient_vectors[k])[i].resize( 3, 0.0 );
 		}
 	}
-	gradient_vector_computed.resize( mesh.voxels.size() , false ); 	
+	gradient_vector_epochs.resize( mesh.voxels.size() , 0 ); 	
 	
 	dirichlet_value_vectors.assign( mesh.voxels.size(), one ); 
 
 	dirichlet_activation_vectors.assign( mesh.voxels.size() , dirichlet_activation_vector ); 
+	dirichlet_indices_are_current = false; 
+	bulk_source_sink_cache_is_current = false; 
 	
 	return;  
 }
@@ -428,7 +747,7 @@ void Microenvironment::resize_densities( int new_size )
 			(gradient_vectors[k])[i].resize( 3, 0.0 );
 		}
 	}
-	gradient_vector_computed.resize( mesh.voxels.size() , false ); 	
+	gradient_vector_epochs.resize( mesh.voxels.size() , 0 ); 	
 	
 	diffusion_coefficients.assign( new_size , 0.0 ); 
 	decay_rates.assign( new_size , 0.0 ); 
@@ -446,6 +765,8 @@ void Microenvironment::resize_densities( int new_size )
 	dirichlet_activation_vector.assign( new_size, false );
 
 	dirichlet_activation_vectors.assign( mesh.voxels.size(), dirichlet_activation_vector ); 
+	dirichlet_indices_are_current = false; 
+	bulk_source_sink_cache_is_current = false; 
 
 	default_microenvironment_options.Dirichlet_condition_vector.assign( new_size , 1.0 );  
 	default_microenvironment_options.Dirichlet_activation_vector.assign( new_size, false );
@@ -522,7 +843,7 @@ void Microenvironment::add_density( std::string name , std::string units, double
 			(gradient_vectors[k])[i].resize( 3, 0.0 );
 		}
 	}
-	gradient_vector_computed.resize( mesh.voxels.size() , false ); 	
+	gradient_vector_epochs.resize( mesh.voxels.size() , 0 ); 	
 
 	one_half = one; 
 	one_half *= 0.5; 
@@ -533,6 +854,8 @@ void Microenvironment::add_density( std::string name , std::string units, double
 	dirichlet_value_vectors.assign( mesh.voxels.size(), one ); 
 	dirichlet_activation_vector.push_back( false ); 
 	dirichlet_activation_vectors.assign( mesh.voxels.size(), dirichlet_activation_vector ); 
+	dirichlet_indices_are_current = false; 
+	bulk_source_sink_cache_is_current = false; 
 	
 	// fix in PhysiCell preview November 2017 
 	default_microenvironment_options.Dirichlet_condition_vector.push_back( 1.0 ); // = one; 
@@ -651,17 +974,244 @@ void Microenvironment::simulate_diffusion_decay( double dt )
 
 void Microenvironment::auto_choose_diffusion_decay_solver( void )
 {
-	// set the safest choice 
-	diffusion_decay_solver = diffusion_decay_solver__constant_coefficients_explicit; 
+	// non-Cartesian meshes: the explicit method is the only safe choice 
+	if( mesh.regular_mesh == false || mesh.Cartesian_mesh == false )
+	{
+		diffusion_decay_solver = diffusion_decay_solver__constant_coefficients_explicit; 
+		std::cout << "Warning: non-Cartesian mesh. Using the (fail-safe) explicit diffusion-decay solver." << std::endl;
+		return; 
+	}
+	
+	// 2-D Cartesian meshes 
+	if( mesh.z_coordinates.size() == 1 )
+	{
+		diffusion_decay_solver = diffusion_decay_solver__constant_coefficients_LOD_2D; 
+		return; 
+	}
+	
+	// different spacings along the axes (or a voxel diffusion field) 
+	if( mesh_spacing_is_anisotropic( mesh ) || uses_variable_diffusion_coefficients() )
+	{
+		diffusion_decay_solver = diffusion_decay_solver__variable_coefficients_LOD_3D; 
+		return; 
+	}
+	
+	// 3-D Cartesian meshes: solve batches of lines across SIMD lanes 
+	diffusion_decay_solver = diffusion_decay_solver__constant_coefficients_LOD_3D_vectorized; 
+
+ // eventual logic: if variable coefficients, use the variable coefficient code 
+	return; 
+}
+
+void Microenvironment::size_contiguous_densities( int layout )
+{
+	if( contiguous_densities.layout != layout || 
+		contiguous_densities.number_of_voxels != number_of_voxels() || 
+		contiguous_densities.number_of_densities != number_of_densities() || 
+		contiguous_densities.data() == NULL )
+	{ contiguous_densities.resize( layout , number_of_voxels() , number_of_densities() ); }
+	return; 
+}
 
-	std::cout << "Warning: auto-selection of diffusion-decay-source/sink solver not fully implemented!" << std::endl;
+Contiguous_Density_Storage& Microenvironment::gather_contiguous_densities( int layout )
+{
+	size_contiguous_densities( layout ); 
+	contiguous_densities.gather( *p_density_vectors ); 
+	return contiguous_densities; 
+}
 
- // eventual logic: if non-Cartesian, use explicit
- // if Cartesian, if non-variable, use the constant coefficient super-fast code
- // otherwise, use the variable coefficient code 
+void Microenvironment::scatter_contiguous_densities( void )
+{
+	contiguous_densities.scatter( *p_density_vectors ); 
+	return; 
+}
 
+Contiguous_Density_Storage& Microenvironment::gather_contiguous_densities( std::vector<int>& substrate_indices )
+{
+	size_contiguous_densities( density_storage_voxel_major ); 
+	contiguous_densities.gather( *p_density_vectors , substrate_indices ); 
+	return contiguous_densities; 
 }
- 
+
+void Microenvironment::scatter_contiguous_densities( std::vector<int>& substrate_indices )
+{
+	contiguous_densities.scatter( *p_density_vectors , substrate_indices ); 
+	return; 
+}
+
+void Microenvironment::set_diffusion_step_multiplier( int substrate_index , int multiplier )
+{
+	if( substrate_index < 0 || substrate_index >= (int) number_of_densities() )
+	{
+		std::cout << "Warning: cannot set the diffusion step multiplier of substrate " << substrate_index 
+			<< " (" << number_of_densities() << " substrates)." << std::endl; 
+		return; 
+	}
+	if( multiplier < 1 )
+	{
+		std::cout << "Warning: diffusion step multiplier " << multiplier << " for " 
+			<< density_names[substrate_index] << " is less than 1. Using 1." << std::endl; 
+		multiplier = 1; 
+	}
+	
+	if( diffusion_step_multipliers.size() < number_of_densities() )
+	{ diffusion_step_multipliers.resize( number_of_densities() , 1 ); }
+	diffusion_step_multipliers[substrate_index] = multiplier; 
+	
+	// the coefficients depend on the multipliers 
+	diffusion_solver_setup_done = false; 
+	return; 
+}
+
+int Microenvironment::get_diffusion_step_multiplier( int substrate_index )
+{
+	if( substrate_index < (int) diffusion_step_multipliers.size() )
+	{ return diffusion_step_multipliers[substrate_index]; }
+	return 1; 
+}
+
+bool Microenvironment::uses_diffusion_subcycling( void )
+{
+	for( unsigned int q=0 ; q < number_of_densities() ; q++ )
+	{
+		if( get_diffusion_step_multiplier( q ) > 1 || get_quasi_static_tolerance( q ) > 0.0 )
+		{ return true; }
+	}
+	return false; 
+}
+
+void Microenvironment::set_quasi_static_tolerance( int substrate_index , double tolerance )
+{
+	if( substrate_index < 0 || substrate_index >= (int) number_of_densities() )
+	{
+		std::cout << "Warning: cannot set the quasi-static tolerance of substrate " << substrate_index 
+			<< " (" << number_of_densities() << " substrates)." << std::endl; 
+		return; 
+	}
+	if( tolerance < 0.0 )
+	{
+		std::cout << "Warning: negative quasi-static tolerance for " << density_names[substrate_index] 
+			<< ". Using 0 (off)." << std::endl; 
+		tolerance = 0.0; 
+	}
+	
+	if( quasi_static_tolerances.size() < number_of_densities() )
+	{ quasi_static_tolerances.resize( number_of_densities() , 0.0 ); }
+	quasi_static_tolerances[substrate_index] = tolerance; 
+	return; 
+}
+
+double Microenvironment::get_quasi_static_tolerance( int substrate_index )
+{
+	if( substrate_index < (int) quasi_static_tolerances.size() )
+	{ return quasi_static_tolerances[substrate_index]; }
+	return 0.0; 
+}
+
+void Microenvironment::set_quasi_static_max_factor( int factor )
+{
+	if( factor < 1 )
+	{
+		std::cout << "Warning: quasi-static maximum factor " << factor << " is less than 1. Using 1." << std::endl; 
+		factor = 1; 
+	}
+	quasi_static_max_factor = factor; 
+	return; 
+}
+
+void Microenvironment::set_multigrid_tolerance( double tolerance , int max_cycles )
+{
+	if( tolerance <= 0.0 || max_cycles < 1 )
+	{
+		std::cout << "Warning: invalid multigrid tolerance " << tolerance << " or cycle limit " << max_cycles 
+			<< ". Keeping " << multigrid_tolerance << " and " << multigrid_max_cycles << "." << std::endl; 
+		return; 
+	}
+	multigrid_tolerance = tolerance; 
+	multigrid_max_cycles = max_cycles; 
+	return; 
+}
+
+void Microenvironment::set_diffusion_coefficient( int voxel_index , int substrate_index , double value )
+{
+	if( voxel_index < 0 || voxel_index >= (int) number_of_voxels() || 
+		substrate_index < 0 || substrate_index >= (int) number_of_densities() || value < 0.0 )
+	{
+		std::cout << "Warning: cannot set diffusion coefficient " << value << " of substrate " << substrate_index 
+			<< " in voxel " << voxel_index << ". Ignoring." << std::endl; 
+		return; 
+	}
+	
+	if( voxel_diffusion_coefficients.size() != number_of_voxels() || 
+		voxel_diffusion_coefficients[0].size() != number_of_densities() )
+	{
+		voxel_diffusion_coefficients.assign( number_of_voxels() , diffusion_coefficients ); 
+		
+		// the constant-coefficient solvers would ignore the field 
+		if( solver_ignores_voxel_diffusion_coefficients( diffusion_decay_solver ) )
+		{
+			std::cout << "Voxel diffusion coefficients set: switching to diffusion_decay_solver__variable_coefficients_LOD_3D." << std::endl; 
+			diffusion_decay_solver = diffusion_decay_solver__variable_coefficients_LOD_3D; 
+		}
+	}
+	
+	voxel_diffusion_coefficients[voxel_index][substrate_index] = value; 
+	variable_thomas_setup_done = false; 
+	return; 
+}
+
+double Microenvironment::get_diffusion_coefficient( int voxel_index , int substrate_index )
+{
+	if( voxel_diffusion_coefficients.size() == number_of_voxels() && 
+		voxel_diffusion_coefficients[voxel_index].size() == number_of_densities() )
+	{ return voxel_diffusion_coefficients[voxel_index][substrate_index]; }
+	return diffusion_coefficients[substrate_index]; 
+}
+
+bool Microenvironment::uses_variable_diffusion_coefficients( void )
+{
+	return ( voxel_diffusion_coefficients.size() > 0 && 
+		voxel_diffusion_coefficients.size() == number_of_voxels() && 
+		voxel_diffusion_coefficients[0].size() == number_of_densities() ); 
+}
+
+void Microenvironment::set_active_region_parameters( int tile_size , double tolerance , int refresh_interval )
+{
+	if( tile_size < 1 || tolerance < 0.0 || refresh_interval < 0 )
+	{
+		std::cout << "Warning: invalid active region tile size " << tile_size << ", tolerance " << tolerance 
+			<< ", or refresh interval " << refresh_interval << ". Keeping " << active_region_tile_size << ", " 
+			<< active_region_tolerance << ", and " << active_region_refresh_interval << "." << std::endl; 
+		return; 
+	}
+	active_region_tile_size = tile_size; 
+	active_region_tolerance = tolerance; 
+	active_region_refresh_interval = refresh_interval; 
+	
+	// start over with every tile active 
+	active_region_tiles.clear(); 
+	active_region_changed.clear(); 
+	return; 
+}
+
+double Microenvironment::active_region_fraction( void )
+{
+	if( active_region_tiles.size() == 0 )
+	{ return 1.0; }
+	
+	int active = 0; 
+	for( unsigned int t=0 ; t < active_region_tiles.size() ; t++ )
+	{ active += active_region_tiles[t]; }
+	return (double) active / (double) active_region_tiles.size(); 
+}
+
+int Microenvironment::get_quasi_static_factor( int substrate_index )
+{
+	if( substrate_index < (int) quasi_static_factors.size() )
+	{ return quasi_static_factors[substrate_index]; }
+	return 1; 
+}
+
 void Microenvironment::display_information( std::ostream& os )
 {
 	os << std::endl << "Microenvironment summary: " << name << ": " << std::endl; 
@@ -728,8 +1278,69 @@ void Microenvironment::write_to_matlab( std::string filename )
 
 
 
+void Microenvironment::enable_bulk_source_sink_cache( bool enable )
+{
+	bulk_source_sink_cache_enabled = enable; 
+	bulk_source_sink_cache_is_current = false; 
+	return; 
+}
+
+void Microenvironment::invalidate_bulk_source_sink_cache( void )
+{
+	bulk_source_sink_cache_is_current = false; 
+	return; 
+}
+
+void Microenvironment::build_bulk_source_sink_cache( double dt )
+{
+	if( supply_rates.size() != number_of_voxels() || uptake_rates.size() != number_of_voxels() || 
+		supply_target_densities_times_supply_rates.size() != number_of_voxels() )
+	{ update_rates(); }
+	
+	bulk_source_sink_solver_temp2.resize( mesh.voxels.size() , zero );
+	bulk_source_sink_solver_temp3.resize( mesh.voxels.size() , zero );
+	
+	#pragma omp parallel for
+	for( unsigned int i=0; i < mesh.voxels.size() ; i++ )
+	{
+		int number_of_densities = supply_rates[i].size(); 
+		bulk_source_sink_solver_temp2[i].resize( number_of_densities ); 
+		bulk_source_sink_solver_temp3[i].resize( number_of_densities ); 
+		for( int q=0 ; q < number_of_densities ; q++ )
+		{
+			// 1/(1 + dt*(U+S)) and dt*S*T/(1 + dt*(U+S)) 
+			double inverse_denominator = 1.0 / ( 1.0 + dt*( uptake_rates[i][q] + supply_rates[i][q] ) ); 
+			bulk_source_sink_solver_temp3[i][q] = inverse_denominator; 
+			bulk_source_sink_solver_temp2[i][q] = dt * supply_target_densities_times_supply_rates[i][q] * inverse_denominator; 
+		}
+	}
+	
+	bulk_source_sink_cache_dt = dt; 
+	bulk_source_sink_cache_is_current = true; 
+	return; 
+}
+
 void Microenvironment::simulate_bulk_sources_and_sinks( double dt )
 {
+	if( bulk_source_sink_cache_enabled )
+	{
+		if( !bulk_source_sink_cache_is_current || dt != bulk_source_sink_cache_dt )
+		{ build_bulk_source_sink_cache( dt ); }
+		
+		// out = (out + dt*S*T)/(1 + dt*(U+S)) 
+		#pragma omp parallel for
+		for( unsigned int i=0; i < mesh.voxels.size() ; i++ )
+		{
+			double* pDensity = (*p_density_vectors)[i].data(); 
+			const double* pFactor = bulk_source_sink_solver_temp3[i].data(); 
+			const double* pSource = bulk_source_sink_solver_temp2[i].data(); 
+			int number_of_densities = (*p_density_vectors)[i].size(); 
+			for( int q=0 ; q < number_of_densities ; q++ )
+			{ pDensity[q] = pDensity[q] * pFactor[q] + pSource[q]; }
+		}
+		return; 
+	}
+	
 	if( !bulk_source_sink_solver_setup_done )
 	{
 		bulk_source_sink_solver_temp1.resize( mesh.voxels.size() , zero );
@@ -761,10 +1372,113 @@ void Microenvironment::simulate_bulk_sources_and_sinks( double dt )
 
 void Microenvironment::simulate_cell_sources_and_sinks( std::vector<Basic_Agent*>& basic_agent_list , double dt )
 {
-	#pragma omp parallel for
-	for( unsigned int i=0 ; i < basic_agent_list.size() ; i++ )
-	{		
-		basic_agent_list[i]->simulate_secretion_and_uptake( this , dt ); 
+	// Agents in the same voxel update the same density vector, so they can't 
+	// run concurrently. Bin the active agents by voxel, then give each thread 
+	// whole voxels. Every pass is parallel: the counts and write cursors are 
+	// atomic, and each voxel's run is put back in list order before its 
+	// agents run. Every voxel sees its agents' updates in list order 
+	// regardless of the number of threads, so the result matches a serial 
+	// sweep bitwise. 
+	
+	if( agent_counts_by_voxel.size() != number_of_voxels() )
+	{ agent_counts_by_voxel.assign( number_of_voxels() , 0 ); }
+	int number_of_agents = basic_agent_list.size(); 
+	
+	// count the agents of each voxel; the first one to arrive lists the voxel 
+	occupied_voxels.clear(); 
+	#pragma omp parallel 
+	{
+		std::vector<int> local_occupied_voxels; 
+		#pragma omp for nowait 
+		for( int i=0 ; i < number_of_agents ; i++ )
+		{
+			Basic_Agent* pAgent = basic_agent_list[i]; 
+			int n = pAgent->get_current_voxel_index(); 
+			if( pAgent->is_active == false || n < 0 )
+			{ continue; }
+			
+			int count; 
+			#pragma omp atomic capture 
+			count = agent_counts_by_voxel[n]++; 
+			if( count == 0 )
+			{ local_occupied_voxels.push_back( n ); }
+		}
+		#pragma omp critical(BioFVM_occupied_voxels) 
+		{ occupied_voxels.insert( occupied_voxels.end() , local_occupied_voxels.begin() , local_occupied_voxels.end() ); }
+	}
+	int number_of_occupied_voxels = occupied_voxels.size(); 
+	
+	// counts become write cursors: a prefix sum over the occupied voxels, 
+	// one block of them per thread 
+	occupied_voxel_offsets.resize( number_of_occupied_voxels + 1 ); 
+	std::vector<int> block_offsets( omp_get_max_threads() + 1 , 0 ); 
+	#pragma omp parallel 
+	{
+		int threads = omp_get_num_threads(); 
+		int t = omp_get_thread_num(); 
+		int first = ( (long long) number_of_occupied_voxels * t ) / threads; 
+		int last = ( (long long) number_of_occupied_voxels * (t+1) ) / threads; 
+		
+		int sum = 0; 
+		for( int j=first ; j < last ; j++ )
+		{ sum += agent_counts_by_voxel[ occupied_voxels[j] ]; }
+		block_offsets[t+1] = sum; 
+		
+		#pragma omp barrier 
+		#pragma omp single 
+		{
+			for( int b=0 ; b < threads ; b++ )
+			{ block_offsets[b+1] += block_offsets[b]; }
+		}
+		
+		int offset = block_offsets[t]; 
+		for( int j=first ; j < last ; j++ )
+		{
+			int count = agent_counts_by_voxel[ occupied_voxels[j] ]; 
+			agent_counts_by_voxel[ occupied_voxels[j] ] = offset; 
+			occupied_voxel_offsets[j] = offset; 
+			offset += count; 
+		}
+		if( t == threads-1 )
+		{ occupied_voxel_offsets[ number_of_occupied_voxels ] = offset; }
+	}
+	
+	int number_of_binned_agents = occupied_voxel_offsets[ number_of_occupied_voxels ]; 
+	agent_indices_by_voxel.resize( number_of_binned_agents ); 
+	agents_sorted_by_voxel.resize( number_of_binned_agents ); 
+	#pragma omp parallel for 
+	for( int i=0 ; i < number_of_agents ; i++ )
+	{
+		Basic_Agent* pAgent = basic_agent_list[i]; 
+		int n = pAgent->get_current_voxel_index(); 
+		if( pAgent->is_active == false || n < 0 )
+		{ continue; }
+		
+		int k; 
+		#pragma omp atomic capture 
+		k = agent_counts_by_voxel[n]++; 
+		agent_indices_by_voxel[k] = i; 
+	}
+	
+	// put each voxel's run back in list order (runs are short), and leave 
+	// the counts zeroed for the next call 
+	#pragma omp parallel for 
+	for( int j=0 ; j < number_of_occupied_voxels ; j++ )
+	{
+		std::sort( agent_indices_by_voxel.begin() + occupied_voxel_offsets[j] , 
+			agent_indices_by_voxel.begin() + occupied_voxel_offsets[j+1] ); 
+		agent_counts_by_voxel[ occupied_voxels[j] ] = 0; 
+	}
+	
+	#pragma omp parallel for 
+	for( int k=0 ; k < number_of_binned_agents ; k++ )
+	{ agents_sorted_by_voxel[k] = basic_agent_list[ agent_indices_by_voxel[k] ]; }
+	
+	#pragma omp parallel for 
+	for( int j=0 ; j < number_of_occupied_voxels ; j++ )
+	{
+		for( int k=occupied_voxel_offsets[j] ; k < occupied_voxel_offsets[j+1] ; k++ )
+		{ agents_sorted_by_voxel[k]->simulate_secretion_and_uptake( this , dt ); }
 	}
 	
 	return; 
@@ -801,270 +1515,226 @@ void Microenvironment::update_rates( void )
 std::vector<gradient>& Microenvironment::gradient_vector(int i, int j, int k)
 {
 	int n = voxel_index(i,j,k);
-	if( gradient_vector_computed[n] == false )
-	{
-		compute_gradient_vector( n );
-	}
-	
+	make_gradient_vector_current( n ); 
 	return gradient_vectors[n];
 }
 
 std::vector<gradient>& Microenvironment::gradient_vector(int i, int j )
 {
 	int n = voxel_index(i,j,0);
-	if( gradient_vector_computed[n] == false )
-	{
-		compute_gradient_vector( n );
-	}
-	
+	make_gradient_vector_current( n ); 
 	return gradient_vectors[n];
 }
 
 std::vector<gradient>& Microenvironment::gradient_vector(int n )
 {
 	// if the gradient has not yet been computed, then do it!
-	if( gradient_vector_computed[n] == false )
-	{
-		compute_gradient_vector( n );
-	}
-	
-	
+	make_gradient_vector_current( n ); 
 	return gradient_vectors[n];
 }
 	
 std::vector<gradient>& Microenvironment::nearest_gradient_vector( std::vector<double>& position )
 {
 	int n = nearest_voxel_index( position );
-	if( gradient_vector_computed[n] == false )
+	make_gradient_vector_current( n ); 
+	return gradient_vectors[n];
+}
+
+void Microenvironment::compute_gradient_vector( int n , unsigned int i , unsigned int j , unsigned int k )
+{
+	// central differences inside, one-sided differences on the outer faces 
+	unsigned int nx = mesh.x_coordinates.size(); 
+	unsigned int ny = mesh.y_coordinates.size(); 
+	unsigned int nz = mesh.z_coordinates.size(); 
+	double two_dx = 2.0 * mesh.dx; 
+	double two_dy = 2.0 * mesh.dy; 
+	double two_dz = 2.0 * mesh.dz; 
+	// same as thomas_*_jump, which are only set once a diffusion solver has run 
+	int i_jump = 1; 
+	int j_jump = nx; 
+	int k_jump = nx*ny; 
+	
+	std::vector<gradient>& gradients = gradient_vectors[n]; 
+	std::vector< std::vector<double> >& rho = *p_density_vectors; 
+	
+	for( unsigned int q=0; q < number_of_densities() ; q++ )
 	{
-		compute_gradient_vector( n );
+		// d/dx 
+		if( i == 0 )
+		{ gradients[q][0] = ( rho[n+i_jump][q] - rho[n][q] ) / mesh.dx; }
+		else if( i == nx-1 )
+		{ gradients[q][0] = ( rho[n][q] - rho[n-i_jump][q] ) / mesh.dx; }
+		else
+		{ gradients[q][0] = ( rho[n+i_jump][q] - rho[n-i_jump][q] ) / two_dx; }
+		
+		// don't bother computing y and z components if there is no y-direction (1D)
+		if( ny == 1 )
+		{ continue; }
+		
+		// d/dy 
+		if( j == 0 )
+		{ gradients[q][1] = ( rho[n+j_jump][q] - rho[n][q] ) / mesh.dy; }
+		else if( j == ny-1 )
+		{ gradients[q][1] = ( rho[n][q] - rho[n-j_jump][q] ) / mesh.dy; }
+		else
+		{ gradients[q][1] = ( rho[n+j_jump][q] - rho[n-j_jump][q] ) / two_dy; }
+		
+		// don't bother computing the z component if there is no z-direction (2D) 
+		if( nz == 1 )
+		{ continue; }
+		
+		// d/dz 
+		if( k == 0 )
+		{ gradients[q][2] = ( rho[n+k_jump][q] - rho[n][q] ) / mesh.dz; }
+		else if( k == nz-1 )
+		{ gradients[q][2] = ( rho[n][q] - rho[n-k_jump][q] ) / mesh.dz; }
+		else
+		{ gradients[q][2] = ( rho[n+k_jump][q] - rho[n-k_jump][q] ) / two_dz; }
 	}
 	
-	return gradient_vectors[n];
+	#pragma omp atomic write seq_cst 
+	gradient_vector_epochs[n] = gradient_epoch; 
+	
+	return; 
 }
 
-void Microenvironment::compute_all_gradient_vectors( void )
+void Microenvironment::compute_gradient_vector( int n )
+{
+	std::vector<unsigned int> indices = cartesian_indices( n );
+	compute_gradient_vector( n , indices[0] , indices[1] , indices[2] ); 
+	return; 
+}
+
+// marks a voxel whose gradient is being computed by another thread (new in 1.14.3) 
+static const unsigned int gradient_epoch_in_progress = 0xFFFFFFFF; 
+
+void Microenvironment::make_gradient_vector_current( int n )
 {
-	static double two_dx = mesh.dx; 
-	static double two_dy = mesh.dy; 
-	static double two_dz = mesh.dz; 
-	static bool gradient_constants_defined = false; 
-	if( gradient_constants_defined == false )
+	unsigned int epoch; 
+	#pragma omp atomic read seq_cst 
+	epoch = gradient_vector_epochs[n]; 
+	if( epoch == gradient_epoch )
+	{ return; }
+	
+	// first read of a stale voxel: claim this voxel only, by swapping in the 
+	// in-progress marker. The one thread that swaps out a stale epoch computes 
+	// the gradient; compute_gradient_vector publishes gradient_epoch when done. 
+	#pragma omp atomic capture seq_cst 
+	{ epoch = gradient_vector_epochs[n]; gradient_vector_epochs[n] = gradient_epoch_in_progress; }
+	
+	if( epoch == gradient_epoch )
 	{
-		two_dx *= 2.0; 
-		two_dy *= 2.0; 
-		two_dz *= 2.0;
-		gradient_constants_defined = true; 
+		// it was finished in the meantime: put the epoch back 
+		#pragma omp atomic write seq_cst 
+		gradient_vector_epochs[n] = gradient_epoch; 
+		return; 
 	}
-	
-	#pragma omp parallel for 
-	for( unsigned int k=0; k < mesh.z_coordinates.size() ; k++ )
+	if( epoch != gradient_epoch_in_progress )
 	{
-		for( unsigned int j=0; j < mesh.y_coordinates.size() ; j++ )
-		{
-			// endcaps 
-			for( unsigned int q=0; q < number_of_densities() ; q++ )
-			{
-				int i = 0; 
-				int n = voxel_index(i,j,k);
-				// x-derivative of qth substrate at voxel n
-				gradient_vectors[n][q][0] = (*p_density_vectors)[n+thomas_i_jump][q]; 
-				gradient_vectors[n][q][0] -= (*p_density_vectors)[n][q]; 
-				gradient_vectors[n][q][0] /= mesh.dx; 
-				
-				gradient_vector_computed[n] = true; 
-			}
-			for( unsigned int q=0; q < number_of_densities() ; q++ )
-			{
-				int i = mesh.x_coordinates.size()-1; 
-				int n = voxel_index(i,j,k);
-				// x-derivative of qth substrate at voxel n
-				gradient_vectors[n][q][0] = (*p_density_vectors)[n][q]; 
-				gradient_vectors[n][q][0] -= (*p_density_vectors)[n-thomas_i_jump][q]; 
-				gradient_vectors[n][q][0] /= mesh.dx; 
-				
-				gradient_vector_computed[n] = true; 
-			}
-			
-			for( unsigned int i=1; i < mesh.x_coordinates.size()-1 ; i++ )
-			{
-				for( unsigned int q=0; q < number_of_densities() ; q++ )
-				{
-					int n = voxel_index(i,j,k);
-					// x-derivative of qth substrate at voxel n
-					gradient_vectors[n][q][0] = (*p_density_vectors)[n+thomas_i_jump][q]; 
-					gradient_vectors[n][q][0] -= (*p_density_vectors)[n-thomas_i_jump][q]; 
-					gradient_vectors[n][q][0] /= two_dx; 
-					
-					gradient_vector_computed[n] = true; 
- 				}
-			}
-			
-		}
+		compute_gradient_vector( n ); 
+		return; 
 	}
 	
-	#pragma omp parallel for 
-	for( unsigned int k=0; k < mesh.z_coordinates.size() ; k++ )
+	// another thread holds the claim: wait for it to publish 
+	while( epoch != gradient_epoch )
 	{
-		for( unsigned int i=0; i < mesh.x_coordinates.size() ; i++ )
-		{
-			// endcaps 
-			for( unsigned int q=0; q < number_of_densities() ; q++ )
-			{
-				int j = 0; 
-				int n = voxel_index(i,j,k);
-				// x-derivative of qth substrate at voxel n
-				gradient_vectors[n][q][1] = (*p_density_vectors)[n+thomas_j_jump][q]; 
-				gradient_vectors[n][q][1] -= (*p_density_vectors)[n][q]; 
-				gradient_vectors[n][q][1] /= mesh.dy; 
-				
-				gradient_vector_computed[n] = true; 
-			}
-			for( unsigned int q=0; q < number_of_densities() ; q++ )
-			{
-				int j = mesh.y_coordinates.size()-1; 
-				int n = voxel_index(i,j,k);
-				// x-derivative of qth substrate at voxel n
-				gradient_vectors[n][q][1] = (*p_density_vectors)[n][q]; 
-				gradient_vectors[n][q][1] -= (*p_density_vectors)[n-thomas_j_jump][q]; 
-				gradient_vectors[n][q][1] /= mesh.dy; 
-				
-				gradient_vector_computed[n] = true; 
-			}		
-			
-			for( unsigned int j=1; j < mesh.y_coordinates.size()-1 ; j++ )
-			{
-				for( unsigned int q=0; q < number_of_densities() ; q++ )
-				{
-					int n = voxel_index(i,j,k);
-					// y-derivative of qth substrate at voxel n
-					gradient_vectors[n][q][1] = (*p_density_vectors)[n+thomas_j_jump][q]; 
-					gradient_vectors[n][q][1] -= (*p_density_vectors)[n-thomas_j_jump][q]; 
-					gradient_vectors[n][q][1] /= two_dy; 
-					gradient_vector_computed[n] = true; 
-				}
-			}
-			
-		}
+		#pragma omp atomic read seq_cst 
+		epoch = gradient_vector_epochs[n]; 
 	}
-	
-	// don't bother computing z component if there is no z-directoin 
-	if( mesh.z_coordinates.size() == 1 )
-	{ return; }
+	return; 
+}
 
-	#pragma omp parallel for 
-	for( unsigned int j=0; j < mesh.y_coordinates.size() ; j++ )
+void Microenvironment::invalidate_gradient_vectors( void )
+{
+	gradient_epoch++; 
+	// on wrap-around, make sure no stale voxel looks current, and never 
+	// use the in-progress marker as an epoch 
+	if( gradient_epoch == 0 || gradient_epoch == gradient_epoch_in_progress )
 	{
-		for( unsigned int i=0; i < mesh.x_coordinates.size() ; i++ )
-		{
-			// endcaps 
-			for( unsigned int q=0; q < number_of_densities() ; q++ )
-			{
-				int k = 0; 
-				int n = voxel_index(i,j,k);
-				// x-derivative of qth substrate at voxel n
-				gradient_vectors[n][q][2] = (*p_density_vectors)[n+thomas_k_jump][q]; 
-				gradient_vectors[n][q][2] -= (*p_density_vectors)[n][q]; 
-				gradient_vectors[n][q][2] /= mesh.dz; 
-				
-				gradient_vector_computed[n] = true; 
-			}
-			for( unsigned int q=0; q < number_of_densities() ; q++ )
-			{
-				int k = mesh.z_coordinates.size()-1; 
-				int n = voxel_index(i,j,k);
-				// x-derivative of qth substrate at voxel n
-				gradient_vectors[n][q][2] = (*p_density_vectors)[n][q]; 
-				gradient_vectors[n][q][2] -= (*p_density_vectors)[n-thomas_k_jump][q]; 
-				gradient_vectors[n][q][2] /= mesh.dz; 
-				
-				gradient_vector_computed[n] = true; 
-			}			
-			
-			for( unsigned int k=1; k < mesh.z_coordinates.size()-1 ; k++ )
-			{
-				for( unsigned int q=0; q < number_of_densities() ; q++ )
-				{
-					int n = voxel_index(i,j,k);
-					// y-derivative of qth substrate at voxel n
-					gradient_vectors[n][q][2] = (*p_density_vectors)[n+thomas_k_jump][q]; 
-					gradient_vectors[n][q][2] -= (*p_density_vectors)[n-thomas_k_jump][q]; 
-					gradient_vectors[n][q][2] /= two_dz; 
-					gradient_vector_computed[n] = true; 
-				}
-			}
-			
-		}
+		gradient_vector_epochs.assign( mesh.voxels.size() , 0 ); 
+		gradient_epoch = 1; 
 	}
-
 	return; 
 }
 
-void Microenvironment::compute_gradient_vector( int n )
+void Microenvironment::compute_all_gradient_vectors( void )
 {
-	static double two_dx = mesh.dx; 
-	static double two_dy = mesh.dy; 
-	static double two_dz = mesh.dz; 
-	static bool gradient_constants_defined = false; 
-	std::vector<unsigned int> indices(3,0);
+	invalidate_gradient_vectors(); 
 	
-	if( gradient_constants_defined == false )
-	{
-		two_dx *= 2.0; 
-		two_dy *= 2.0; 
-		two_dz *= 2.0;
-		gradient_constants_defined = true; 
-	}	
-	
-	indices = cartesian_indices( n );
-	
-	// d/dx 
-	if( indices[0] > 0 && indices[0] < mesh.x_coordinates.size()-1 )
+	// one fused pass: all three components of every substrate per voxel 
+	#pragma omp parallel for 
+	for( unsigned int k=0; k < mesh.z_coordinates.size() ; k++ )
 	{
-		for( unsigned int q=0; q < number_of_densities() ; q++ )
+		for( unsigned int j=0; j < mesh.y_coordinates.size() ; j++ )
 		{
-			gradient_vectors[n][q][0] = (*p_density_vectors)[n+thomas_i_jump][q]; 
-			gradient_vectors[n][q][0] -= (*p_density_vectors)[n-thomas_i_jump][q]; 
-			gradient_vectors[n][q][0] /= two_dx; 
-			gradient_vector_computed[n] = true; 
+			for( unsigned int i=0; i < mesh.x_coordinates.size() ; i++ )
+			{ compute_gradient_vector( voxel_index(i,j,k) , i, j, k ); }
 		}
 	}
 	
-	// don't bother computing y and z component if there is no y-direction. (1D)
-	if( mesh.y_coordinates.size() == 1 )
-	{ return; }	
+	return; 
+}
+
+void Microenvironment::compute_gradient_vectors( std::vector<Basic_Agent*>& basic_agent_list )
+{
+	invalidate_gradient_vectors(); 
 	
-	// d/dy 
-	if( indices[1] > 0 && indices[1] < mesh.y_coordinates.size()-1 )
+	// unique occupied voxels, found serially so each is computed once 
+	gradient_voxels_to_compute.clear(); 
+	for( unsigned int i=0; i < basic_agent_list.size() ; i++ )
 	{
-		for( unsigned int q=0; q < number_of_densities() ; q++ )
+		int n = basic_agent_list[i]->get_current_voxel_index(); 
+		if( basic_agent_list[i]->is_active == false || n < 0 )
+		{ continue; }
+		
+		if( gradient_vector_epochs[n] != gradient_epoch )
 		{
-			gradient_vectors[n][q][1] = (*p_density_vectors)[n+thomas_j_jump][q]; 
-			gradient_vectors[n][q][1] -= (*p_density_vectors)[n-thomas_j_jump][q]; 
-			gradient_vectors[n][q][1] /= two_dy; 
-			gradient_vector_computed[n] = true; 
+			gradient_vector_epochs[n] = gradient_epoch; 
+			gradient_voxels_to_compute.push_back( n ); 
 		}
 	}
 	
-	// don't bother computing z component if there is no z-direction (2D) 
-	if( mesh.z_coordinates.size() == 1 )
-	{ return; }
+	#pragma omp parallel for 
+	for( unsigned int m=0; m < gradient_voxels_to_compute.size() ; m++ )
+	{ compute_gradient_vector( gradient_voxels_to_compute[m] ); }
 	
-	// d/dz 
-	if( indices[2] > 0 && indices[2] < mesh.z_coordinates.size()-1 )
+	return; 
+}
+
+void Microenvironment::update_gradient_vectors( std::vector<Basic_Agent*>& basic_agent_list )
+{
+	if( gradient_mode == gradient_mode_occupied_voxels )
+	{ compute_gradient_vectors( basic_agent_list ); return; }
+	if( gradient_mode == gradient_mode_on_demand )
+	{ invalidate_gradient_vectors(); return; }
+	
+	compute_all_gradient_vectors(); 
+	return; 
+}
+
+void Microenvironment::update_gradient_vectors( void )
+{
+	update_gradient_vectors( all_basic_agents ); 
+	return; 
+}
+
+void Microenvironment::set_gradient_mode( int mode )
+{
+	if( mode != gradient_mode_all_voxels && 
+		mode != gradient_mode_occupied_voxels && 
+		mode != gradient_mode_on_demand )
 	{
-		for( unsigned int q=0; q < number_of_densities() ; q++ )
-		{
-			gradient_vectors[n][q][2] = (*p_density_vectors)[n+thomas_k_jump][q]; 
-			gradient_vectors[n][q][2] -= (*p_density_vectors)[n-thomas_k_jump][q]; 
-			gradient_vectors[n][q][2] /= two_dz; 
-			gradient_vector_computed[n] = true; 
-		}
+		std::cout << "Warning: unknown gradient mode " << mode 
+			<< ". Keeping " << gradient_mode_name( gradient_mode ) << "." << std::endl; 
+		return; 
 	}
-	
+	gradient_mode = mode; 
 	return; 
 }
 
+int Microenvironment::get_gradient_mode( void )
+{ return gradient_mode; }
+
 void Microenvironment::reset_all_gradient_vectors( void )
 {
 	for( unsigned int k=0 ; k < mesh.voxels.size() ; k++ )
@@ -1074,7 +1744,7 @@ void Microenvironment::reset_all_gradient_vectors( void )
 			(gradient_vectors[k])[i].resize( 3, 0.0 );
 		}
 	}
-	gradient_vector_computed.assign( mesh.voxels.size() , false ); 	
+	gradient_vector_epochs.assign( mesh.voxels.size() , 0 ); 	
 }
 
 
@@ -1124,6 +1794,13 @@ Microenvironment_Options::Microenvironment_Options()
 	calculate_gradients = false; 
 	
 	track_internalized_substrates_in_each_agent = false; 
+	
+	diffusion_solver = "LOD"; 
+	gradient_mode = gradient_mode_all_voxels; 
+	quasi_static_max_factor = 16; 
+	active_region_tile_size = 8; 
+	active_region_tolerance = 1e-6; 
+	active_region_refresh_interval = 100; 
 
 	Dirichlet_all.push_back( true ); 
 //	Dirichlet_interior.push_back( true ); 
@@ -1179,6 +1856,69 @@ void initialize_microenvironment( void )
 		default_microenvironment_options.Z_range[0], default_microenvironment_options.Z_range[1], 
 		default_microenvironment_options.dx,default_microenvironment_options.dy,default_microenvironment_options.dz );
 		
+	// solver and storage choices (new in 1.14.3) 
+	if( default_microenvironment_options.diffusion_solver == "auto" )
+	{ microenvironment.auto_choose_diffusion_decay_solver(); }
+	if( default_microenvironment_options.diffusion_solver == "vectorized_LOD" && 
+		default_microenvironment_options.simulate_2D == false )
+	{ microenvironment.diffusion_decay_solver = diffusion_decay_solver__constant_coefficients_LOD_3D_vectorized; }
+	if( default_microenvironment_options.diffusion_solver == "tiled_LOD" && 
+		default_microenvironment_options.simulate_2D == false )
+	{ microenvironment.diffusion_decay_solver = diffusion_decay_solver__constant_coefficients_LOD_3D_tiled; }
+	if( default_microenvironment_options.diffusion_solver == "multigrid" )
+	{
+		microenvironment.diffusion_decay_solver = diffusion_decay_solver__constant_coefficients_multigrid; 
+		std::cout << "Note: the multigrid solver is meant for steady-state or quasi-static fields. " << std::endl 
+			<< "      As a time stepper, it is 4-5x slower than LOD." << std::endl; 
+	}
+	if( default_microenvironment_options.diffusion_solver == "variable_LOD" )
+	{ microenvironment.diffusion_decay_solver = diffusion_decay_solver__variable_coefficients_LOD_3D; }
+	if( default_microenvironment_options.diffusion_solver == "active_region_LOD" )
+	{ microenvironment.diffusion_decay_solver = diffusion_decay_solver__constant_coefficients_LOD_active_region; }
+	// per-substrate step multipliers and quasi-static tolerances (new in 1.14.3) need the 
+	// sub-cycled solver, which only replaces the plain LOD solver 
+	if( microenvironment.uses_diffusion_subcycling() )
+	{
+		if( default_microenvironment_options.diffusion_solver != "LOD" && 
+			default_microenvironment_options.diffusion_solver != "auto" )
+		{
+			std::cout << "Error: diffusion step multipliers and quasi-static tolerances need the sub-cycled LOD solver, " << std::endl 
+				<< "       but the diffusion solver is set to " << default_microenvironment_options.diffusion_solver << "." << std::endl 
+				<< "       Use LOD (or auto), or remove the step multipliers and quasi-static tolerances." << std::endl; 
+			exit(-1); 
+		}
+		if( microenvironment.uses_variable_diffusion_coefficients() )
+		{
+			std::cout << "Error: the sub-cycled LOD solver does not support voxel diffusion coefficients." << std::endl 
+				<< "       Remove the diffusion step multipliers and quasi-static tolerances, or the voxel field." << std::endl; 
+			exit(-1); 
+		}
+		// it uses dx, dy, and dz along their own axes 
+		microenvironment.diffusion_decay_solver = diffusion_decay_solver__constant_coefficients_LOD_subcycled; 
+	}
+	// the other constant-coefficient LOD solvers use dx along every axis 
+	else if( mesh_spacing_is_anisotropic( microenvironment.mesh ) && 
+		( microenvironment.diffusion_decay_solver == diffusion_decay_solver__constant_coefficients_LOD_3D || 
+		microenvironment.diffusion_decay_solver == diffusion_decay_solver__constant_coefficients_LOD_2D || 
+		microenvironment.diffusion_decay_solver == diffusion_decay_solver__constant_coefficients_LOD_3D_vectorized || 
+		microenvironment.diffusion_decay_solver == diffusion_decay_solver__constant_coefficients_LOD_3D_tiled ) )
+	{
+		std::cout << "Anisotropic voxels (dx = " << microenvironment.mesh.dx << ", dy = " << microenvironment.mesh.dy 
+			<< ", dz = " << microenvironment.mesh.dz << "): using diffusion_decay_solver__variable_coefficients_LOD_3D." << std::endl; 
+		microenvironment.diffusion_decay_solver = diffusion_decay_solver__variable_coefficients_LOD_3D; 
+	}
+	// a voxel diffusion field set before this point needs the variable-coefficient solver 
+	if( microenvironment.uses_variable_diffusion_coefficients() && 
+		solver_ignores_voxel_diffusion_coefficients( microenvironment.diffusion_decay_solver ) )
+	{
+		std::cout << "Voxel diffusion coefficients set: using diffusion_decay_solver__variable_coefficients_LOD_3D." << std::endl; 
+		microenvironment.diffusion_decay_solver = diffusion_decay_solver__variable_coefficients_LOD_3D; 
+	}
+	microenvironment.set_gradient_mode( default_microenvironment_options.gradient_mode ); 
+	microenvironment.set_quasi_static_max_factor( default_microenvironment_options.quasi_static_max_factor ); 
+	microenvironment.set_active_region_parameters( default_microenvironment_options.active_region_tile_size , 
+		default_microenvironment_options.active_region_tolerance , default_microenvironment_options.active_region_refresh_interval ); 
+
 	// set units
 	microenvironment.spatial_units = default_microenvironment_options.spatial_units;
 	microenvironment.time_units = default_microenvironment_options.time_units;
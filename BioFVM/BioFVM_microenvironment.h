@@ -59,9 +59,95 @@ namespace BioFVM{
 /* and now some gradients */ 
 typedef std::vector<double> gradient; 
 
+/* contiguous density storage -- new in 1.14.3 */ 
+
+// layouts of Contiguous_Density_Storage 
+const int density_storage_voxel_major = 1; // data[ n*number_of_densities + q ] 
+const int density_storage_substrate_major = 2; // data[ q*padded_number_of_voxels + n ] 
+
+/* gradient modes -- new in 1.14.3 */ 
+
+// which voxels Microenvironment::update_gradient_vectors refreshes 
+const int gradient_mode_all_voxels = 0; // every voxel (default) 
+const int gradient_mode_occupied_voxels = 1; // voxels that hold an active agent 
+const int gradient_mode_on_demand = 2; // none; each voxel on its first read 
+
+std::string gradient_mode_name( int mode ); 
+int gradient_mode_from_name( std::string name ); 
+
+/*! A single 64-byte aligned block that holds every density at every voxel: 
+    the working set of the vectorized, tiled, variable-coefficient, 
+    sub-cycled, and MPI LOD solvers. They gather the voxel density vectors 
+    into it, sweep with fixed strides, and scatter the result back. The 
+    voxel density vectors stay the authoritative storage, since operator() 
+    and nearest_density_vector() hand them out by reference. The plain LOD 
+    solvers sweep those vectors directly and don't use the block. */ 
+
+class Contiguous_Density_Storage
+{
+ private:
+	std::vector<double> buffer; 
+	double* aligned_data; 
+	void align( void ); 
+
+ public:
+	int layout; 
+	unsigned int number_of_voxels; 
+	unsigned int number_of_densities; 
+	
+	// offset (in doubles) between neighboring voxels and neighboring substrates; 
+	// size_t, so that offsets into large blocks don't overflow 
+	size_t voxel_stride; 
+	size_t substrate_stride; 
+	
+	Contiguous_Density_Storage(); 
+	Contiguous_Density_Storage( const Contiguous_Density_Storage& copy_me ); 
+	Contiguous_Density_Storage& operator=( const Contiguous_Density_Storage& copy_me ); 
+
+	void resize( int new_layout , unsigned int voxels , unsigned int densities ); 
+
+	double* data( void ); 
+	double& operator()( unsigned int voxel_index , unsigned int substrate_index ); 
+
+	void gather( std::vector< std::vector<double> >& source ); 
+	void scatter( std::vector< std::vector<double> >& destination ); 
+	// only the listed substrates 
+	void gather( std::vector< std::vector<double> >& source , std::vector<int>& substrate_indices ); 
+	void scatter( std::vector< std::vector<double> >& destination , std::vector<int>& substrate_indices ); 
+};
+
+/*! One grid of the geometric multigrid solver (new in 1.14.3), stored with 
+    x fastest like the mesh. Level 0 is the mesh itself; each coarser level 
+    merges pairs of cells along every axis that still has more than one. */ 
+
+class Multigrid_Level
+{
+ public:
+	int nx; 
+	int ny; 
+	int nz; 
+	double dx; 
+	double dy; 
+	double dz; 
+	
+	std::vector<double> solution; 
+	std::vector<double> right_hand_side; 
+	std::vector<double> residual; 
+	// 1/dt + decay rate + implicit uptake (per volume) 
+	std::vector<double> diagonal; 
+	// Dirichlet cells keep their value (and get no correction) 
+	std::vector<char> fixed; 
+	
+	Multigrid_Level(); 
+	void resize( int x_nodes , int y_nodes , int z_nodes , double x_spacing , double y_spacing , double z_spacing ); 
+};
+
 /*! /brief   */
 
 class Basic_Agent; 
+#ifdef BioFVM_MPI 
+class Domain_Decomposition; 
+#endif 
 
 class Microenvironment
 {
@@ -78,13 +164,37 @@ class Microenvironment
 	std::vector< std::vector<double> > bulk_source_sink_solver_temp2; 
 	std::vector< std::vector<double> > bulk_source_sink_solver_temp3; 
 	bool bulk_source_sink_solver_setup_done; 
+	/*! opt-in cache: temp3 holds 1/(1+dt*(U+S)) and temp2 holds dt*S*T/(1+dt*(U+S)) */ 
+	bool bulk_source_sink_cache_enabled; 
+	bool bulk_source_sink_cache_is_current; 
+	double bulk_source_sink_cache_dt; 
+	void build_bulk_source_sink_cache( double dt ); 
+
+	/*! for the voxel-binned cell source/sink solver: active agents (and 
+	    their list indices) grouped by voxel, in list order within each 
+	    voxel, and the start of each occupied voxel's run */ 
+	std::vector<int> agent_counts_by_voxel; 
+	std::vector<int> occupied_voxels; 
+	std::vector<int> occupied_voxel_offsets; 
+	std::vector<int> agent_indices_by_voxel; 
+	std::vector<Basic_Agent*> agents_sorted_by_voxel; 
 
 	
 	/*! stores pointer to current density solutions. Access via operator() functions. */ 
 	std::vector< std::vector<double> >* p_density_vectors; 
 	
 	std::vector< std::vector<gradient> > gradient_vectors; 
-	std::vector<bool> gradient_vector_computed; 
+	/* gradient_vectors[n] is current when gradient_vector_epochs[n] == gradient_epoch. 
+	   Unlike the former std::vector<bool> flags, these are safe to update from 
+	   several threads (new in 1.14.3). A stale voxel read in on_demand mode is 
+	   claimed per voxel with an atomic swap, so concurrent readers only wait 
+	   on each other when they read the same voxel. */ 
+	std::vector<unsigned int> gradient_vector_epochs; 
+	unsigned int gradient_epoch; 
+	int gradient_mode; 
+	std::vector<int> gradient_voxels_to_compute; 
+	void compute_gradient_vector( int n , unsigned int i , unsigned int j , unsigned int k ); 
+	void make_gradient_vector_current( int n ); 
 
 	
 	/*! helpful for solvers -- resize these whenever adding/removing substrates */ 
@@ -119,26 +229,105 @@ class Microenvironment
 	std::vector< std::vector<double> > thomas_cz;
 	bool diffusion_solver_setup_done; 
 	
+	/* new in Version 1.14.3 -- the coefficients above, rearranged once at 
+	   setup: one line per substrate for the vectorized LOD solver, and 
+	   repeated across a tile of voxels for the tiled LOD solver */ 
+	std::vector< std::vector<double> > thomas_batched_denomx; 
+	std::vector< std::vector<double> > thomas_batched_cx; 
+	std::vector< std::vector<double> > thomas_batched_denomy; 
+	std::vector< std::vector<double> > thomas_batched_cy; 
+	std::vector< std::vector<double> > thomas_batched_denomz; 
+	std::vector< std::vector<double> > thomas_batched_cz; 
+	std::vector<double> thomas_tiled_denomy; 
+	std::vector<double> thomas_tiled_cy; 
+	std::vector<double> thomas_tiled_denomz; 
+	std::vector<double> thomas_tiled_cz; 
+	std::vector<double> thomas_tiled_constant1; 
+	
+	/* new in Version 1.14.3 -- per-substrate diffusion sub-cycling: substrate 
+	   q is solved on every diffusion_step_multipliers[q]-th step (missing 
+	   entries mean 1). The counter is reset when the solver is set up. */ 
+	std::vector<int> diffusion_step_multipliers; 
+	unsigned int diffusion_step_counter; 
+	
+	/* new in Version 1.14.3 -- quasi-static mode of the sub-cycled solver: 
+	   once a substrate changes by less than its tolerance (relative, per 
+	   step) between two solves, only every quasi_static_factors[q]-th due 
+	   step is solved and the others re-apply the last diffusion-decay 
+	   increment. The factor doubles up to quasi_static_max_factor and drops 
+	   back to 1 on a faster change. */ 
+	std::vector<double> quasi_static_tolerances; 
+	std::vector<int> quasi_static_factors; 
+	int quasi_static_max_factor; 
+	std::vector<int> quasi_static_skipped_solves; 
+	std::vector<int> quasi_static_steps_since_solve; 
+	std::vector< std::vector<double> > quasi_static_previous_densities; // [substrate][voxel] 
+	std::vector< std::vector<double> > quasi_static_increments; // [substrate][voxel] 
+	
+	/* new in Version 1.14.3 -- geometric multigrid: the grid hierarchy 
+	   (rebuilt when the mesh changes) and the stopping criteria */ 
+	std::vector<Multigrid_Level> multigrid_levels; 
+	double multigrid_tolerance; 
+	int multigrid_max_cycles; 
+	
+	/* new in Version 1.14.3 -- variable-coefficient LOD: per-voxel diffusion 
+	   coefficients ([voxel][substrate], empty until one is set) and the 
+	   precomputed Thomas coefficients of each axis */ 
+	std::vector< std::vector<double> > voxel_diffusion_coefficients; 
+	std::vector< std::vector<double> > variable_thomas_denom; 
+	std::vector< std::vector<double> > variable_thomas_c; 
+	bool variable_thomas_setup_done; 
+	double variable_thomas_dt; 
+	
+	/* new in Version 1.14.3 -- active-region LOD: the mesh is cut into cubic 
+	   tiles, and only tiles that hold an agent, changed by more than the 
+	   tolerance when last solved, or touch such a tile are swept */ 
+	int active_region_tile_size; 
+	double active_region_tolerance; 
+	int active_region_refresh_interval; 
+	unsigned int active_region_step_counter; 
+	std::vector<int> active_region_tiles_per_axis; 
+	std::vector<char> active_region_tiles; // swept in the last step 
+	std::vector<char> active_region_changed; // changed when last swept 
+	std::vector<double> active_region_scale; // largest density seen, per substrate 
+	std::vector<double> active_region_previous_densities; // one block of tile voxels x substrates per active tile 
+	
 	// on "resize density" type operations, need to extend all of these 
 	
-	/*
-	std::vector<int> dirichlet_indices; 
-	std::vector< std::vector<double> > dirichlet_value_vectors; 
-	std::vector<bool> dirichlet_node_map; 
-	*/
 	std::vector< std::vector<double> > dirichlet_value_vectors; 
 	std::vector<bool> dirichlet_activation_vector; 
 	
+	/* new in Version 1.14.3 -- compact list of the Dirichlet nodes (sorted), 
+	   grouped into runs of consecutive voxels that share their values and 
+	   activations, so that boundary faces are applied as plane writes. 
+	   Rebuilt on the next apply after any Dirichlet change. */ 
+	std::vector<int> dirichlet_indices; 
+	std::vector<int> dirichlet_run_starts; 
+	std::vector<int> dirichlet_run_lengths; 
+	bool dirichlet_indices_are_current; 
+	void update_dirichlet_indices( void ); 
+	
 	/* new in Version 1.7.0 -- activation vectors can be specified 
 	   on a voxel-by-voxel basis */ 
 	   
 	std::vector< std::vector<bool> > dirichlet_activation_vectors; 
 	
+	/* new in Version 1.14.3 -- contiguous copy of the densities for the 
+	   fast solvers. The voxel-wise vectors remain the reference copy, and 
+	   this is a working buffer next to them (see Contiguous_Density_Storage). */ 
+	
+	Contiguous_Density_Storage contiguous_densities; 
+	void size_contiguous_densities( int layout ); 
+	
  public:
 	
 	/*! The mesh for the diffusing quantities */ 
 	Cartesian_Mesh mesh;
 	Agent_Container * agent_container;	
+#ifdef BioFVM_MPI 
+	// set by Domain_Decomposition::setup (new in 1.14.3); NULL otherwise 
+	Domain_Decomposition* decomposition; 
+#endif 
 	std::string spatial_units; 
 	std::string time_units; 
 	std::string name; 
@@ -156,6 +345,16 @@ class Microenvironment
 	std::vector< std::vector<double> > uptake_rates; 
 	void update_rates( void ); 
 	
+	/* Opt-in for time-invariant bulk sources and sinks (new in 1.14.3): build 
+	   the per-voxel factors from supply_rates, uptake_rates, and 
+	   supply_target_densities_times_supply_rates once (calling update_rates() 
+	   first if they are not set up), then simulate_bulk_sources_and_sinks() is 
+	   one multiply-add per density. Call invalidate_bulk_source_sink_cache() 
+	   after changing those arrays (or after update_rates() with new bulk 
+	   functions). A change in dt rebuilds the cache automatically. */ 
+	void enable_bulk_source_sink_cache( bool enable ); 
+	void invalidate_bulk_source_sink_cache( void ); 
+	
 	Microenvironment(); 
 	Microenvironment(std::string name);
 	
@@ -173,6 +372,55 @@ class Microenvironment
  	
 	void auto_choose_diffusion_decay_solver( void ); 
 	
+	/*! copy the densities into the contiguous storage (and back). The 
+	    overload with substrate indices uses density_storage_voxel_major. */ 
+	Contiguous_Density_Storage& gather_contiguous_densities( int layout ); 
+	void scatter_contiguous_densities( void ); 
+	Contiguous_Density_Storage& gather_contiguous_densities( std::vector<int>& substrate_indices ); 
+	void scatter_contiguous_densities( std::vector<int>& substrate_indices ); 
+	
+	/*! per-substrate diffusion sub-cycling (new in 1.14.3): with a multiplier 
+	    k, the substrate is only diffused on every k-th step, using k*dt. Only 
+	    diffusion_decay_solver__constant_coefficients_LOD_subcycled reads the 
+	    multipliers; they default to 1. */ 
+	void set_diffusion_step_multiplier( int substrate_index , int multiplier ); 
+	int get_diffusion_step_multiplier( int substrate_index ); 
+	bool uses_diffusion_subcycling( void ); 
+	
+	/*! quasi-static mode of the sub-cycled solver (new in 1.14.3): while a 
+	    substrate's largest change per step, relative to its largest value, 
+	    stays below its tolerance, only every 2nd, 4th, ... (up to the maximum 
+	    factor) of its due steps runs the LOD sweeps; the others add the 
+	    increment of the last sweeps, which holds a settled field in place at 
+	    the cost of one pass. A tolerance of 0 (the default) turns it off. */ 
+	void set_quasi_static_tolerance( int substrate_index , double tolerance ); 
+	double get_quasi_static_tolerance( int substrate_index ); 
+	void set_quasi_static_max_factor( int factor ); 
+	int get_quasi_static_factor( int substrate_index ); 
+	
+	/*! multigrid solves (new in 1.14.3) run V-cycles until the largest 
+	    residual has dropped by the tolerance (default 1e-8) relative to the 
+	    first one, or until max_cycles (default 50) */ 
+	void set_multigrid_tolerance( double tolerance , int max_cycles ); 
+	
+	/*! per-voxel diffusion coefficients (new in 1.14.3), e.g. lower in a 
+	    necrotic core. The first call copies diffusion_coefficients into every 
+	    voxel (so add all substrates first) and switches the constant- 
+	    coefficient LOD solvers to diffusion_decay_solver__variable_coefficients_LOD_3D. */ 
+	void set_diffusion_coefficient( int voxel_index , int substrate_index , double value ); 
+	double get_diffusion_coefficient( int voxel_index , int substrate_index ); 
+	bool uses_variable_diffusion_coefficients( void ); 
+	
+	/*! active-region diffusion (new in 1.14.3), used by 
+	    diffusion_decay_solver__constant_coefficients_LOD_active_region: tiles 
+	    of tile_size^3 voxels (default 8) are skipped while they hold no agent 
+	    and changed by less than tolerance (default 1e-6, relative to the 
+	    largest density, per step) when last swept; every refresh_interval-th 
+	    step (default 100, 0 = never) sweeps the whole mesh */ 
+	void set_active_region_parameters( int tile_size , double tolerance , int refresh_interval ); 
+	// fraction of the tiles swept in the last step 
+	double active_region_fraction( void ); 
+	
 	// Only use this on non-Cartesian meshes. It's a fail-safe. 
 	void resize_voxels( int new_number_of_voxes ); 
 	
@@ -218,6 +466,17 @@ class Microenvironment
 	void compute_gradient_vector( int n );  
 	void reset_all_gradient_vectors( void ); 
 	
+	/* new in 1.14.3: refresh the gradients as set by the gradient mode. In the 
+	   occupied-voxel mode, only voxels of active agents in basic_agent_list are 
+	   computed. In the on-demand mode the gradients are only marked stale. 
+	   Any stale voxel is (re)computed, thread-safely, on its first read. */ 
+	void update_gradient_vectors( std::vector<Basic_Agent*>& basic_agent_list ); 
+	void update_gradient_vectors( void ); // uses all_basic_agents 
+	void compute_gradient_vectors( std::vector<Basic_Agent*>& basic_agent_list ); 
+	void invalidate_gradient_vectors( void ); 
+	void set_gradient_mode( int mode ); 
+	int get_gradient_mode( void ); 
+	
 	/*! access the density vector at  [ X(i),Y(j),Z(k) ] */
 	std::vector<double>& density_vector( int i, int j, int k ); 
 	/*! access the density vector at  [ X(i),Y(j),0 ]  -- helpful for 2-D problems */
@@ -243,6 +502,7 @@ class Microenvironment
 	void update_dirichlet_node( int voxel_index , int substrate_index , double new_value );
 	void remove_dirichlet_node( int voxel_index ); 
 	void apply_dirichlet_conditions( void ); 
+	void apply_dirichlet_conditions( Contiguous_Density_Storage& densities ); 
 
 	// set for ALL Dirichlet nodes -- 1.7.0
 	void set_substrate_dirichlet_activation( int substrate_index , bool new_value );  
@@ -267,6 +527,24 @@ class Microenvironment
 	
 	friend void diffusion_decay_explicit_uniform_rates( Microenvironment& M, double dt );
 	
+	friend void LOD_sweeps_on_contiguous_storage( Microenvironment& M, bool z_sweep ); 
+	friend void LOD_sweeps_on_contiguous_storage( Microenvironment& M, bool z_sweep, std::vector<int>& substrate_indices ); 
+	friend void LOD_3D_precompute_coefficients( Microenvironment& M, double dt ); 
+	friend void LOD_3D_precompute_coefficients( Microenvironment& M, std::vector<double>& substrate_dt );
+	friend void LOD_3D_precompute_coefficients( Microenvironment& M, std::vector<double>& substrate_dt, bool axis_spacing );  
+	friend void diffusion_decay_solver__constant_coefficients_LOD_subcycled( Microenvironment& M, double dt ); 
+	friend void diffusion_decay_solver__constant_coefficients_multigrid( Microenvironment& M, double dt ); 
+	friend void diffusion_decay_solver__variable_coefficients_LOD_3D( Microenvironment& M, double dt ); 
+	friend void LOD_variable_precompute_coefficients( Microenvironment& M, double dt ); 
+	friend void diffusion_decay_solver__constant_coefficients_LOD_active_region( Microenvironment& M, double dt ); 
+	friend int multigrid_reaction_diffusion_solve( Microenvironment& M, double dt, std::vector<Basic_Agent*>& basic_agent_list ); 
+	friend void diffusion_decay_solver__constant_coefficients_LOD_3D_vectorized( Microenvironment& M, double dt ); 
+	friend void diffusion_decay_solver__constant_coefficients_LOD_3D_tiled( Microenvironment& M, double dt ); 
+#ifdef BioFVM_MPI 
+	friend void diffusion_decay_solver__constant_coefficients_LOD_3D_MPI( Microenvironment& M, double dt ); 
+	friend class Domain_Decomposition; 
+#endif 
+	
 	void write_to_matlab( std::string filename );
 	void write_mesh_to_matlab( std::string filename ); // not yet written 
 	void write_densities_to_matlab( std::string filename ); // not yet written 
@@ -286,6 +564,8 @@ extern void diffusion_decay_solver__variable_coefficients_explicit_uniform_mesh(
 extern void diffusion_decay_solver__constant_coefficients_LOD_3D( Microenvironment& S, double dt ); 
 extern void diffusion_decay_solver__constant_coefficients_LOD_2D( Microenvironment& S, double dt ); 
 extern void diffusion_decay_solver__constant_coefficients_LOD_1D( Microenvironment& S, double dt ); 
+extern void diffusion_decay_solver__constant_coefficients_LOD_3D_vectorized( Microenvironment& S, double dt ); 
+extern void diffusion_decay_solver__constant_coefficients_LOD_3D_tiled( Microenvironment& S, double dt ); 
 
 
 extern void diffusion_decay_solver__variable_coefficients_LOD_3D( Microenvironment& S, double dt ); 
@@ -357,6 +637,18 @@ class Microenvironment_Options
 	bool use_oxygen_as_first_field;
 	
 	bool track_internalized_substrates_in_each_agent; 	
+	
+	// "LOD" (default), "vectorized_LOD", "tiled_LOD", "variable_LOD", "active_region_LOD", "multigrid", or "auto". 
+	// "multigrid" is for steady-state or quasi-static fields: per step, it is 4-5x slower than LOD. 
+	std::string diffusion_solver; 
+	// gradient_mode_all_voxels (default), gradient_mode_occupied_voxels, or gradient_mode_on_demand 
+	int gradient_mode; 
+	// largest factor by which the quasi-static mode thins out a substrate's solves 
+	int quasi_static_max_factor; 
+	// tiles of the active-region LOD solver 
+	int active_region_tile_size; 
+	double active_region_tolerance; 
+	int active_region_refresh_interval; 
 };
 
 extern Microenvironment_Options default_microenvironment_options; 
@@ -48,10 +48,51 @@
 
 #include "BioFVM_solvers.h" 
 #include "BioFVM_vector.h" 
+#include "BioFVM_basic_agent.h" 
 
 #include <iostream>
+#include <algorithm>
 #include <omp.h>
 
+/* SIMD lanes for the batched Thomas solver (new in 1.14.3). The width 
+   follows the -march flag in the Makefile: AVX-512, AVX2, or scalar. */ 
+
+#if defined(__AVX512F__)
+	#include <immintrin.h>
+	#define BioFVM_SIMD_WIDTH 8
+	typedef __m512d BioFVM_simd; 
+	#define BioFVM_simd_load(p) _mm512_loadu_pd(p)
+	#define BioFVM_simd_store(p,a) _mm512_storeu_pd(p,a)
+	#define BioFVM_simd_set1(x) _mm512_set1_pd(x)
+	#define BioFVM_simd_fmadd(a,b,c) _mm512_fmadd_pd(a,b,c) 
+	#define BioFVM_simd_fnmadd(a,b,c) _mm512_fnmadd_pd(a,b,c) 
+	#define BioFVM_simd_div(a,b) _mm512_div_pd(a,b)
+#elif defined(__AVX2__)
+	#include <immintrin.h>
+	#define BioFVM_SIMD_WIDTH 4
+	typedef __m256d BioFVM_simd; 
+	#define BioFVM_simd_load(p) _mm256_loadu_pd(p)
+	#define BioFVM_simd_store(p,a) _mm256_storeu_pd(p,a)
+	#define BioFVM_simd_set1(x) _mm256_set1_pd(x)
+	#ifdef __FMA__
+		#define BioFVM_simd_fmadd(a,b,c) _mm256_fmadd_pd(a,b,c) 
+		#define BioFVM_simd_fnmadd(a,b,c) _mm256_fnmadd_pd(a,b,c) 
+	#else
+		#define BioFVM_simd_fmadd(a,b,c) _mm256_add_pd(_mm256_mul_pd(a,b),c) 
+		#define BioFVM_simd_fnmadd(a,b,c) _mm256_sub_pd(c,_mm256_mul_pd(a,b)) 
+	#endif
+	#define BioFVM_simd_div(a,b) _mm256_div_pd(a,b)
+#else
+	#define BioFVM_SIMD_WIDTH 1
+	typedef double BioFVM_simd; 
+	#define BioFVM_simd_load(p) (*(p))
+	#define BioFVM_simd_store(p,a) (*(p) = (a))
+	#define BioFVM_simd_set1(x) (x)
+	#define BioFVM_simd_fmadd(a,b,c) ((a)*(b)+(c))
+	#define BioFVM_simd_fnmadd(a,b,c) ((c)-(a)*(b))
+	#define BioFVM_simd_div(a,b) ((a)/(b))
+#endif
+
 namespace BioFVM{
 
 // do I even need this? 
@@ -93,6 +134,276 @@ void diffusion_decay_solver__constant_coefficients_explicit_uniform_mesh( Microe
 	return; 
 }
 
+/* Thomas solves on the contiguous density storage (new in 1.14.3). A line 
+   starts at pLine, its voxels are step doubles apart, and the substrates 
+   of each voxel are substrate_stride doubles apart. Substrates 
+   first_substrate, ..., number_of_densities-1 are solved. */ 
+
+void contiguous_thomas_solve( double* pLine , size_t step , unsigned int length , 
+	size_t substrate_stride , unsigned int number_of_densities , 
+	std::vector< std::vector<double> >& denom , std::vector< std::vector<double> >& c , 
+	std::vector<double>& constant1 , unsigned int first_substrate )
+{
+	// remaining part of forward elimination, using pre-computed quantities 
+	for( unsigned int q=first_substrate ; q < number_of_densities ; q++ )
+	{ pLine[q*substrate_stride] /= denom[0][q]; }
+	
+	for( unsigned int i=1 ; i < length ; i++ )
+	{
+		double* pV = pLine + i*step; 
+		double* pPrevious = pV - step; 
+		const double* pDenom = denom[i].data(); 
+		for( unsigned int q=first_substrate ; q < number_of_densities ; q++ )
+		{
+			pV[q*substrate_stride] += constant1[q] * pPrevious[q*substrate_stride]; 
+			pV[q*substrate_stride] /= pDenom[q]; 
+		}
+	}
+	
+	// back substitution 
+	for( int i = length-2 ; i >= 0 ; i-- )
+	{
+		double* pV = pLine + i*step; 
+		double* pNext = pV + step; 
+		const double* pC = c[i].data(); 
+		for( unsigned int q=first_substrate ; q < number_of_densities ; q++ )
+		{ pV[q*substrate_stride] -= pC[q] * pNext[q*substrate_stride]; }
+	}
+	
+	return; 
+}
+
+void LOD_sweeps_on_contiguous_storage( Microenvironment& M, bool z_sweep )
+{
+	Contiguous_Density_Storage& D = M.gather_contiguous_densities( density_storage_voxel_major ); 
+	double* pData = D.data(); 
+	
+	int nx = M.mesh.x_coordinates.size(); 
+	int ny = M.mesh.y_coordinates.size(); 
+	int nz = M.mesh.z_coordinates.size(); 
+	size_t vs = D.voxel_stride; 
+	size_t ss = D.substrate_stride; 
+	unsigned int nq = D.number_of_densities; 
+
+	// x-diffusion 
+	
+	M.apply_dirichlet_conditions( D ); 
+	#pragma omp parallel for 
+	for( int line=0 ; line < ny*nz ; line++ )
+	{
+		contiguous_thomas_solve( pData + line*nx*vs , vs , nx , ss , nq , 
+			M.thomas_denomx , M.thomas_cx , M.thomas_constant1x ); 
+	}
+	
+	// y-diffusion 
+	
+	M.apply_dirichlet_conditions( D ); 
+	#pragma omp parallel for 
+	for( int line=0 ; line < nx*nz ; line++ )
+	{
+		int i = line % nx; 
+		int k = line / nx; 
+		contiguous_thomas_solve( pData + (k*nx*ny+i)*vs , nx*vs , ny , ss , nq , 
+			M.thomas_denomy , M.thomas_cy , M.thomas_constant1y ); 
+	}
+	
+	// z-diffusion 
+	
+	if( z_sweep )
+	{
+		M.apply_dirichlet_conditions( D ); 
+		#pragma omp parallel for 
+		for( int line=0 ; line < nx*ny ; line++ )
+		{
+			contiguous_thomas_solve( pData + line*vs , nx*ny*vs , nz , ss , nq , 
+				M.thomas_denomz , M.thomas_cz , M.thomas_constant1z ); 
+		}
+	}
+	
+	M.apply_dirichlet_conditions( D ); 
+	M.scatter_contiguous_densities(); 
+	
+	return; 
+}
+
+/* The same sweeps for a subset of the substrates (new in 1.14.3). Only the 
+   listed substrates are gathered, solved, and scattered back. */ 
+
+void LOD_sweeps_on_contiguous_storage( Microenvironment& M, bool z_sweep, std::vector<int>& substrate_indices )
+{
+	Contiguous_Density_Storage& D = M.gather_contiguous_densities( substrate_indices ); 
+	double* pData = D.data(); 
+	
+	int nx = M.mesh.x_coordinates.size(); 
+	int ny = M.mesh.y_coordinates.size(); 
+	int nz = M.mesh.z_coordinates.size(); 
+	size_t vs = D.voxel_stride; 
+	size_t ss = D.substrate_stride; 
+	int ns = substrate_indices.size(); 
+
+	// x-diffusion 
+	
+	M.apply_dirichlet_conditions( D ); 
+	#pragma omp parallel for 
+	for( int line=0 ; line < ny*nz ; line++ )
+	{
+		for( int s=0 ; s < ns ; s++ )
+		{
+			unsigned int q = substrate_indices[s]; 
+			contiguous_thomas_solve( pData + line*nx*vs , vs , nx , ss , q+1 , 
+				M.thomas_denomx , M.thomas_cx , M.thomas_constant1x , q ); 
+		}
+	}
+	
+	// y-diffusion 
+	
+	M.apply_dirichlet_conditions( D ); 
+	#pragma omp parallel for 
+	for( int line=0 ; line < nx*nz ; line++ )
+	{
+		int i = line % nx; 
+		int k = line / nx; 
+		for( int s=0 ; s < ns ; s++ )
+		{
+			unsigned int q = substrate_indices[s]; 
+			contiguous_thomas_solve( pData + (k*nx*ny+i)*vs , nx*vs , ny , ss , q+1 , 
+				M.thomas_denomy , M.thomas_cy , M.thomas_constant1y , q ); 
+		}
+	}
+	
+	// z-diffusion 
+	
+	if( z_sweep )
+	{
+		M.apply_dirichlet_conditions( D ); 
+		#pragma omp parallel for 
+		for( int line=0 ; line < nx*ny ; line++ )
+		{
+			for( int s=0 ; s < ns ; s++ )
+			{
+				unsigned int q = substrate_indices[s]; 
+				contiguous_thomas_solve( pData + line*vs , nx*ny*vs , nz , ss , q+1 , 
+					M.thomas_denomz , M.thomas_cz , M.thomas_constant1z , q ); 
+			}
+		}
+	}
+	
+	M.apply_dirichlet_conditions( D ); 
+	M.scatter_contiguous_densities( substrate_indices ); 
+	
+	return; 
+}
+
+/* Thomas coefficients for the 3-D LOD solvers. Shared by all 3-D LOD 
+   variants so that they solve exactly the same linear systems. */ 
+
+void LOD_3D_precompute_coefficients( Microenvironment& M, double dt )
+{
+	std::vector<double> substrate_dt( M.number_of_densities() , dt ); 
+	LOD_3D_precompute_coefficients( M , substrate_dt ); 
+	return; 
+}
+
+// each substrate with its own time step (new in 1.14.3) 
+
+void LOD_3D_precompute_coefficients( Microenvironment& M, std::vector<double>& substrate_dt )
+{
+	LOD_3D_precompute_coefficients( M , substrate_dt , false ); 
+	return; 
+}
+
+/* Thomas coefficients along one axis of n voxels with spacing h, and the 
+   off-diagonal factor constant1 = dt*D/h^2 that the sweeps use with them */ 
+
+static void LOD_3D_axis_coefficients( const std::vector<double>& diffusion_coefficients , 
+	const std::vector<double>& decay_rates , const std::vector<double>& one , 
+	std::vector<double>& substrate_dt , double h , unsigned int n , 
+	std::vector<double>& constant1 , std::vector< std::vector<double> >& denom , 
+	std::vector< std::vector<double> >& c )
+{
+	constant1 = diffusion_coefficients; // dt*D/h^2 
+	constant1 *= substrate_dt; 
+	constant1 /= h; 
+	constant1 /= h; 
+	
+	std::vector<double> constant1a = constant1; // -dt*D/h^2 
+	constant1a *= -1.0; 
+	
+	std::vector<double> constant2 = decay_rates; // (1/3)* dt*lambda 
+	constant2 *= substrate_dt; 
+	constant2 /= 3.0; // for the LOD splitting of the source 
+	
+	std::vector<double> constant3 = one; // 1 + 2*constant1 + constant2 
+	constant3 += constant1; 
+	constant3 += constant1; 
+	constant3 += constant2; 
+	
+	std::vector<double> constant3a = one; // 1 + constant1 + constant2 
+	constant3a += constant1; 
+	constant3a += constant2; 
+	
+	c.assign( n , constant1a ); 
+	denom.assign( n , constant3 ); 
+	denom[0] = constant3a; 
+	denom[n-1] = constant3a; 
+	if( n == 1 )
+	{ denom[0] = one; denom[0] += constant2; } 
+	
+	c[0] /= denom[0]; 
+	for( unsigned int i=1 ; i <= n-1 ; i++ )
+	{ 
+		axpy( &denom[i] , constant1 , c[i-1] ); 
+		c[i] /= denom[i]; // the value at  size-1 is not actually used  
+	}
+	return; 
+}
+
+// with axis_spacing, each axis uses its own spacing (dx, dy, dz); otherwise 
+// dx along every axis, as in the original LOD solvers (new in 1.14.3) 
+
+void LOD_3D_precompute_coefficients( Microenvironment& M, std::vector<double>& substrate_dt, bool axis_spacing )
+{
+	M.thomas_i_jump = 1; 
+	M.thomas_j_jump = M.mesh.x_coordinates.size(); 
+	M.thomas_k_jump = M.thomas_j_jump * M.mesh.y_coordinates.size(); 
+
+	M.thomas_constant1 =  M.diffusion_coefficients; // dt*D/dx^2 
+	M.thomas_constant1a = M.zero; // -dt*D/dx^2; 
+	M.thomas_constant2 =  M.decay_rates; // (1/3)* dt*lambda 
+	M.thomas_constant3 = M.one; // 1 + 2*constant1 + constant2; 
+	M.thomas_constant3a = M.one; // 1 + constant1 + constant2; 		
+		
+	M.thomas_constant1 *= substrate_dt; 
+	M.thomas_constant1 /= M.mesh.dx; 
+	M.thomas_constant1 /= M.mesh.dx; 
+
+	M.thomas_constant1a = M.thomas_constant1; 
+	M.thomas_constant1a *= -1.0; 
+
+	M.thomas_constant2 *= substrate_dt; 
+	M.thomas_constant2 /= 3.0; // for the LOD splitting of the source 
+
+	M.thomas_constant3 += M.thomas_constant1; 
+	M.thomas_constant3 += M.thomas_constant1; 
+	M.thomas_constant3 += M.thomas_constant2; 
+
+	M.thomas_constant3a += M.thomas_constant1; 
+	M.thomas_constant3a += M.thomas_constant2; 
+
+	// Thomas solver coefficients 
+	
+	double hy = axis_spacing ? M.mesh.dy : M.mesh.dx; 
+	double hz = axis_spacing ? M.mesh.dz : M.mesh.dx; 
+	LOD_3D_axis_coefficients( M.diffusion_coefficients , M.decay_rates , M.one , substrate_dt , 
+		M.mesh.dx , M.mesh.x_coordinates.size() , M.thomas_constant1x , M.thomas_denomx , M.thomas_cx ); 
+	LOD_3D_axis_coefficients( M.diffusion_coefficients , M.decay_rates , M.one , substrate_dt , 
+		hy , M.mesh.y_coordinates.size() , M.thomas_constant1y , M.thomas_denomy , M.thomas_cy ); 
+	LOD_3D_axis_coefficients( M.diffusion_coefficients , M.decay_rates , M.one , substrate_dt , 
+		hz , M.mesh.z_coordinates.size() , M.thomas_constant1z , M.thomas_denomz , M.thomas_cz ); 
+
+	return; 
+}
+
 void diffusion_decay_solver__constant_coefficients_LOD_3D( Microenvironment& M, double dt )
 {
 	if( M.mesh.regular_mesh == false || M.mesh.Cartesian_mesh == false )
@@ -108,194 +419,1076 @@ void diffusion_decay_solver__constant_coefficients_LOD_3D( Microenvironment& M,
 		std::cout << std::endl << "Using method " << __FUNCTION__ << " (implicit 3-D LOD with Thomas Algorithm) ... " 
 		<< std::endl << std::endl;  
 		
-		M.thomas_denomx.resize( M.mesh.x_coordinates.size() , M.zero );
-		M.thomas_cx.resize( M.mesh.x_coordinates.size() , M.zero );
+		LOD_3D_precompute_coefficients( M , dt ); 
 
-		M.thomas_denomy.resize( M.mesh.y_coordinates.size() , M.zero );
-		M.thomas_cy.resize( M.mesh.y_coordinates.size() , M.zero );
-		
-		M.thomas_denomz.resize( M.mesh.z_coordinates.size() , M.zero );
-		M.thomas_cz.resize( M.mesh.z_coordinates.size() , M.zero );
+		M.diffusion_solver_setup_done = true; 
+	}
+	
+	// x-diffusion 
+	
+	M.apply_dirichlet_conditions();
+	#pragma omp parallel for 
+	for( unsigned int k=0; k < M.mesh.z_coordinates.size() ; k++ )
+	{
+		for( unsigned int j=0; j < M.mesh.y_coordinates.size() ; j++ )
+		{
+			// Thomas solver, x-direction
 
-		M.thomas_i_jump = 1; 
-		M.thomas_j_jump = M.mesh.x_coordinates.size(); 
-		M.thomas_k_jump = M.thomas_j_jump * M.mesh.y_coordinates.size(); 
+			// remaining part of forward elimination, using pre-computed quantities 
+			int n = M.voxel_index(0,j,k);
+			(*M.p_density_vectors)[n] /= M.thomas_denomx[0]; 
 
-		M.thomas_constant1 =  M.diffusion_coefficients; // dt*D/dx^2 
-		M.thomas_constant1a = M.zero; // -dt*D/dx^2; 
-		M.thomas_constant2 =  M.decay_rates; // (1/3)* dt*lambda 
-		M.thomas_constant3 = M.one; // 1 + 2*constant1 + constant2; 
-		M.thomas_constant3a = M.one; // 1 + constant1 + constant2; 		
-			
-		M.thomas_constant1 *= dt; 
-		M.thomas_constant1 /= M.mesh.dx; 
-		M.thomas_constant1 /= M.mesh.dx; 
+			for( unsigned int i=1; i < M.mesh.x_coordinates.size() ; i++ )
+			{
+				n = M.voxel_index(i,j,k); 
+				axpy( &(*M.p_density_vectors)[n] , M.thomas_constant1 , (*M.p_density_vectors)[n-M.thomas_i_jump] ); 
+				(*M.p_density_vectors)[n] /= M.thomas_denomx[i]; 
+			}
 
-		M.thomas_constant1a = M.thomas_constant1; 
-		M.thomas_constant1a *= -1.0; 
+			for( int i = M.mesh.x_coordinates.size()-2 ; i >= 0 ; i-- )
+			{
+				n = M.voxel_index(i,j,k); 
+				naxpy( &(*M.p_density_vectors)[n] , M.thomas_cx[i] , (*M.p_density_vectors)[n+M.thomas_i_jump] ); 
+			}
 
-		M.thomas_constant2 *= dt; 
-		M.thomas_constant2 /= 3.0; // for the LOD splitting of the source 
+		}
+	}
 
-		M.thomas_constant3 += M.thomas_constant1; 
-		M.thomas_constant3 += M.thomas_constant1; 
-		M.thomas_constant3 += M.thomas_constant2; 
+	// y-diffusion 
 
-		M.thomas_constant3a += M.thomas_constant1; 
-		M.thomas_constant3a += M.thomas_constant2; 
+	M.apply_dirichlet_conditions();
+	#pragma omp parallel for 
+	for( unsigned int k=0; k < M.mesh.z_coordinates.size() ; k++ )
+	{
+		for( unsigned int i=0; i < M.mesh.x_coordinates.size() ; i++ )
+		{
+   // Thomas solver, y-direction
 
-		// Thomas solver coefficients 
+	// remaining part of forward elimination, using pre-computed quantities 
 
-		M.thomas_cx.assign( M.mesh.x_coordinates.size() , M.thomas_constant1a ); 
-		M.thomas_denomx.assign( M.mesh.x_coordinates.size()  , M.thomas_constant3 ); 
-		M.thomas_denomx[0] = M.thomas_constant3a; 
-		M.thomas_denomx[ M.mesh.x_coordinates.size()-1 ] = M.thomas_constant3a; 
-		if( M.mesh.x_coordinates.size() == 1 )
-		{ M.thomas_denomx[0] = M.one; M.thomas_denomx[0] += M.thomas_constant2; } 
+	int n = M.voxel_index(i,0,k);
+	(*M.p_density_vectors)[n] /= M.thomas_denomy[0]; 
 
-		M.thomas_cx[0] /= M.thomas_denomx[0]; 
-		for( unsigned int i=1 ; i <= M.mesh.x_coordinates.size()-1 ; i++ )
-		{ 
-			axpy( &M.thomas_denomx[i] , M.thomas_constant1 , M.thomas_cx[i-1] ); 
-			M.thomas_cx[i] /= M.thomas_denomx[i]; // the value at  size-1 is not actually used  
-		}
+	for( unsigned int j=1; j < M.mesh.y_coordinates.size() ; j++ )
+	{
+		n = M.voxel_index(i,j,k); 
+		axpy( &(*M.p_density_vectors)[n] , M.thomas_constant1 , (*M.p_density_vectors)[n-M.thomas_j_jump] ); 
+		(*M.p_density_vectors)[n] /= M.thomas_denomy[j]; 
+	}
 
-		M.thomas_cy.assign( M.mesh.y_coordinates.size() , M.thomas_constant1a ); 
-		M.thomas_denomy.assign( M.mesh.y_coordinates.size()  , M.thomas_constant3 ); 
-		M.thomas_denomy[0] = M.thomas_constant3a; 
-		M.thomas_denomy[ M.mesh.y_coordinates.size()-1 ] = M.thomas_constant3a; 
-		if( M.mesh.y_coordinates.size() == 1 )
-		{ M.thomas_denomy[0] = M.one; M.thomas_denomy[0] += M.thomas_constant2; } 
+	// back substitution 
+	// n = voxel_index( mesh.x_coordinates.size()-2 ,j,k); 
 
-		M.thomas_cy[0] /= M.thomas_denomy[0]; 
-		for( unsigned int i=1 ; i <= M.mesh.y_coordinates.size()-1 ; i++ )
-		{ 
-			axpy( &M.thomas_denomy[i] , M.thomas_constant1 , M.thomas_cy[i-1] ); 
-			M.thomas_cy[i] /= M.thomas_denomy[i]; // the value at  size-1 is not actually used  
-		}
+	for( int j = M.mesh.y_coordinates.size()-2 ; j >= 0 ; j-- )
+	{
+		n = M.voxel_index(i,j,k); 
+		naxpy( &(*M.p_density_vectors)[n] , M.thomas_cy[j] , (*M.p_density_vectors)[n+M.thomas_j_jump] ); 
+	}
 
-		M.thomas_cz.assign( M.mesh.z_coordinates.size() , M.thomas_constant1a ); 
-		M.thomas_denomz.assign( M.mesh.z_coordinates.size()  , M.thomas_constant3 ); 
-		M.thomas_denomz[0] = M.thomas_constant3a; 
-		M.thomas_denomz[ M.mesh.z_coordinates.size()-1 ] = M.thomas_constant3a; 
-		if( M.mesh.z_coordinates.size() == 1 )
-		{ M.thomas_denomz[0] = M.one; M.thomas_denomz[0] += M.thomas_constant2; } 
+  }
+ }
 
-		M.thomas_cz[0] /= M.thomas_denomz[0]; 
-		for( unsigned int i=1 ; i <= M.mesh.z_coordinates.size()-1 ; i++ )
-		{ 
-			axpy( &M.thomas_denomz[i] , M.thomas_constant1 , M.thomas_cz[i-1] ); 
-			M.thomas_cz[i] /= M.thomas_denomz[i]; // the value at  size-1 is not actually used  
-		}	
+ // z-diffusion 
+
+	M.apply_dirichlet_conditions();
+ #pragma omp parallel for 
+ for( unsigned int j=0; j < M.mesh.y_coordinates.size() ; j++ )
+ {
+	 
+  for( unsigned int i=0; i < M.mesh.x_coordinates.size() ; i++ )
+  {
+   // Thomas solver, y-direction
+
+	// remaining part of forward elimination, using pre-computed quantities 
+
+	int n = M.voxel_index(i,j,0);
+	(*M.p_density_vectors)[n] /= M.thomas_denomz[0]; 
+
+	// should be an empty loop if mesh.z_coordinates.size() < 2  
+	for( unsigned int k=1; k < M.mesh.z_coordinates.size() ; k++ )
+	{
+		n = M.voxel_index(i,j,k); 
+		axpy( &(*M.p_density_vectors)[n] , M.thomas_constant1 , (*M.p_density_vectors)[n-M.thomas_k_jump] ); 
+		(*M.p_density_vectors)[n] /= M.thomas_denomz[k]; 
+	}
+
+	// back substitution 
+
+	// should be an empty loop if mesh.z_coordinates.size() < 2 
+	for( int k = M.mesh.z_coordinates.size()-2 ; k >= 0 ; k-- )
+	{
+		n = M.voxel_index(i,j,k); 
+		naxpy( &(*M.p_density_vectors)[n] , M.thomas_cz[k] , (*M.p_density_vectors)[n+M.thomas_k_jump] ); 
+		// n -= i_jump; 
+	}
+  }
+ }
+ 
+	M.apply_dirichlet_conditions();
+	
+	// reset gradient vectors 
+//	M.reset_all_gradient_vectors(); 
+
+	return; 
+}
 
+/* Solve several neighboring tridiagonal lines of one substrate at once, 
+   one line per SIMD lane. Node i of lane l is at pLines[ i*step + l ], 
+   and the nodes of each line are walked row by row. */ 
+
+void batched_thomas_solve( double* pLines , unsigned int step , unsigned int length , unsigned int lanes , 
+	const double* denom , const double* c , double constant1 )
+{
+	BioFVM_simd c1 = BioFVM_simd_set1( constant1 ); 
+	unsigned int vector_lanes = lanes - ( lanes % BioFVM_SIMD_WIDTH ); 
+
+	// remaining part of forward elimination, using pre-computed quantities 
+	
+	BioFVM_simd d = BioFVM_simd_set1( denom[0] ); 
+	for( unsigned int l=0 ; l < vector_lanes ; l += BioFVM_SIMD_WIDTH )
+	{ BioFVM_simd_store( pLines + l , BioFVM_simd_div( BioFVM_simd_load( pLines + l ) , d ) ); }
+	for( unsigned int l=vector_lanes ; l < lanes ; l++ )
+	{ pLines[l] /= denom[0]; }
+
+	for( unsigned int i=1 ; i < length ; i++ )
+	{
+		double* pRow = pLines + i*step; 
+		double* pPrevious = pRow - step; 
+		d = BioFVM_simd_set1( denom[i] ); 
+		for( unsigned int l=0 ; l < vector_lanes ; l += BioFVM_SIMD_WIDTH )
+		{
+			BioFVM_simd v = BioFVM_simd_fmadd( c1 , BioFVM_simd_load( pPrevious + l ) , BioFVM_simd_load( pRow + l ) ); 
+			BioFVM_simd_store( pRow + l , BioFVM_simd_div( v , d ) ); 
+		}
+		for( unsigned int l=vector_lanes ; l < lanes ; l++ )
+		{
+			pRow[l] += constant1 * pPrevious[l]; 
+			pRow[l] /= denom[i]; 
+		}
+	}
+
+	// back substitution 
+	
+	for( int i = length-2 ; i >= 0 ; i-- )
+	{
+		double* pRow = pLines + i*step; 
+		double* pNext = pRow + step; 
+		BioFVM_simd ci = BioFVM_simd_set1( c[i] ); 
+		for( unsigned int l=0 ; l < vector_lanes ; l += BioFVM_SIMD_WIDTH )
+		{ BioFVM_simd_store( pRow + l , BioFVM_simd_fnmadd( ci , BioFVM_simd_load( pNext + l ) , BioFVM_simd_load( pRow + l ) ) ); }
+		for( unsigned int l=vector_lanes ; l < lanes ; l++ )
+		{ pRow[l] -= c[i] * pNext[l]; }
+	}
+
+	return; 
+}
+
+void substrate_thomas_coefficients( std::vector< std::vector<double> >& coefficients , unsigned int substrate_index , 
+	std::vector<double>& output )
+{
+	output.resize( coefficients.size() ); 
+	for( unsigned int i=0 ; i < coefficients.size() ; i++ )
+	{ output[i] = coefficients[i][substrate_index]; }
+	return; 
+}
+
+void diffusion_decay_solver__constant_coefficients_LOD_3D_vectorized( Microenvironment& M, double dt )
+{
+	if( M.mesh.regular_mesh == false || M.mesh.Cartesian_mesh == false )
+	{
+		std::cout << "Error: This algorithm is written for regular Cartesian meshes. Try: other solvers!" << std::endl << std::endl; 
+		return; 
+	}
+
+	// define constants and pre-computed quantities 
+	
+	if( !M.diffusion_solver_setup_done )
+	{
+		std::cout << std::endl << "Using method " << __FUNCTION__ << " (implicit 3-D LOD with Thomas Algorithm, " 
+		<< BioFVM_SIMD_WIDTH << " lines per SIMD batch) ... " << std::endl << std::endl;  
+		
+		LOD_3D_precompute_coefficients( M , dt ); 
+
+		M.diffusion_solver_setup_done = true; 
+		M.thomas_batched_denomx.clear(); 
+	}
+	
+	// one contiguous plane per substrate: lines in y and z are neighbors in memory 
+	
+	Contiguous_Density_Storage& D = M.gather_contiguous_densities( density_storage_substrate_major ); 
+	
+	int nx = M.mesh.x_coordinates.size(); 
+	int ny = M.mesh.y_coordinates.size(); 
+	int nz = M.mesh.z_coordinates.size(); 
+	int nq = D.number_of_densities; 
+	
+	// per-substrate coefficient lines: built once after each setup (or if 
+	// another solver did the setup) 
+	if( M.thomas_batched_denomx.size() != (size_t) nq )
+	{
+		M.thomas_batched_denomx.resize( nq ); 
+		M.thomas_batched_cx.resize( nq ); 
+		M.thomas_batched_denomy.resize( nq ); 
+		M.thomas_batched_cy.resize( nq ); 
+		M.thomas_batched_denomz.resize( nq ); 
+		M.thomas_batched_cz.resize( nq ); 
+		for( int q=0 ; q < nq ; q++ )
+		{
+			substrate_thomas_coefficients( M.thomas_denomx , q , M.thomas_batched_denomx[q] ); 
+			substrate_thomas_coefficients( M.thomas_cx , q , M.thomas_batched_cx[q] ); 
+			substrate_thomas_coefficients( M.thomas_denomy , q , M.thomas_batched_denomy[q] ); 
+			substrate_thomas_coefficients( M.thomas_cy , q , M.thomas_batched_cy[q] ); 
+			substrate_thomas_coefficients( M.thomas_denomz , q , M.thomas_batched_denomz[q] ); 
+			substrate_thomas_coefficients( M.thomas_cz , q , M.thomas_batched_cz[q] ); 
+		}
+	}
+	std::vector< std::vector<double> >& denomx = M.thomas_batched_denomx; 
+	std::vector< std::vector<double> >& cx = M.thomas_batched_cx; 
+	std::vector< std::vector<double> >& denomy = M.thomas_batched_denomy; 
+	std::vector< std::vector<double> >& cy = M.thomas_batched_cy; 
+	std::vector< std::vector<double> >& denomz = M.thomas_batched_denomz; 
+	std::vector< std::vector<double> >& cz = M.thomas_batched_cz; 
+	
+	// x-diffusion: x-lines are contiguous, so batches of them are transposed 
+	// into a small scratch block where each line becomes one SIMD lane 
+
+	const int batch = 4*BioFVM_SIMD_WIDTH; 
+	int number_of_batches = ( ny*nz + batch - 1 ) / batch; 
+	
+	M.apply_dirichlet_conditions( D ); 
+	#pragma omp parallel 
+	{
+		std::vector<double> scratch( nx*batch ); 
+		#pragma omp for 
+		for( int task=0 ; task < nq*number_of_batches ; task++ )
+		{
+			int q = task / number_of_batches; 
+			int first_line = ( task % number_of_batches ) * batch; 
+			int lanes = ny*nz - first_line; 
+			if( lanes > batch )
+			{ lanes = batch; }
+			
+			double* pPlane = D.data() + q*D.substrate_stride + first_line*nx; 
+			for( int l=0 ; l < lanes ; l++ )
+			{
+				for( int i=0 ; i < nx ; i++ )
+				{ scratch[i*lanes+l] = pPlane[l*nx+i]; }
+			}
+			batched_thomas_solve( scratch.data() , lanes , nx , lanes , 
+				denomx[q].data() , cx[q].data() , M.thomas_constant1[q] ); 
+			for( int l=0 ; l < lanes ; l++ )
+			{
+				for( int i=0 ; i < nx ; i++ )
+				{ pPlane[l*nx+i] = scratch[i*lanes+l]; }
+			}
+		}
+	}
+	
+	// y-diffusion: neighboring x positions are the SIMD lanes 
+	
+	M.apply_dirichlet_conditions( D ); 
+	#pragma omp parallel for 
+	for( int task=0 ; task < nq*nz ; task++ )
+	{
+		int q = task / nz; 
+		int k = task % nz; 
+		batched_thomas_solve( D.data() + q*D.substrate_stride + k*nx*ny , nx , ny , nx , 
+			denomy[q].data() , cy[q].data() , M.thomas_constant1[q] ); 
+	}
+	
+	// z-diffusion: one x-row per task, marching through the z-planes 
+
+	M.apply_dirichlet_conditions( D ); 
+	#pragma omp parallel for 
+	for( int task=0 ; task < nq*ny ; task++ )
+	{
+		int q = task / ny; 
+		int j = task % ny; 
+		batched_thomas_solve( D.data() + q*D.substrate_stride + j*nx , nx*ny , nz , nx , 
+			denomz[q].data() , cz[q].data() , M.thomas_constant1[q] ); 
+	}
+	
+	M.apply_dirichlet_conditions( D ); 
+	M.scatter_contiguous_densities(); 
+	
+	return; 
+}
+
+/* Cache-blocked sweeps for the voxel-major storage. A tile is a run of 
+   neighboring x positions (all substrates), so the y- and z-sweeps walk 
+   through memory one contiguous tile-row at a time instead of jumping a 
+   row or a plane per element. The Thomas coefficients are repeated once 
+   per voxel of the tile, so each tile-row is a single unit-stride loop. */ 
+
+const int LOD_tile_voxels = 16; 
+
+void tile_thomas_coefficients( std::vector< std::vector<double> >& coefficients , unsigned int tile_voxels , 
+	std::vector<double>& output )
+{
+	unsigned int nq = coefficients[0].size(); 
+	output.resize( coefficients.size()*tile_voxels*nq ); 
+	for( unsigned int i=0 ; i < coefficients.size() ; i++ )
+	{
+		for( unsigned int v=0 ; v < tile_voxels ; v++ )
+		{
+			for( unsigned int q=0 ; q < nq ; q++ )
+			{ output[ (i*tile_voxels+v)*nq + q ] = coefficients[i][q]; }
+		}
+	}
+	return; 
+}
+
+void tiled_thomas_solve( double* pTile , unsigned int step , unsigned int length , unsigned int width , 
+	unsigned int full_width , const double* denom , const double* c , const double* constant1 )
+{
+	// remaining part of forward elimination, using pre-computed quantities 
+	for( unsigned int l=0 ; l < width ; l++ )
+	{ pTile[l] /= denom[l]; }
+	
+	for( unsigned int i=1 ; i < length ; i++ )
+	{
+		double* pRow = pTile + i*step; 
+		const double* pPrevious = pRow - step; 
+		const double* pDenom = denom + i*full_width; 
+		for( unsigned int l=0 ; l < width ; l++ )
+		{
+			pRow[l] += constant1[l] * pPrevious[l]; 
+			pRow[l] /= pDenom[l]; 
+		}
+	}
+	
+	// back substitution 
+	for( int i = length-2 ; i >= 0 ; i-- )
+	{
+		double* pRow = pTile + i*step; 
+		const double* pNext = pRow + step; 
+		const double* pC = c + i*full_width; 
+		for( unsigned int l=0 ; l < width ; l++ )
+		{ pRow[l] -= pC[l] * pNext[l]; }
+	}
+	
+	return; 
+}
+
+void diffusion_decay_solver__constant_coefficients_LOD_3D_tiled( Microenvironment& M, double dt )
+{
+	if( M.mesh.regular_mesh == false || M.mesh.Cartesian_mesh == false )
+	{
+		std::cout << "Error: This algorithm is written for regular Cartesian meshes. Try: other solvers!" << std::endl << std::endl; 
+		return; 
+	}
+
+	// define constants and pre-computed quantities 
+	
+	if( !M.diffusion_solver_setup_done )
+	{
+		std::cout << std::endl << "Using method " << __FUNCTION__ << " (implicit 3-D LOD with Thomas Algorithm, " 
+		<< LOD_tile_voxels << "-voxel tiles) ... " << std::endl << std::endl;  
+		
+		LOD_3D_precompute_coefficients( M , dt ); 
+
+		M.diffusion_solver_setup_done = true; 
+		M.thomas_tiled_constant1.clear(); 
+	}
+	
+	Contiguous_Density_Storage& D = M.gather_contiguous_densities( density_storage_voxel_major ); 
+	
+	int nx = M.mesh.x_coordinates.size(); 
+	int ny = M.mesh.y_coordinates.size(); 
+	int nz = M.mesh.z_coordinates.size(); 
+	unsigned int nq = D.number_of_densities; 
+	int number_of_tiles = ( nx + LOD_tile_voxels - 1 ) / LOD_tile_voxels; 
+
+	// x-diffusion: x-lines are already contiguous 
+	
+	M.apply_dirichlet_conditions( D ); 
+	#pragma omp parallel for 
+	for( int line=0 ; line < ny*nz ; line++ )
+	{
+		contiguous_thomas_solve( D.data() + line*nx*nq , nq , nx , 1 , nq , 
+			M.thomas_denomx , M.thomas_cx , M.thomas_constant1 ); 
+	}
+	
+	// tile-wide coefficient rows: built once after each setup (or if 
+	// another solver did the setup) 
+	unsigned int full_width = LOD_tile_voxels*nq; 
+	if( M.thomas_tiled_constant1.size() != full_width )
+	{
+		tile_thomas_coefficients( M.thomas_denomy , LOD_tile_voxels , M.thomas_tiled_denomy ); 
+		tile_thomas_coefficients( M.thomas_cy , LOD_tile_voxels , M.thomas_tiled_cy ); 
+		tile_thomas_coefficients( M.thomas_denomz , LOD_tile_voxels , M.thomas_tiled_denomz ); 
+		tile_thomas_coefficients( M.thomas_cz , LOD_tile_voxels , M.thomas_tiled_cz ); 
+		std::vector< std::vector<double> > constant1_row( 1 , M.thomas_constant1 ); 
+		tile_thomas_coefficients( constant1_row , LOD_tile_voxels , M.thomas_tiled_constant1 ); 
+	}
+	std::vector<double>& denomy = M.thomas_tiled_denomy; 
+	std::vector<double>& cy = M.thomas_tiled_cy; 
+	std::vector<double>& denomz = M.thomas_tiled_denomz; 
+	std::vector<double>& cz = M.thomas_tiled_cz; 
+	std::vector<double>& constant1 = M.thomas_tiled_constant1; 
+	
+	// y-diffusion: one tile of neighboring y-lines per task 
+	
+	M.apply_dirichlet_conditions( D ); 
+	#pragma omp parallel for 
+	for( int task=0 ; task < nz*number_of_tiles ; task++ )
+	{
+		int k = task / number_of_tiles; 
+		int i = ( task % number_of_tiles ) * LOD_tile_voxels; 
+		int tile_voxels = std::min( LOD_tile_voxels , nx-i ); 
+		tiled_thomas_solve( D.data() + (k*nx*ny+i)*nq , nx*nq , ny , tile_voxels*nq , full_width , 
+			denomy.data() , cy.data() , constant1.data() ); 
+	}
+	
+	// z-diffusion: one tile of neighboring z-lines per task 
+	
+	M.apply_dirichlet_conditions( D ); 
+	#pragma omp parallel for 
+	for( int task=0 ; task < ny*number_of_tiles ; task++ )
+	{
+		int j = task / number_of_tiles; 
+		int i = ( task % number_of_tiles ) * LOD_tile_voxels; 
+		int tile_voxels = std::min( LOD_tile_voxels , nx-i ); 
+		tiled_thomas_solve( D.data() + (j*nx+i)*nq , nx*ny*nq , nz , tile_voxels*nq , full_width , 
+			denomz.data() , cz.data() , constant1.data() ); 
+	}
+	
+	M.apply_dirichlet_conditions( D ); 
+	M.scatter_contiguous_densities(); 
+	
+	return; 
+}
+
+/* Per-substrate sub-cycling (new in 1.14.3). A substrate with step multiplier 
+   k is solved on every k-th call only, with time step k*dt, so slowly varying 
+   fields do not pay for a full solve every step. Substrates that share k share 
+   their Thomas coefficients: each substrate's entries are the 3-D LOD 
+   coefficients for its own k*dt. On 2-D meshes the z-sweep over a single node 
+   just applies the last third of the decay. 
+   
+   Quasi-static mode: a substrate with a tolerance compares each solution to 
+   the one from its previous sweeps. While the largest change, per step and 
+   relative to the largest density, stays within the tolerance, its factor 
+   doubles (up to the maximum), and of every factor due steps only the last 
+   runs the sweeps. The others add the increment (after minus before) of the 
+   last sweeps. For a settled field under steady sources that increment is 
+   exactly what the sweeps would do, without the splitting error that a 
+   longer time step would add; a faster change resets the factor to 1. */ 
+
+void diffusion_decay_solver__constant_coefficients_LOD_subcycled( Microenvironment& M, double dt )
+{
+	if( M.mesh.regular_mesh == false || M.mesh.Cartesian_mesh == false )
+	{
+		std::cout << "Error: This algorithm is written for regular Cartesian meshes. Try: other solvers!" << std::endl << std::endl; 
+	return; 
+	}
+	
+	unsigned int nq = M.number_of_densities(); 
+	int nv = M.number_of_voxels(); 
+
+	// define constants and pre-computed quantities 
+	
+	if( !M.diffusion_solver_setup_done )
+	{
+		std::cout << std::endl << "Using method " << __FUNCTION__ << " (implicit LOD with Thomas Algorithm, step multipliers"; 
+		std::vector<double> substrate_dt( nq , dt ); 
+		for( unsigned int q=0 ; q < nq ; q++ )
+		{
+			substrate_dt[q] *= M.get_diffusion_step_multiplier( q ); 
+			std::cout << " " << M.density_names[q] << ":" << M.get_diffusion_step_multiplier( q ); 
+			if( M.get_quasi_static_tolerance( q ) > 0.0 )
+			{ std::cout << " (quasi-static to " << M.get_quasi_static_tolerance( q ) << ")"; }
+		}
+		std::cout << ") ... " << std::endl << std::endl; 
+		
+		LOD_3D_precompute_coefficients( M , substrate_dt , true ); 
+		M.diffusion_step_counter = 0; 
+		
+		M.quasi_static_factors.assign( nq , 1 ); 
+		M.quasi_static_skipped_solves.assign( nq , 0 ); 
+		M.quasi_static_steps_since_solve.assign( nq , 0 ); 
+		M.quasi_static_previous_densities.assign( nq , std::vector<double>() ); 
+		M.quasi_static_increments.assign( nq , std::vector<double>() ); 
+
+		M.diffusion_solver_setup_done = true; 
+	}
+	
+	// the substrates whose k steps are complete are either solved or, in 
+	// the quasi-static mode, get their last increment again 
+	
+	M.diffusion_step_counter++; 
+	std::vector<int> due_substrates; 
+	std::vector<int> replayed_substrates; 
+	for( unsigned int q=0 ; q < nq ; q++ )
+	{
+		M.quasi_static_steps_since_solve[q]++; 
+		if( M.diffusion_step_counter % M.get_diffusion_step_multiplier( q ) != 0 )
+		{ continue; }
+		
+		if( M.quasi_static_skipped_solves[q] + 1 < M.quasi_static_factors[q] )
+		{
+			M.quasi_static_skipped_solves[q]++; 
+			replayed_substrates.push_back( q ); 
+		}
+		else
+		{
+			M.quasi_static_skipped_solves[q] = 0; 
+			due_substrates.push_back( q ); 
+		}
+	}
+	
+	for( unsigned int s=0 ; s < replayed_substrates.size() ; s++ )
+	{
+		int q = replayed_substrates[s]; 
+		double* pIncrement = M.quasi_static_increments[q].data(); 
+		#pragma omp parallel for 
+		for( int n=0 ; n < nv ; n++ )
+		{
+			double& value = (*M.p_density_vectors)[n][q]; 
+			value += pIncrement[n]; 
+			if( value < 0.0 )
+			{ value = 0.0; }
+		}
+	}
+	
+	// keep the values before the sweeps for the increments 
+	
+	std::vector<int> quasi_static_substrates; 
+	for( unsigned int s=0 ; s < due_substrates.size() ; s++ )
+	{
+		int q = due_substrates[s]; 
+		if( M.get_quasi_static_tolerance( q ) <= 0.0 )
+		{ continue; }
+		quasi_static_substrates.push_back( q ); 
+		
+		std::vector<double>& increment = M.quasi_static_increments[q]; 
+		increment.resize( nv ); 
+		#pragma omp parallel for 
+		for( int n=0 ; n < nv ; n++ )
+		{ increment[n] = (*M.p_density_vectors)[n][q]; }
+	}
+	
+	if( due_substrates.size() == nq )
+	{ LOD_sweeps_on_contiguous_storage( M , true ); }
+	else if( due_substrates.size() > 0 )
+	{ LOD_sweeps_on_contiguous_storage( M , true , due_substrates ); }
+	
+	// quasi-static mode: new increments, and adapt the factors 
+	
+	for( unsigned int s=0 ; s < quasi_static_substrates.size() ; s++ )
+	{
+		int q = quasi_static_substrates[s]; 
+		std::vector<double>& increment = M.quasi_static_increments[q]; 
+		std::vector<double>& previous = M.quasi_static_previous_densities[q]; 
+		bool first_solve = ( previous.size() != (unsigned int) nv ); 
+		previous.resize( nv , 0.0 ); 
+		
+		double change = 0.0; 
+		double scale = 0.0; 
+		#pragma omp parallel for reduction(max:change) reduction(max:scale)
+		for( int n=0 ; n < nv ; n++ )
+		{
+			double value = (*M.p_density_vectors)[n][q]; 
+			increment[n] = value - increment[n]; 
+			change = std::max( change , fabs( value - previous[n] ) ); 
+			scale = std::max( scale , fabs( value ) ); 
+			previous[n] = value; 
+		}
+		
+		int steps = M.quasi_static_steps_since_solve[q]; 
+		M.quasi_static_steps_since_solve[q] = 0; 
+		if( first_solve )
+		{ continue; }
+		
+		if( change <= M.get_quasi_static_tolerance( q ) * scale * steps )
+		{ M.quasi_static_factors[q] = std::min( 2*M.quasi_static_factors[q] , M.quasi_static_max_factor ); }
+		else
+		{ M.quasi_static_factors[q] = 1; }
+	}
+
+	return; 
+}
+
+/* Variable-coefficient LOD (new in 1.14.3). Each axis uses its own spacing, 
+   and the diffusion coefficient at a face between two voxels is the harmonic 
+   mean of theirs, which keeps the flux continuous across jumps in the field. 
+   For every line, the Thomas denominators and (scaled) upper coefficients 
+   are precomputed, at [axis][ voxel*substrates + substrate ]. Without a 
+   voxel field every line of an axis is the same, so only one is stored. 
+   Axes with a single voxel are skipped, and the decay is split evenly over 
+   the remaining sweeps. */ 
+
+double variable_LOD_face_coefficient( double D1 , double D2 )
+{
+	if( D1 == D2 )
+	{ return D1; }
+	if( D1 + D2 <= 0.0 )
+	{ return 0.0; }
+	return 2.0*D1*D2 / ( D1 + D2 ); 
+}
+
+void LOD_variable_precompute_coefficients( Microenvironment& M, double dt )
+{
+	int n_axis[3] = { (int) M.mesh.x_coordinates.size() , (int) M.mesh.y_coordinates.size() , (int) M.mesh.z_coordinates.size() }; 
+	double h[3] = { M.mesh.dx , M.mesh.dy , M.mesh.dz }; 
+	int jump[3] = { 1 , n_axis[0] , n_axis[0]*n_axis[1] }; 
+	int nq = M.number_of_densities(); 
+	bool field = M.uses_variable_diffusion_coefficients(); 
+	
+	int sweeps = 0; 
+	for( int a=0 ; a < 3 ; a++ )
+	{
+		if( n_axis[a] > 1 )
+		{ sweeps++; }
+	}
+	if( sweeps == 0 )
+	{ sweeps = 1; }
+	
+	M.variable_thomas_denom.assign( 3 , std::vector<double>() ); 
+	M.variable_thomas_c.assign( 3 , std::vector<double>() ); 
+	
+	for( int a=0 ; a < 3 ; a++ )
+	{
+		// the x-axis of a single voxel still carries the decay 
+		if( n_axis[a] == 1 && !( a == 0 && n_axis[1] == 1 && n_axis[2] == 1 ) )
+		{ continue; }
+		
+		int length = n_axis[a]; 
+		int lines = field ? M.number_of_voxels() / length : 1; 
+		std::vector<double>& denom = M.variable_thomas_denom[a]; 
+		std::vector<double>& c = M.variable_thomas_c[a]; 
+		denom.assign( ( field ? M.number_of_voxels() : length )*nq , 0.0 ); 
+		c.assign( denom.size() , 0.0 ); 
+		double scale = dt / ( h[a]*h[a] ); 
+		
+		#pragma omp parallel for 
+		for( int line=0 ; line < lines ; line++ )
+		{
+			// first voxel of the line 
+			int n0 = 0; 
+			if( a == 0 )
+			{ n0 = line*length; }
+			if( a == 1 )
+			{ n0 = (line / n_axis[0])*n_axis[0]*n_axis[1] + line % n_axis[0]; }
+			if( a == 2 )
+			{ n0 = line; }
+			
+			for( int q=0 ; q < nq ; q++ )
+			{
+				double decay = dt * M.decay_rates[q] / sweeps; 
+				double previous_c = 0.0; 
+				for( int i=0 ; i < length ; i++ )
+				{
+					int n = n0 + i*jump[a]; 
+					// coefficients of a field-free axis are stored as one line 
+					int m = field ? n : i; 
+					double r_minus = 0.0; 
+					double r_plus = 0.0; 
+					if( i > 0 )
+					{ r_minus = scale * variable_LOD_face_coefficient( M.get_diffusion_coefficient( n-jump[a] , q ) , M.get_diffusion_coefficient( n , q ) ); }
+					if( i < length-1 )
+					{ r_plus = scale * variable_LOD_face_coefficient( M.get_diffusion_coefficient( n , q ) , M.get_diffusion_coefficient( n+jump[a] , q ) ); }
+					
+					// eliminate the lower coefficient (-r_minus) with the previous row 
+					double d = 1.0 + r_minus + r_plus + decay + r_minus * previous_c; 
+					denom[m*nq+q] = d; 
+					c[m*nq+q] = -r_plus / d; 
+					previous_c = c[m*nq+q]; 
+				}
+			}
+		}
+	}
+	
+	M.variable_thomas_dt = dt; 
+	M.variable_thomas_setup_done = true; 
+	return; 
+}
+
+/* One line of the variable-coefficient LOD solver on voxel-major storage: 
+   voxels are step doubles apart, their coefficients coefficient_step doubles 
+   apart. The lower coefficient of row i is -r_minus = c[i-1]*denom[i-1]. */ 
+
+void variable_thomas_solve( double* pLine , unsigned int step , unsigned int length , unsigned int number_of_densities , 
+	const double* denom , const double* c , unsigned int coefficient_step )
+{
+	unsigned int nq = number_of_densities; 
+	
+	// forward elimination 
+	for( unsigned int q=0 ; q < nq ; q++ )
+	{ pLine[q] /= denom[q]; }
+	
+	for( unsigned int i=1 ; i < length ; i++ )
+	{
+		double* pV = pLine + i*step; 
+		const double* pPrevious = pV - step; 
+		const double* pDenom = denom + i*coefficient_step; 
+		const double* pPreviousDenom = pDenom - coefficient_step; 
+		const double* pPreviousC = c + (i-1)*coefficient_step; 
+		for( unsigned int q=0 ; q < nq ; q++ )
+		{ pV[q] = ( pV[q] - pPreviousC[q] * pPreviousDenom[q] * pPrevious[q] ) / pDenom[q]; }
+	}
+	
+	// back substitution 
+	for( int i = length-2 ; i >= 0 ; i-- )
+	{
+		double* pV = pLine + i*step; 
+		const double* pNext = pV + step; 
+		const double* pC = c + i*coefficient_step; 
+		for( unsigned int q=0 ; q < nq ; q++ )
+		{ pV[q] -= pC[q] * pNext[q]; }
+	}
+	
+	return; 
+}
+
+void diffusion_decay_solver__variable_coefficients_LOD_3D( Microenvironment& M, double dt )
+{
+	if( M.mesh.regular_mesh == false || M.mesh.Cartesian_mesh == false )
+	{
+		std::cout << "Error: This algorithm is written for regular Cartesian meshes. Try: other solvers!" << std::endl << std::endl; 
+		return; 
+	}
+	
+	if( !M.variable_thomas_setup_done || dt != M.variable_thomas_dt || M.variable_thomas_denom.size() != 3 )
+	{
+		if( !M.diffusion_solver_setup_done )
+		{
+			std::cout << std::endl << "Using method " << __FUNCTION__ << " (implicit LOD with Thomas Algorithm, " 
+				<< "dx = " << M.mesh.dx << " dy = " << M.mesh.dy << " dz = " << M.mesh.dz 
+				<< ( M.uses_variable_diffusion_coefficients() ? ", voxel diffusion coefficients" : "" ) << ") ... " 
+				<< std::endl << std::endl; 
+			M.diffusion_solver_setup_done = true; 
+		}
+		LOD_variable_precompute_coefficients( M , dt ); 
+	}
+	
+	Contiguous_Density_Storage& D = M.gather_contiguous_densities( density_storage_voxel_major ); 
+	double* pData = D.data(); 
+	
+	int n_axis[3] = { (int) M.mesh.x_coordinates.size() , (int) M.mesh.y_coordinates.size() , (int) M.mesh.z_coordinates.size() }; 
+	int jump[3] = { 1 , n_axis[0] , n_axis[0]*n_axis[1] }; 
+	unsigned int nq = D.number_of_densities; 
+	bool field = M.uses_variable_diffusion_coefficients(); 
+	
+	for( int a=0 ; a < 3 ; a++ )
+	{
+		if( M.variable_thomas_denom[a].size() == 0 )
+		{ continue; }
+		
+		int length = n_axis[a]; 
+		int lines = M.number_of_voxels() / length; 
+		const double* denom = M.variable_thomas_denom[a].data(); 
+		const double* c = M.variable_thomas_c[a].data(); 
+		unsigned int coefficient_step = field ? jump[a]*nq : nq; 
+		
+		M.apply_dirichlet_conditions( D ); 
+		#pragma omp parallel for 
+		for( int line=0 ; line < lines ; line++ )
+		{
+			int n0 = line*length; 
+			if( a == 1 )
+			{ n0 = (line / n_axis[0])*n_axis[0]*n_axis[1] + line % n_axis[0]; }
+			if( a == 2 )
+			{ n0 = line; }
+			
+			unsigned int offset = field ? n0*nq : 0; 
+			variable_thomas_solve( pData + n0*nq , jump[a]*nq , length , nq , 
+				denom + offset , c + offset , coefficient_step ); 
+		}
+	}
+	
+	M.apply_dirichlet_conditions( D ); 
+	M.scatter_contiguous_densities(); 
+	return; 
+}
+
+/* Active-region LOD (new in 1.14.3). The mesh is cut into tiles of 
+   tile_size^3 voxels. A tile is swept if it holds an agent of M, changed by 
+   more than the tolerance when it was last swept, or touches such a tile 
+   (across a face, an edge, or a corner), so the active region grows by at 
+   most one tile per step. The first step, and every refresh_interval-th 
+   step, sweep all tiles. Each line is only solved on its runs of active 
+   voxels, with the voxels just outside a run held at their current values: 
+   the settled far field acts as a Dirichlet condition on the active region. 
+   With every tile active, this is the usual 3-D (or 2-D) LOD step. */ 
+
+void active_region_thomas_solve( std::vector< std::vector<double> >& u , int first_voxel , int jump , 
+	int start , int end , int length , std::vector<double>& constant1 , std::vector<double>& constant2 , 
+	double* inverse )
+{
+	int nq = constant1.size(); 
+	
+	// forward elimination, with the (held) voxels next to the run on the right-hand side 
+	for( int i=start ; i <= end ; i++ )
+	{
+		std::vector<double>& ui = u[ first_voxel + i*jump ]; 
+		double* pInverse = inverse + (i-start)*nq; 
+		for( int q=0 ; q < nq ; q++ )
+		{
+			double c1 = constant1[q]; 
+			double b = 1.0 + constant2[q]; 
+			if( i > 0 )
+			{ b += c1; }
+			if( i < length-1 )
+			{ b += c1; }
+			
+			double rhs = ui[q]; 
+			if( i > 0 )
+			{ rhs += c1 * u[ first_voxel + (i-1)*jump ][q]; }
+			if( i == end && end < length-1 )
+			{ rhs += c1 * u[ first_voxel + (i+1)*jump ][q]; }
+			if( i > start )
+			{ b -= c1 * c1 * pInverse[q-nq]; }
+			
+			pInverse[q] = 1.0 / b; 
+			ui[q] = rhs * pInverse[q]; 
+		}
+	}
+	
+	// back substitution 
+	for( int i=end-1 ; i >= start ; i-- )
+	{
+		std::vector<double>& ui = u[ first_voxel + i*jump ]; 
+		std::vector<double>& next = u[ first_voxel + (i+1)*jump ]; 
+		const double* pInverse = inverse + (i-start)*nq; 
+		for( int q=0 ; q < nq ; q++ )
+		{ ui[q] += constant1[q] * pInverse[q] * next[q]; }
+	}
+	
+	return; 
+}
+
+void diffusion_decay_solver__constant_coefficients_LOD_active_region( Microenvironment& M, double dt )
+{
+	if( M.mesh.regular_mesh == false || M.mesh.Cartesian_mesh == false )
+	{
+		std::cout << "Error: This algorithm is written for regular Cartesian meshes. Try: other solvers!" << std::endl << std::endl; 
+		return; 
+	}
+	
+	if( !M.diffusion_solver_setup_done )
+	{
+		std::cout << std::endl << "Using method " << __FUNCTION__ << " (implicit LOD with Thomas Algorithm on " 
+			<< M.active_region_tile_size << "^3-voxel tiles, tolerance " << M.active_region_tolerance << ") ... " 
+			<< std::endl << std::endl; 
 		M.diffusion_solver_setup_done = true; 
 	}
-
-	// x-diffusion 
 	
-	M.apply_dirichlet_conditions();
+	std::vector< std::vector<double> >& u = *(M.p_density_vectors); 
+	int n_axis[3] = { (int) M.mesh.x_coordinates.size() , (int) M.mesh.y_coordinates.size() , (int) M.mesh.z_coordinates.size() }; 
+	double h[3] = { M.mesh.dx , M.mesh.dy , M.mesh.dz }; 
+	int jump[3] = { 1 , n_axis[0] , n_axis[0]*n_axis[1] }; 
+	int nq = M.number_of_densities(); 
+	int nv = M.number_of_voxels(); 
+	
+	// axes with a single voxel are not swept (but a single voxel still decays) 
+	bool swept[3]; 
+	int sweeps = 0; 
+	for( int a=0 ; a < 3 ; a++ )
+	{
+		swept[a] = ( n_axis[a] > 1 ); 
+		sweeps += swept[a]; 
+	}
+	if( sweeps == 0 )
+	{ swept[0] = true; sweeps = 1; }
+	
+	// cheap enough to redo each step, so new dt or coefficients are picked up 
+	std::vector<double> constant1[3]; 
+	for( int a=0 ; a < 3 ; a++ )
+	{
+		constant1[a] = M.diffusion_coefficients; 
+		constant1[a] *= dt / ( h[a]*h[a] ); 
+	}
+	std::vector<double> constant2 = M.decay_rates; 
+	constant2 *= dt / sweeps; 
+	
+	// tiles 
+	
+	int ts = M.active_region_tile_size; 
+	M.active_region_tiles_per_axis.resize( 3 ); 
+	int* T = M.active_region_tiles_per_axis.data(); 
+	for( int a=0 ; a < 3 ; a++ )
+	{ T[a] = ( n_axis[a] + ts - 1 ) / ts; }
+	int nt = T[0]*T[1]*T[2]; 
+	
+	bool refresh = ( M.active_region_refresh_interval > 0 && 
+		M.active_region_step_counter % M.active_region_refresh_interval == 0 ); 
+	if( (int) M.active_region_changed.size() != nt || (int) M.active_region_scale.size() != nq )
+	{
+		M.active_region_changed.assign( nt , 1 ); 
+		M.active_region_scale.assign( nq , 0.0 ); 
+		refresh = true; 
+	}
+	M.active_region_step_counter++; 
+	
+	// seed tiles: changed when last swept, or holding one of our agents 
+	std::vector<char> seed = M.active_region_changed; 
+	for( unsigned int i=0 ; i < all_basic_agents.size() ; i++ )
+	{
+		Basic_Agent* pAgent = all_basic_agents[i]; 
+		int n = pAgent->get_current_voxel_index(); 
+		if( pAgent->get_microenvironment() != &M || n < 0 || n >= nv )
+		{ continue; }
+		int I = ( n % n_axis[0] ) / ts; 
+		int J = ( ( n / n_axis[0] ) % n_axis[1] ) / ts; 
+		int K = ( n / jump[2] ) / ts; 
+		seed[ (K*T[1] + J)*T[0] + I ] = 1; 
+	}
+	
+	// active tiles: the seeds and their neighbors 
+	std::vector<char>& active = M.active_region_tiles; 
+	active.assign( nt , 0 ); 
 	#pragma omp parallel for 
-	for( unsigned int k=0; k < M.mesh.z_coordinates.size() ; k++ )
+	for( int t=0 ; t < nt ; t++ )
 	{
-		for( unsigned int j=0; j < M.mesh.y_coordinates.size() ; j++ )
+		if( refresh )
+		{ active[t] = 1; continue; }
+		
+		int I = t % T[0]; 
+		int J = ( t / T[0] ) % T[1]; 
+		int K = t / ( T[0]*T[1] ); 
+		for( int K2 = std::max(K-1,0) ; K2 <= std::min(K+1,T[2]-1) && !active[t] ; K2++ )
 		{
-			// Thomas solver, x-direction
-
-			// remaining part of forward elimination, using pre-computed quantities 
-			int n = M.voxel_index(0,j,k);
-			(*M.p_density_vectors)[n] /= M.thomas_denomx[0]; 
-
-			for( unsigned int i=1; i < M.mesh.x_coordinates.size() ; i++ )
-			{
-				n = M.voxel_index(i,j,k); 
-				axpy( &(*M.p_density_vectors)[n] , M.thomas_constant1 , (*M.p_density_vectors)[n-M.thomas_i_jump] ); 
-				(*M.p_density_vectors)[n] /= M.thomas_denomx[i]; 
-			}
-
-			for( int i = M.mesh.x_coordinates.size()-2 ; i >= 0 ; i-- )
+			for( int J2 = std::max(J-1,0) ; J2 <= std::min(J+1,T[1]-1) && !active[t] ; J2++ )
 			{
-				n = M.voxel_index(i,j,k); 
-				naxpy( &(*M.p_density_vectors)[n] , M.thomas_cx[i] , (*M.p_density_vectors)[n+M.thomas_i_jump] ); 
+				for( int I2 = std::max(I-1,0) ; I2 <= std::min(I+1,T[0]-1) ; I2++ )
+				{
+					if( seed[ (K2*T[1] + J2)*T[0] + I2 ] )
+					{ active[t] = 1; break; }
+				}
 			}
-
 		}
 	}
-
-	// y-diffusion 
-
-	M.apply_dirichlet_conditions();
+	
+	// keep the active densities, to measure each tile's change 
+	
+	std::vector<int> active_tiles; 
+	for( int t=0 ; t < nt ; t++ )
+	{
+		if( active[t] )
+		{ active_tiles.push_back( t ); }
+	}
+	int na = active_tiles.size(); 
+	
+	// one block per active tile only, so a mostly empty domain stays cheap 
+	int tile_capacity = 1; 
+	for( int a=0 ; a < 3 ; a++ )
+	{ tile_capacity *= std::min( ts , n_axis[a] ); }
+	std::vector<double>& previous = M.active_region_previous_densities; 
+	previous.resize( (size_t) na*tile_capacity*nq ); 
+	
+	// the voxels of tile t 
+	#define ACTIVE_REGION_TILE_LOOP( t ) \
+		int I0 = ( (t) % T[0] )*ts; \
+		int J0 = ( ( (t) / T[0] ) % T[1] )*ts; \
+		int K0 = ( (t) / ( T[0]*T[1] ) )*ts; \
+		for( int k=K0 ; k < std::min( K0+ts , n_axis[2] ) ; k++ ) \
+		for( int j=J0 ; j < std::min( J0+ts , n_axis[1] ) ; j++ ) \
+		for( int i=I0 ; i < std::min( I0+ts , n_axis[0] ) ; i++ )
+	
 	#pragma omp parallel for 
-	for( unsigned int k=0; k < M.mesh.z_coordinates.size() ; k++ )
+	for( int m=0 ; m < na ; m++ )
 	{
-		for( unsigned int i=0; i < M.mesh.x_coordinates.size() ; i++ )
+		double* pPrevious = previous.data() + (size_t) m*tile_capacity*nq; 
+		ACTIVE_REGION_TILE_LOOP( active_tiles[m] )
 		{
-   // Thomas solver, y-direction
-
-	// remaining part of forward elimination, using pre-computed quantities 
-
-	int n = M.voxel_index(i,0,k);
-	(*M.p_density_vectors)[n] /= M.thomas_denomy[0]; 
-
-	for( unsigned int j=1; j < M.mesh.y_coordinates.size() ; j++ )
+			int n = k*jump[2] + j*jump[1] + i; 
+			for( int q=0 ; q < nq ; q++ )
+			{ pPrevious[q] = u[n][q]; }
+			pPrevious += nq; 
+		}
+	}
+	
+	// sweeps: each line crosses a row of tiles, and is solved on its runs of active tiles 
+	
+	for( int a=0 ; a < 3 ; a++ )
 	{
-		n = M.voxel_index(i,j,k); 
-		axpy( &(*M.p_density_vectors)[n] , M.thomas_constant1 , (*M.p_density_vectors)[n-M.thomas_j_jump] ); 
-		(*M.p_density_vectors)[n] /= M.thomas_denomy[j]; 
+		if( !swept[a] )
+		{ continue; }
+		
+		// the other two axes 
+		int b = ( a == 0 ) ? 1 : 0; 
+		int c = ( a == 2 ) ? 1 : 2; 
+		int tile_jump[3] = { 1 , T[0] , T[0]*T[1] }; 
+		
+		M.apply_dirichlet_conditions(); 
+		#pragma omp parallel for schedule(dynamic)
+		for( int row=0 ; row < T[b]*T[c] ; row++ )
+		{
+			int B = row % T[b]; 
+			int C = row / T[b]; 
+			int first_tile = B*tile_jump[b] + C*tile_jump[c]; 
+			
+			bool any = false; 
+			for( int A=0 ; A < T[a] && !any ; A++ )
+			{ any = active[ first_tile + A*tile_jump[a] ]; }
+			if( !any )
+			{ continue; }
+			
+			std::vector<double> inverse( n_axis[a]*nq ); 
+			for( int ic = C*ts ; ic < std::min( (C+1)*ts , n_axis[c] ) ; ic++ )
+			{
+				for( int ib = B*ts ; ib < std::min( (B+1)*ts , n_axis[b] ) ; ib++ )
+				{
+					int first_voxel = ib*jump[b] + ic*jump[c]; 
+					int A = 0; 
+					while( A < T[a] )
+					{
+						if( !active[ first_tile + A*tile_jump[a] ] )
+						{ A++; continue; }
+						int A1 = A; 
+						while( A1+1 < T[a] && active[ first_tile + (A1+1)*tile_jump[a] ] )
+						{ A1++; }
+						
+						active_region_thomas_solve( u , first_voxel , jump[a] , A*ts , 
+							std::min( (A1+1)*ts , n_axis[a] ) - 1 , n_axis[a] , 
+							constant1[a] , constant2 , inverse.data() ); 
+						A = A1+1; 
+					}
+				}
+			}
+		}
 	}
-
-	// back substitution 
-	// n = voxel_index( mesh.x_coordinates.size()-2 ,j,k); 
-
-	for( int j = M.mesh.y_coordinates.size()-2 ; j >= 0 ; j-- )
+	M.apply_dirichlet_conditions(); 
+	
+	// largest change of each active tile, relative to the largest density seen 
+	
+	std::vector<double> change( na*nq , 0.0 ); 
+	std::vector<double> largest( na*nq , 0.0 ); 
+	#pragma omp parallel for 
+	for( int m=0 ; m < na ; m++ )
 	{
-		n = M.voxel_index(i,j,k); 
-		naxpy( &(*M.p_density_vectors)[n] , M.thomas_cy[j] , (*M.p_density_vectors)[n+M.thomas_j_jump] ); 
+		// same voxel order as above 
+		double* pPrevious = previous.data() + (size_t) m*tile_capacity*nq; 
+		ACTIVE_REGION_TILE_LOOP( active_tiles[m] )
+		{
+			int n = k*jump[2] + j*jump[1] + i; 
+			for( int q=0 ; q < nq ; q++ )
+			{
+				change[m*nq+q] = std::max( change[m*nq+q] , fabs( u[n][q] - pPrevious[q] ) ); 
+				largest[m*nq+q] = std::max( largest[m*nq+q] , fabs( u[n][q] ) ); 
+			}
+			pPrevious += nq; 
+		}
 	}
-
-  }
- }
-
- // z-diffusion 
-
-	M.apply_dirichlet_conditions();
- #pragma omp parallel for 
- for( unsigned int j=0; j < M.mesh.y_coordinates.size() ; j++ )
- {
-	 
-  for( unsigned int i=0; i < M.mesh.x_coordinates.size() ; i++ )
-  {
-   // Thomas solver, y-direction
-
-	// remaining part of forward elimination, using pre-computed quantities 
-
-	int n = M.voxel_index(i,j,0);
-	(*M.p_density_vectors)[n] /= M.thomas_denomz[0]; 
-
-	// should be an empty loop if mesh.z_coordinates.size() < 2  
-	for( unsigned int k=1; k < M.mesh.z_coordinates.size() ; k++ )
+	#undef ACTIVE_REGION_TILE_LOOP
+	
+	for( int m=0 ; m < na ; m++ )
 	{
-		n = M.voxel_index(i,j,k); 
-		axpy( &(*M.p_density_vectors)[n] , M.thomas_constant1 , (*M.p_density_vectors)[n-M.thomas_k_jump] ); 
-		(*M.p_density_vectors)[n] /= M.thomas_denomz[k]; 
+		for( int q=0 ; q < nq ; q++ )
+		{ M.active_region_scale[q] = std::max( M.active_region_scale[q] , largest[m*nq+q] ); }
 	}
-
-	// back substitution 
-
-	// should be an empty loop if mesh.z_coordinates.size() < 2 
-	for( int k = M.mesh.z_coordinates.size()-2 ; k >= 0 ; k-- )
+	
+	M.active_region_changed.assign( nt , 0 ); 
+	for( int m=0 ; m < na ; m++ )
 	{
-		n = M.voxel_index(i,j,k); 
-		naxpy( &(*M.p_density_vectors)[n] , M.thomas_cz[k] , (*M.p_density_vectors)[n+M.thomas_k_jump] ); 
-		// n -= i_jump; 
+		for( int q=0 ; q < nq ; q++ )
+		{
+			if( change[m*nq+q] > M.active_region_tolerance * M.active_region_scale[q] )
+			{ M.active_region_changed[ active_tiles[m] ] = 1; }
+		}
 	}
-  }
- }
- 
-	M.apply_dirichlet_conditions();
 	
-	// reset gradient vectors 
-//	M.reset_all_gradient_vectors(); 
-
 	return; 
 }
 
@@ -379,7 +1572,7 @@ void diffusion_decay_solver__constant_coefficients_LOD_2D( Microenvironment& M,
 
 		M.diffusion_solver_setup_done = true; 
 	}
-
+	
 	// set the pointer
 	
 	M.apply_dirichlet_conditions();
@@ -626,4 +1819,355 @@ void diffusion_decay_solver__constant_coefficients_LOD_1D( Microenvironment& M,
 }
 
 
+/* Geometric multigrid (new in 1.14.3). Each substrate solves 
+
+     ( 1/dt + lambda + U(x) ) u - D*Laplacian(u) = u_old/dt + S(x) 
+
+   (without the 1/dt terms for the steady state) on cell-centered grids with 
+   zero-flux outer faces, using V-cycles of red-black Gauss-Seidel, averaging 
+   restriction, and (bi/tri)linear cell-centered prolongation. Dirichlet 
+   voxels are held at their values. */ 
+
+void multigrid_smooth( Multigrid_Level& L , double D , int sweeps )
+{
+	double cx = D / ( L.dx * L.dx ); 
+	double cy = D / ( L.dy * L.dy ); 
+	double cz = D / ( L.dz * L.dz ); 
+	int nx = L.nx; 
+	int ny = L.ny; 
+	int nz = L.nz; 
+	int j_jump = nx; 
+	int k_jump = nx*ny; 
+	double* u = L.solution.data(); 
+	
+	for( int sweep=0 ; sweep < sweeps ; sweep++ )
+	{
+		for( int color=0 ; color < 2 ; color++ )
+		{
+			#pragma omp parallel for 
+			for( int line=0 ; line < ny*nz ; line++ )
+			{
+				int j = line % ny; 
+				int k = line / ny; 
+				for( int i=(j+k+color)%2 ; i < nx ; i += 2 )
+				{
+					int n = line*nx + i; 
+					if( L.fixed[n] )
+					{ continue; }
+					
+					double sum = L.right_hand_side[n]; 
+					double diagonal = L.diagonal[n]; 
+					if( i > 0 ) { sum += cx*u[n-1]; diagonal += cx; }
+					if( i < nx-1 ) { sum += cx*u[n+1]; diagonal += cx; }
+					if( j > 0 ) { sum += cy*u[n-j_jump]; diagonal += cy; }
+					if( j < ny-1 ) { sum += cy*u[n+j_jump]; diagonal += cy; }
+					if( k > 0 ) { sum += cz*u[n-k_jump]; diagonal += cz; }
+					if( k < nz-1 ) { sum += cz*u[n+k_jump]; diagonal += cz; }
+					u[n] = sum / diagonal; 
+				}
+			}
+		}
+	}
+	return; 
+}
+
+// fills L.residual and returns its largest magnitude 
+
+double multigrid_residual( Multigrid_Level& L , double D )
+{
+	double cx = D / ( L.dx * L.dx ); 
+	double cy = D / ( L.dy * L.dy ); 
+	double cz = D / ( L.dz * L.dz ); 
+	int nx = L.nx; 
+	int ny = L.ny; 
+	int nz = L.nz; 
+	int j_jump = nx; 
+	int k_jump = nx*ny; 
+	double* u = L.solution.data(); 
+	
+	double largest = 0.0; 
+	#pragma omp parallel for reduction(max:largest) 
+	for( int line=0 ; line < ny*nz ; line++ )
+	{
+		int j = line % ny; 
+		int k = line / ny; 
+		for( int i=0 ; i < nx ; i++ )
+		{
+			int n = line*nx + i; 
+			if( L.fixed[n] )
+			{ L.residual[n] = 0.0; continue; }
+			
+			double Au = L.diagonal[n]*u[n]; 
+			if( i > 0 ) { Au += cx*( u[n] - u[n-1] ); }
+			if( i < nx-1 ) { Au += cx*( u[n] - u[n+1] ); }
+			if( j > 0 ) { Au += cy*( u[n] - u[n-j_jump] ); }
+			if( j < ny-1 ) { Au += cy*( u[n] - u[n+j_jump] ); }
+			if( k > 0 ) { Au += cz*( u[n] - u[n-k_jump] ); }
+			if( k < nz-1 ) { Au += cz*( u[n] - u[n+k_jump] ); }
+			L.residual[n] = L.right_hand_side[n] - Au; 
+			largest = std::max( largest , fabs( L.residual[n] ) ); 
+		}
+	}
+	return largest; 
+}
+
+/* Coarse cell I holds fine cells 2I and 2I+1 (just I on an axis that is 
+   not coarsened). With coefficients == true, a coarse cell is fixed only if 
+   all of its fine cells are. Its diagonal averages those of the free fine 
+   cells (fixed ones count as 0), each plus its couplings to fixed 
+   neighbors: the corrections vanish there, so on coarser grids the 
+   Dirichlet cells act as extra uptake. Otherwise the fine residual is 
+   averaged into the coarse right-hand side, and the coarse correction 
+   starts at zero. */ 
+
+void multigrid_restrict( Multigrid_Level& F , Multigrid_Level& C , double D , bool coefficients )
+{
+	int x_factor = ( C.nx < F.nx ) ? 2 : 1; 
+	int y_factor = ( C.ny < F.ny ) ? 2 : 1; 
+	int z_factor = ( C.nz < F.nz ) ? 2 : 1; 
+	double cx = D / ( F.dx * F.dx ); 
+	double cy = D / ( F.dy * F.dy ); 
+	double cz = D / ( F.dz * F.dz ); 
+	int j_jump = F.nx; 
+	int k_jump = F.nx*F.ny; 
+	
+	#pragma omp parallel for 
+	for( int line=0 ; line < C.ny*C.nz ; line++ )
+	{
+		int J = line % C.ny; 
+		int K = line / C.ny; 
+		for( int I=0 ; I < C.nx ; I++ )
+		{
+			int N = line*C.nx + I; 
+			double sum = 0.0; 
+			int count = 0; 
+			int fixed_count = 0; 
+			for( int k=K*z_factor ; k < std::min( (K+1)*z_factor , F.nz ) ; k++ )
+			{
+				for( int j=J*y_factor ; j < std::min( (J+1)*y_factor , F.ny ) ; j++ )
+				{
+					for( int i=I*x_factor ; i < std::min( (I+1)*x_factor , F.nx ) ; i++ )
+					{
+						int n = (k*F.ny + j)*F.nx + i; 
+						count++; 
+						if( coefficients == false )
+						{ sum += F.residual[n]; continue; }
+						
+						if( F.fixed[n] )
+						{ fixed_count++; continue; }
+						sum += F.diagonal[n]; 
+						if( i > 0 && F.fixed[n-1] ) { sum += cx; }
+						if( i < F.nx-1 && F.fixed[n+1] ) { sum += cx; }
+						if( j > 0 && F.fixed[n-j_jump] ) { sum += cy; }
+						if( j < F.ny-1 && F.fixed[n+j_jump] ) { sum += cy; }
+						if( k > 0 && F.fixed[n-k_jump] ) { sum += cz; }
+						if( k < F.nz-1 && F.fixed[n+k_jump] ) { sum += cz; }
+					}
+				}
+			}
+			
+			if( coefficients )
+			{
+				C.diagonal[N] = sum / count; 
+				C.fixed[N] = ( fixed_count == count ); 
+			}
+			else
+			{
+				C.right_hand_side[N] = sum / count; 
+				C.solution[N] = 0.0; 
+			}
+		}
+	}
+	return; 
+}
+
+// the two coarse cells nearest to fine cell i, and the weight of the first 
+
+void multigrid_interpolation_stencil( int i , int fine_size , int coarse_size , int& I , int& I_neighbor , double& weight )
+{
+	if( coarse_size == fine_size )
+	{
+		I = i; 
+		I_neighbor = i; 
+		weight = 1.0; 
+		return; 
+	}
+	I = i / 2; 
+	I_neighbor = ( i % 2 == 0 ) ? I-1 : I+1; 
+	if( I_neighbor < 0 || I_neighbor >= coarse_size )
+	{ I_neighbor = I; }
+	weight = 0.75; 
+	return; 
+}
+
+void multigrid_prolong_and_correct( Multigrid_Level& C , Multigrid_Level& F )
+{
+	#pragma omp parallel for 
+	for( int line=0 ; line < F.ny*F.nz ; line++ )
+	{
+		int j = line % F.ny; 
+		int k = line / F.ny; 
+		int J , J2 , K , K2 , I , I2; 
+		double wy , wz , wx; 
+		multigrid_interpolation_stencil( j , F.ny , C.ny , J , J2 , wy ); 
+		multigrid_interpolation_stencil( k , F.nz , C.nz , K , K2 , wz ); 
+		
+		const double* c11 = C.solution.data() + (K*C.ny + J)*C.nx; 
+		const double* c21 = C.solution.data() + (K*C.ny + J2)*C.nx; 
+		const double* c12 = C.solution.data() + (K2*C.ny + J)*C.nx; 
+		const double* c22 = C.solution.data() + (K2*C.ny + J2)*C.nx; 
+		double w11 = wy*wz; 
+		double w21 = (1.0-wy)*wz; 
+		double w12 = wy*(1.0-wz); 
+		double w22 = (1.0-wy)*(1.0-wz); 
+		
+		for( int i=0 ; i < F.nx ; i++ )
+		{
+			int n = line*F.nx + i; 
+			if( F.fixed[n] )
+			{ continue; }
+			multigrid_interpolation_stencil( i , F.nx , C.nx , I , I2 , wx ); 
+			double near = w11*c11[I] + w21*c21[I] + w12*c12[I] + w22*c22[I]; 
+			double far = w11*c11[I2] + w21*c21[I2] + w12*c12[I2] + w22*c22[I2]; 
+			F.solution[n] += wx*near + (1.0-wx)*far; 
+		}
+	}
+	return; 
+}
+
+void multigrid_V_cycle( std::vector<Multigrid_Level>& levels , unsigned int l , double D )
+{
+	Multigrid_Level& L = levels[l]; 
+	if( l == levels.size()-1 )
+	{
+		// a few cells at most: smooth to convergence 
+		multigrid_smooth( L , D , 32 ); 
+		return; 
+	}
+	
+	multigrid_smooth( L , D , 2 ); 
+	multigrid_residual( L , D ); 
+	multigrid_restrict( L , levels[l+1] , D , false ); 
+	multigrid_V_cycle( levels , l+1 , D ); 
+	multigrid_prolong_and_correct( levels[l+1] , L ); 
+	multigrid_smooth( L , D , 2 ); 
+	return; 
+}
+
+int multigrid_reaction_diffusion_solve( Microenvironment& M, double dt, std::vector<Basic_Agent*>& basic_agent_list )
+{
+	if( M.mesh.regular_mesh == false || M.mesh.Cartesian_mesh == false )
+	{
+		std::cout << "Error: This algorithm is written for regular Cartesian meshes. Try: other solvers!" << std::endl << std::endl; 
+		return 0; 
+	}
+	
+	int nx = M.mesh.x_coordinates.size(); 
+	int ny = M.mesh.y_coordinates.size(); 
+	int nz = M.mesh.z_coordinates.size(); 
+	int nv = M.number_of_voxels(); 
+	
+	// grid hierarchy: halve each axis until at most 2 cells remain on each 
+	
+	std::vector<Multigrid_Level>& levels = M.multigrid_levels; 
+	if( levels.size() == 0 || levels[0].nx != nx || levels[0].ny != ny || levels[0].nz != nz )
+	{
+		levels.assign( 1 , Multigrid_Level() ); 
+		levels[0].resize( nx , ny , nz , M.mesh.dx , M.mesh.dy , M.mesh.dz ); 
+		while( levels.back().nx > 2 || levels.back().ny > 2 || levels.back().nz > 2 )
+		{
+			Multigrid_Level& F = levels.back(); 
+			Multigrid_Level coarse; 
+			coarse.resize( (F.nx+1)/2 , (F.ny+1)/2 , (F.nz+1)/2 , 
+				F.nx > 1 ? 2.0*F.dx : F.dx , F.ny > 1 ? 2.0*F.dy : F.dy , F.nz > 1 ? 2.0*F.dz : F.dz ); 
+			levels.push_back( coarse ); 
+		}
+	}
+	Multigrid_Level& F = levels[0]; 
+	
+	double one_over_dt = ( dt > 0.0 ) ? 1.0/dt : 0.0; 
+	if( M.dirichlet_indices_are_current == false )
+	{ M.update_dirichlet_indices(); }
+	
+	int most_cycles = 0; 
+	for( unsigned int q=0 ; q < M.number_of_densities() ; q++ )
+	{
+		double D = M.diffusion_coefficients[q]; 
+		
+		#pragma omp parallel for 
+		for( int n=0 ; n < nv ; n++ )
+		{
+			double u = (*M.p_density_vectors)[n][q]; 
+			F.solution[n] = u; 
+			F.right_hand_side[n] = one_over_dt * u; 
+			F.diagonal[n] = one_over_dt + M.decay_rates[q]; 
+			F.fixed[n] = 0; 
+		}
+		
+		// agents: uptake (and the S*u part of secretion) on the diagonal, the rest on the right 
+		for( unsigned int a=0 ; a < basic_agent_list.size() ; a++ )
+		{
+			Basic_Agent* pA = basic_agent_list[a]; 
+			int n = pA->get_current_voxel_index(); 
+			if( pA->is_active == false || n < 0 )
+			{ continue; }
+			
+			double voxel_volume = M.voxels(n).volume; 
+			double volume_ratio = pA->get_total_volume() / voxel_volume; 
+			double S = (*pA->secretion_rates)[q]; 
+			F.diagonal[n] += volume_ratio * ( S + (*pA->uptake_rates)[q] ); 
+			F.right_hand_side[n] += volume_ratio * S * (*pA->saturation_densities)[q] 
+				+ (*pA->net_export_rates)[q] / voxel_volume; 
+		}
+		
+		for( unsigned int d=0 ; d < M.dirichlet_indices.size() ; d++ )
+		{
+			int n = M.dirichlet_indices[d]; 
+			if( M.dirichlet_activation_vectors[n][q] )
+			{
+				F.solution[n] = M.dirichlet_value_vectors[n][q]; 
+				F.fixed[n] = 1; 
+			}
+		}
+		
+		for( unsigned int l=1 ; l < levels.size() ; l++ )
+		{ multigrid_restrict( levels[l-1] , levels[l] , D , true ); }
+		
+		double first_residual = multigrid_residual( F , D ); 
+		double residual = first_residual; 
+		int cycles = 0; 
+		while( residual > M.multigrid_tolerance * first_residual && cycles < M.multigrid_max_cycles )
+		{
+			multigrid_V_cycle( levels , 0 , D ); 
+			residual = multigrid_residual( F , D ); 
+			cycles++; 
+		}
+		most_cycles = std::max( most_cycles , cycles ); 
+		
+		#pragma omp parallel for 
+		for( int n=0 ; n < nv ; n++ )
+		{ (*M.p_density_vectors)[n][q] = F.solution[n]; }
+	}
+	
+	return most_cycles; 
+}
+
+int multigrid_steady_state_solve( Microenvironment& M, std::vector<Basic_Agent*>& basic_agent_list )
+{ return multigrid_reaction_diffusion_solve( M , 0.0 , basic_agent_list ); }
+
+void diffusion_decay_solver__constant_coefficients_multigrid( Microenvironment& M, double dt )
+{
+	if( !M.diffusion_solver_setup_done )
+	{
+		std::cout << std::endl << "Using method " << __FUNCTION__ << " (implicit Euler with geometric multigrid) ... " 
+		<< std::endl << std::endl;  
+		M.diffusion_solver_setup_done = true; 
+	}
+	
+	// sources and sinks stay with the usual split steps 
+	std::vector<Basic_Agent*> no_agents; 
+	multigrid_reaction_diffusion_solve( M , dt , no_agents ); 
+	return; 
+}
+
 };
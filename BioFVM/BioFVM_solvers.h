@@ -60,6 +60,38 @@ void diffusion_decay_solver__constant_coefficients_LOD_3D( Microenvironment& M,
 void diffusion_decay_solver__constant_coefficients_LOD_2D( Microenvironment& M, double dt ); // done
 void diffusion_decay_solver__constant_coefficients_LOD_1D( Microenvironment& M, double dt ); // done
 
+// /*! diffusion-decay solver: 3D LOD implicit, solving batches of lines across SIMD lanes (AVX-512, AVX2, or scalar) */ 
+void diffusion_decay_solver__constant_coefficients_LOD_3D_vectorized( Microenvironment& M, double dt ); 
+// /*! diffusion-decay solver: 3D LOD implicit, with y- and z-sweeps over cache-sized tiles of neighboring lines */ 
+void diffusion_decay_solver__constant_coefficients_LOD_3D_tiled( Microenvironment& M, double dt ); 
+// /*! diffusion-decay solver: 2-D or 3-D LOD implicit, solving each substrate only on every k-th step (new in 1.14.3) */ 
+void diffusion_decay_solver__constant_coefficients_LOD_subcycled( Microenvironment& M, double dt ); 
+// /*! diffusion-decay solver: 1-D, 2-D, or 3-D LOD implicit with separate dx, dy, dz and (optionally) 
+//     per-voxel diffusion coefficients, from precomputed per-line Thomas coefficients (new in 1.14.3) */ 
+void diffusion_decay_solver__variable_coefficients_LOD_3D( Microenvironment& M, double dt ); 
+void LOD_variable_precompute_coefficients( Microenvironment& M, double dt ); 
+// /*! diffusion-decay solver: 2-D or 3-D LOD implicit that only sweeps tiles near agents or recent changes (new in 1.14.3) */ 
+void diffusion_decay_solver__constant_coefficients_LOD_active_region( Microenvironment& M, double dt ); 
+// /*! diffusion-decay solver: 2-D or 3-D fully implicit (backward Euler), solved by geometric multigrid (new in 1.14.3). 
+//     This is meant for steady-state and quasi-static problems (see multigrid_steady_state_solve), not as a 
+//     drop-in time stepper: one step costs 4-5x an LOD step (0.2-0.27x the speed on 32^3 to 48^3 voxels). */ 
+void diffusion_decay_solver__constant_coefficients_multigrid( Microenvironment& M, double dt ); 
+// /*! multigrid (new in 1.14.3): one backward-Euler step of length dt (or, for dt <= 0, the steady state) 
+//     with the uptake and secretion of the listed agents treated implicitly. Returns the most V-cycles used. */ 
+int multigrid_reaction_diffusion_solve( Microenvironment& M, double dt, std::vector<Basic_Agent*>& basic_agent_list ); 
+int multigrid_steady_state_solve( Microenvironment& M, std::vector<Basic_Agent*>& basic_agent_list ); 
+void LOD_3D_precompute_coefficients( Microenvironment& M, double dt ); 
+void LOD_3D_precompute_coefficients( Microenvironment& M, std::vector<double>& substrate_dt ); 
+void LOD_3D_precompute_coefficients( Microenvironment& M, std::vector<double>& substrate_dt, bool axis_spacing ); 
+
+// /*! x-, y- (and z-) sweeps of the LOD solvers on Microenvironment's contiguous density storage (new in 1.14.3) */ 
+void LOD_sweeps_on_contiguous_storage( Microenvironment& M, bool z_sweep ); 
+void LOD_sweeps_on_contiguous_storage( Microenvironment& M, bool z_sweep, std::vector<int>& substrate_indices ); 
+void contiguous_thomas_solve( double* pLine , size_t step , unsigned int length , 
+	size_t substrate_stride , unsigned int number_of_densities , 
+	std::vector< std::vector<double> >& denom , std::vector< std::vector<double> >& c , 
+	std::vector<double>& constant1 , unsigned int first_substrate = 0 ); 
+
 /*! This solves for constant diffusion coefficients on a general mesh using the 
     explicit stepping for the diffusion operator, and implicit stepping for all 
     other terms to increase stability. It is suitable for a general mesh. */ 
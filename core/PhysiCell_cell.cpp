@@ -87,6 +87,7 @@
 
 #include <algorithm>
 #include <iterator> 
+#include <typeinfo> 
 
 namespace PhysiCell{
 
@@ -96,6 +97,22 @@ std::vector<Cell_Definition*> cell_definitions_by_index;
 
 std::unordered_map<std::string,int> cell_definition_indices_by_name; 
 std::unordered_map<int,int> cell_definition_indices_by_type; 
+// the same, as a flat list for the usual small non-negative type IDs, 
+// so hot loops need not hash (new in 1.14.3; -1 for unused IDs) 
+std::vector<int> cell_definition_indices_by_type_list; 
+
+void record_cell_definition_index( int type , int n , int number_of_definitions )
+{
+	cell_definition_indices_by_type[ type ] = n; 
+	// the flat list covers the IDs 0, ..., number_of_definitions-1 (the usual 
+	// numbering). Any other ID is only kept in the map. 
+	if( cell_definition_indices_by_type_list.size() < (size_t) number_of_definitions )
+	{ cell_definition_indices_by_type_list.resize( number_of_definitions , -1 ); }
+	if( type < 0 || type >= number_of_definitions )
+	{ return; }
+	cell_definition_indices_by_type_list[ type ] = n; 
+	return; 
+}
 
 // function pointer on how to choose cell orientation at division
 // in case you want the legacy method 
@@ -104,6 +121,35 @@ std::vector<double> (*cell_division_orientation)(void) = UniformOnUnitSphere; //
 Cell* standard_instantiate_cell()
 { return new Cell; }
 
+std::vector<Cell*> recycled_cells; 
+
+void release_cell( Cell* pCell )
+{
+	// only plain Cell objects: a custom instantiate_cell may return a derived class 
+	if( PhysiCell_settings.enable_cell_recycling == false || typeid(*pCell) != typeid(Cell) )
+	{
+		delete pCell; 
+		return; 
+	}
+	
+	// free the intracellular model now rather than at reuse 
+	if( pCell->phenotype.intracellular )
+	{
+		delete pCell->phenotype.intracellular; 
+		pCell->phenotype.intracellular = NULL; 
+	}
+	recycled_cells.push_back( pCell ); 
+	return; 
+}
+
+void clear_recycled_cells( void )
+{
+	for( int i=0; i < recycled_cells.size(); i++ )
+	{ delete recycled_cells[i]; }
+	recycled_cells.clear(); 
+	return; 
+}
+
 Cell_Parameters::Cell_Parameters()
 {
 	o2_hypoxic_threshold = 15.0; // HIF-1alpha at half-max around 1.5-2%, and tumors often are below 2%
@@ -360,8 +406,25 @@ void Cell::advance_bundled_phenotype_functions( double dt_ )
 	// update integrity 
 	phenotype.cell_integrity.advance_damage( dt_ );  
 	
+	// event-driven phenotype (new in 1.14.3): only cells whose rates nothing 
+	// above can change keep a schedule. Those that are not due, and whose 
+	// schedule is current, skip their death and cycle models. 
+	bool scheduled = PhysiCell_settings.enable_event_driven_phenotype && phenotype_rates_are_static(); 
+	if( scheduled )
+	{
+		bool skip = phenotype_event_due == false && phenotype_event_step >= 0 
+			&& phenotype.cycle.data.schedule_is_current( dt_ ) 
+			&& phenotype.death.schedule_is_current( dt_ ); 
+		phenotype_event_due = false; 
+		if( skip )
+		{
+			phenotype.cycle.data.elapsed_time_in_phase += dt_; 
+			return; 
+		}
+	}
+	
 	// check for new death events 
-	if( phenotype.death.check_for_death( dt_ ) == true )
+	if( phenotype.death.check_for_death( dt_ , scheduled ) == true )
 	{
 		// if so, change the cycle model to the current death model 
 		phenotype.cycle.sync_to_cycle_model( phenotype.death.current_model() ); 
@@ -396,11 +459,77 @@ void Cell::advance_bundled_phenotype_functions( double dt_ )
 		phenotype.flagged_for_division = false; 
 	}
 	
+	if( scheduled )
+	{ schedule_phenotype_event(); }
+	else
+	{ phenotype_event_step = -1; }
+	
+	return; 
+}
+
+bool Cell::phenotype_rates_are_static( void )
+{
+	// a change of cell type or a death starts a new cycle model, which invalidates 
+	// the schedule, so only these can change the rates in place 
+	return PhysiCell_settings.rules_enabled == false && functions.update_phenotype == NULL 
+		&& functions.custom_cell_rule == NULL && functions.contact_function == NULL 
+		&& phenotype.intracellular == NULL; 
+}
+
+void Cell::schedule_phenotype_event( void )
+{
+	int next = phenotype.cycle.data.next_scheduled_step; 
+	int death_step = phenotype.death.next_scheduled_step; 
+	if( next < 0 || death_step < 0 )
+	{ next = -1; }
+	else
+	{ next = std::min( next , death_step ); }
+	
+	// due at the next step anyway: evaluate without queueing 
+	if( next <= PhysiCell_globals.phenotype_step + 1 )
+	{
+		phenotype_event_step = -1; 
+		return; 
+	}
+	if( next == phenotype_event_step )
+	{ return; }
+	phenotype_event_step = next; 
+	if( next < INT_MAX )
+	{ get_container()->schedule_phenotype_event( this ); }
 	return; 
 }
 
 Cell::Cell()
 {
+	reset_to_cell_defaults(); 
+	return; 
+}
+
+void Cell::reinitialize( void )
+{
+	// hand the rate vectors back to the agent, as in a new cell, so that the first 
+	// Secretion::prepare_to_advance() links them and syncs the BioFVM volume 
+	if( secretion_rates == &phenotype.secretion.secretion_rates )
+	{
+		secretion_rates = new std::vector<double>(0); 
+		uptake_rates = new std::vector<double>(0); 
+		saturation_densities = new std::vector<double>(0); 
+		net_export_rates = new std::vector<double>(0); 
+	}
+	Basic_Agent::reinitialize(); 
+	
+	reset_to_cell_defaults(); 
+	return; 
+}
+
+void Cell::reset_to_cell_defaults( void )
+{
+	// a recycled cell may still carry state from its previous life 
+	static const Cell_State default_state; 
+	state = default_state; 
+	verlet_neighbors.clear(); 
+	verlet_reference_position.clear(); 
+	
 	// use the cell defaults; 
 	
 	type = cell_defaults.type; 
@@ -419,10 +548,16 @@ Cell::Cell()
 	current_mechanics_voxel_index=-1;
 	
 	updated_current_mechanics_voxel_index = 0;
+	verlet_reference_reach = 0.0; 
+	division_claim = 0; 
+	removal_claim = 0; 
+	phenotype_event_step = -1; 
+	phenotype_event_slot = -1; 
+	phenotype_event_due = false; 
 	
 	is_movable = true;
 	is_out_of_domain = false;
-	displacement.resize(3,0.0); // state? 
+	displacement.assign(3,0.0); // state? 
 	
 	assign_orientation();
 	container = NULL;
@@ -438,6 +573,11 @@ Cell::~Cell()
 //	std::cout << "\tcell destructor " << this << " " << type_name << " at " << position << std::endl;
 //		std::cout << "\t\tattached cells: " << this->state.attached_cells.size() << std::endl << std::endl; 
 	
+	// delete_cell() and delete_cells() set index = -1 once the cell is 
+	// out of all_cells, so only search (O(n)) for cells that were not 
+	if( index < 0 )
+	{ return; }
+	
 	auto result = std::find( std::begin(*all_cells),std::end(*all_cells),this );
 	if( result != std::end(*all_cells) )
 	{
@@ -549,119 +689,10 @@ Cell* Cell::divide( )
 	// phenotype.flagged_for_division = false; 
 	// phenotype.flagged_for_removal = false; 
 	
-	// make sure ot remove adhesions 
-	remove_all_attached_cells(); 
-	remove_all_spring_attachments(); 
-
-	// version 1.10.3: 
-	// conserved quantitites in custom data aer divided in half
-	// so that each daughter cell gets half of the original ;
-	for( int nn = 0 ; nn < custom_data.variables.size() ; nn++ )
-	{
-		if( custom_data.variables[nn].conserved_quantity == true )
-		{ custom_data.variables[nn].value *= 0.5; }
-	}
-	for( int nn = 0 ; nn < custom_data.vector_variables.size() ; nn++ )
-	{
-		if( custom_data.vector_variables[nn].conserved_quantity == true )
-		{ custom_data.vector_variables[nn].value *= 0.5; }
-	}
-
-	
-	Cell* child = create_cell(functions.instantiate_cell);
-	child->copy_data( this );	
-	child->copy_function_pointers(this);
-	child->parameters = parameters;
-	
-	// evenly divide internalized substrates 
-	// if these are not actively tracked, they are zero anyway 
-	*internalized_substrates *= 0.5; 
-	*(child->internalized_substrates) = *internalized_substrates ; 
-	
-	// The following is already performed by create_cell(). JULY 2017 ***
-	// child->register_microenvironment( get_microenvironment() );
-	
-	// randomly place the new agent close to me, accounting for orientation and 
-	// polarity (if assigned)
-		
-	// May 30, 2020: 
-	// Set cell_division_orientation = LegacyRandomOnUnitSphere to 
-	// reproduce this code 
-	/*
-	double temp_angle = 6.28318530717959*UniformRandom();
-	double temp_phi = 3.1415926535897932384626433832795*UniformRandom();
-	
-	double radius= phenotype.geometry.radius;
-	std::vector<double> rand_vec (3, 0.0);
-	
-	rand_vec[0]= cos( temp_angle ) * sin( temp_phi );
-	rand_vec[1]= sin( temp_angle ) * sin( temp_phi );
-	rand_vec[2]= cos( temp_phi );
-	
-	rand_vec = rand_vec- phenotype.geometry.polarity*(rand_vec[0]*state.orientation[0]+ 
-		rand_vec[1]*state.orientation[1]+rand_vec[2]*state.orientation[2])*state.orientation;
-	
-	if( norm(rand_vec) < 1e-16 )
-	{
-		std::cout<<"************ERROR********************"<<std::endl;
-	}
-	normalize( &rand_vec ); 
-	rand_vec *= radius; // multiply direction times the displacement 
-	*/
-	
-	std::vector<double> rand_vec = cell_division_orientation(); 
-	rand_vec = rand_vec- phenotype.geometry.polarity*(rand_vec[0]*state.orientation[0]+ 
-		rand_vec[1]*state.orientation[1]+rand_vec[2]*state.orientation[2])*state.orientation;	
-	rand_vec *= phenotype.geometry.radius;
-
-	child->assign_position(position[0] + rand_vec[0],
-						   position[1] + rand_vec[1],
-						   position[2] + rand_vec[2]);
-						 
-	//change my position to keep the center of mass intact 
-	// and then see if I need to update my voxel index
-	static double negative_one_half = -0.5; 
-	axpy( &position, negative_one_half , rand_vec ); // position = position - 0.5*rand_vec; 
-
-	//If this cell has been moved outside of the boundaries, mark it as such.
-	//(If the child cell is outside of the boundaries, that has been taken care of in the assign_position function.)
-	if( !get_container()->underlying_mesh.is_position_valid(position[0], position[1], position[2]))
-	{
-		is_out_of_domain = true;
-		is_active = false;
-		is_movable = false;
-	}	
-	 
-	update_voxel_in_container();
-	phenotype.volume.divide(); 
-	child->phenotype.volume.divide();
-	child->set_total_volume(child->phenotype.volume.total);
-	set_total_volume(phenotype.volume.total);
-	
-	// child->set_phenotype( phenotype ); 
-	child->phenotype = phenotype; 
-
-    if (child->phenotype.intracellular){
-        child->phenotype.intracellular->start();
-		child->phenotype.intracellular->inherit(this);
-	}
-// #ifdef ADDON_PHYSIDFBA
-// 	child->fba_model = this->fba_model;
-// #endif
-
-
-	// changes for new phenotyp March 2022
-	// state.damage = 0.0; 
-	// phenotype.integrity.damage = 0.0; // leave alone - damage is heritable
-	state.total_attack_time = 0; 
-	// child->state.damage = 0.0; 
-	// child->phenotype.integrity.damage = 0.0; // leave alone - damage is heritable 
-	child->state.total_attack_time = 0.0; 
-
-	if( this->functions.cell_division_function )
-	{ this->functions.cell_division_function( this, child); }
-
-	return child;
+	// a batch of one (new in 1.14.3). See divide_cells() for the steps. 
+	std::vector<Cell*> parents( 1 , this ); 
+	std::vector<Cell*> children = divide_cells( parents ); 
+	return children[0];
 }
 
 bool Cell::assign_position(std::vector<double> new_position)
@@ -936,6 +967,29 @@ void Cell::update_voxel_in_container()
 	return; 
 }
 
+double Cell::mechanics_reach( void )
+{
+	// add_potentials acts on pairs closer than the larger of the summed radii 
+	// and the summed adhesion distances, so this bounds both 
+	return std::max( 1.0 , phenotype.mechanics.relative_maximum_adhesion_distance ) * phenotype.geometry.radius; 
+}
+
+bool Cell::update_mechanics_voxel_index()
+{
+	update_voxel_index();
+	
+	if( updated_current_mechanics_voxel_index == -1 )
+	{
+		current_mechanics_voxel_index = -1;
+		is_out_of_domain = true;
+		is_active = false;
+		return false; 
+	}
+	
+	current_mechanics_voxel_index = updated_current_mechanics_voxel_index;
+	return true; 
+}
+
 void Cell::copy_data(Cell* copy_me)
 {
 	// phenotype=copyMe->phenotype; //it is taken care in set_phenotype
@@ -1069,11 +1123,108 @@ void Cell::add_potentials(Cell* other_agent)
 	return;
 }
 
+void add_pairwise_potentials( Cell* pCell_1 , Cell* pCell_2 , bool update_1 , bool update_2 )
+{
+	// same force as Cell::add_potentials, computed once and applied with 
+	// opposite signs to the cells that are being updated 
+	if( pCell_1 == pCell_2 )
+	{ return; }
+
+	static double simple_pressure_scale = 0.027288820670331; // 12 * (1 - sqrt(pi/(2*sqrt(3))))^2 
+
+	double displacement[3]; 
+	double distance = 0; 
+	for( int i = 0 ; i < 3 ; i++ ) 
+	{ 
+		displacement[i] = pCell_1->position[i] - pCell_2->position[i]; 
+		distance += displacement[i] * displacement[i]; 
+	}
+	distance = std::max(sqrt(distance), 0.00001); 
+	
+	Phenotype& phenotype_1 = pCell_1->phenotype; 
+	Phenotype& phenotype_2 = pCell_2->phenotype; 
+	
+	//Repulsive
+	double R = phenotype_1.geometry.radius + phenotype_2.geometry.radius; 
+	double temp_r; 
+	if( distance > R ) 
+	{
+		temp_r=0;
+	}
+	else
+	{
+		temp_r = -distance; // -d
+		temp_r /= R; // -d/R
+		temp_r += 1.0; // 1-d/R
+		temp_r *= temp_r; // (1-d/R)^2 
+		
+		if( update_1 )
+		{ pCell_1->state.simple_pressure += ( temp_r / simple_pressure_scale ); }
+		if( update_2 )
+		{ pCell_2->state.simple_pressure += ( temp_r / simple_pressure_scale ); }
+	}
+	
+	double effective_repulsion = sqrt( phenotype_1.mechanics.cell_cell_repulsion_strength * phenotype_2.mechanics.cell_cell_repulsion_strength ); 
+	temp_r *= effective_repulsion; 
+	
+	// Adhesive
+	double max_interactive_distance = phenotype_1.mechanics.relative_maximum_adhesion_distance * phenotype_1.geometry.radius + 
+		phenotype_2.mechanics.relative_maximum_adhesion_distance * phenotype_2.geometry.radius;
+		
+	if(distance < max_interactive_distance ) 
+	{	
+		double temp_a = -distance; // -d
+		temp_a /= max_interactive_distance; // -d/S
+		temp_a += 1.0; // 1 - d/S 
+		temp_a *= temp_a; // (1-d/S)^2 
+		
+		int ii = find_cell_definition_index( pCell_1->type ); 
+		int jj = find_cell_definition_index( pCell_2->type ); 
+
+		double adhesion_ii = phenotype_1.mechanics.cell_cell_adhesion_strength * phenotype_1.mechanics.cell_adhesion_affinities[jj]; 
+		double adhesion_jj = phenotype_2.mechanics.cell_cell_adhesion_strength * phenotype_2.mechanics.cell_adhesion_affinities[ii]; 
+
+		double effective_adhesion = sqrt( adhesion_ii*adhesion_jj ); 
+		temp_a *= effective_adhesion; 
+		
+		temp_r -= temp_a;
+
+		if( update_1 )
+		{ pCell_1->state.neighbors.push_back( pCell_2 ); }
+		if( update_2 )
+		{ pCell_2->state.neighbors.push_back( pCell_1 ); }
+	}
+	
+	if( fabs(temp_r) < 1e-16 )
+	{ return; }
+	temp_r /= distance;
+	
+	for( int i = 0 ; i < 3 ; i++ ) 
+	{
+		double force = displacement[i] * temp_r; 
+		if( update_1 )
+		{ pCell_1->velocity[i] += force; }
+		if( update_2 )
+		{ pCell_2->velocity[i] -= force; }
+	}
+	
+	return;
+}
+
 Cell* create_cell( Cell* (*custom_instantiate)())
 {
 	Cell* pNew; 
 	
-	if (custom_instantiate) {
+	if( ( custom_instantiate == NULL || custom_instantiate == standard_instantiate_cell ) 
+		&& recycled_cells.size() > 0 )
+	{
+		// reuse the most recently released cell (new in 1.14.3). Its vectors 
+		// keep their storage, so the copies below mostly do not allocate. 
+		pNew = recycled_cells.back(); 
+		recycled_cells.pop_back(); 
+		pNew->reinitialize(); 
+	}
+	else if (custom_instantiate) {
 		pNew = custom_instantiate();
 	} else {
 		pNew = standard_instantiate_cell();
@@ -1218,8 +1369,9 @@ void delete_cell( int index )
 	
 	// deregister agent in from the agent container
 	pDeleteMe->get_container()->remove_agent(pDeleteMe);
-	// de-allocate (delete) the cell; 
-	delete pDeleteMe; 
+	pDeleteMe->index = -1; // tells ~Cell() that it was removed 
+	// de-allocate (delete) or recycle the cell; 
+	release_cell( pDeleteMe ); 
 
 
 	return; 
@@ -1260,6 +1412,207 @@ void delete_cell( Cell* pDelete )
 	return; 
 }
 
+std::vector<Cell*> divide_cells( std::vector<Cell*>& cells_to_divide )
+{
+	int number_of_divisions = cells_to_divide.size(); 
+	std::vector<Cell*> children( number_of_divisions , NULL ); 
+	if( number_of_divisions == 0 )
+	{ return children; }
+	
+	std::vector< std::vector<double> > offsets( number_of_divisions ); 
+	
+	// allocate the daughters in bulk, without reallocating all_cells 
+	(*all_cells).reserve( (*all_cells).size() + number_of_divisions ); 
+	
+	// serial: everything that touches other cells or draws random numbers, 
+	// in the same order as the one-at-a-time version of Cell::divide() 
+	for( int i=0; i < number_of_divisions; i++ )
+	{
+		Cell* pCell = cells_to_divide[i]; 
+		
+		// make sure ot remove adhesions 
+		pCell->remove_all_attached_cells(); 
+		pCell->remove_all_spring_attachments(); 
+
+		// version 1.10.3: 
+		// conserved quantitites in custom data aer divided in half
+		// so that each daughter cell gets half of the original ;
+		for( int nn = 0 ; nn < pCell->custom_data.variables.size() ; nn++ )
+		{
+			if( pCell->custom_data.variables[nn].conserved_quantity == true )
+			{ pCell->custom_data.variables[nn].value *= 0.5; }
+		}
+		for( int nn = 0 ; nn < pCell->custom_data.vector_variables.size() ; nn++ )
+		{
+			if( pCell->custom_data.vector_variables[nn].conserved_quantity == true )
+			{ pCell->custom_data.vector_variables[nn].value *= 0.5; }
+		}
+		
+		// create_cell() also registers the microenvironment. JULY 2017 ***
+		children[i] = create_cell( pCell->functions.instantiate_cell ); 
+		
+		// randomly place the new agent close to me, accounting for orientation and 
+		// polarity (if assigned)
+		
+		// May 30, 2020: 
+		// Set cell_division_orientation = LegacyRandomOnUnitSphere to 
+		// reproduce the pre-1.7.2 placement 
+		std::vector<double> rand_vec = cell_division_orientation(); 
+		rand_vec = rand_vec- pCell->phenotype.geometry.polarity*(rand_vec[0]*pCell->state.orientation[0]+ 
+			rand_vec[1]*pCell->state.orientation[1]+rand_vec[2]*pCell->state.orientation[2])*pCell->state.orientation;	
+		rand_vec *= pCell->phenotype.geometry.radius;
+		offsets[i] = rand_vec; 
+	}
+	
+	// parallel: copy data from each parent to its daughter 
+	#pragma omp parallel for 
+	for( int i=0; i < number_of_divisions; i++ )
+	{
+		Cell* pCell = cells_to_divide[i]; 
+		Cell* child = children[i]; 
+		
+		child->copy_data( pCell );	
+		child->copy_function_pointers( pCell );
+		child->parameters = pCell->parameters;
+	
+		// evenly divide internalized substrates 
+		// if these are not actively tracked, they are zero anyway 
+		*(pCell->internalized_substrates) *= 0.5; 
+		*(child->internalized_substrates) = *(pCell->internalized_substrates) ; 
+	}
+	
+	// serial: place the cells in the agent grid 
+	static double negative_one_half = -0.5; 
+	for( int i=0; i < number_of_divisions; i++ )
+	{
+		Cell* pCell = cells_to_divide[i]; 
+		Cell* child = children[i]; 
+		std::vector<double>& rand_vec = offsets[i]; 
+		
+		child->assign_position(pCell->position[0] + rand_vec[0],
+							   pCell->position[1] + rand_vec[1],
+							   pCell->position[2] + rand_vec[2]);
+		
+		//change my position to keep the center of mass intact 
+		// and then see if I need to update my voxel index
+		axpy( &(pCell->position), negative_one_half , rand_vec ); // position = position - 0.5*rand_vec; 
+
+		//If this cell has been moved outside of the boundaries, mark it as such.
+		//(If the child cell is outside of the boundaries, that has been taken care of in the assign_position function.)
+		if( !pCell->get_container()->underlying_mesh.is_position_valid(pCell->position[0], pCell->position[1], pCell->position[2]))
+		{
+			pCell->is_out_of_domain = true;
+			pCell->is_active = false;
+			pCell->is_movable = false;
+		}	
+		
+		pCell->update_voxel_in_container();
+		pCell->phenotype.volume.divide(); 
+		child->phenotype.volume.divide();
+		child->set_total_volume(child->phenotype.volume.total);
+		pCell->set_total_volume(pCell->phenotype.volume.total);
+	}
+	
+	// parallel: copy the phenotypes. Phenotype::operator= clones and deletes 
+	// intracellular models (MaBoSS, roadrunner, dFBA), which are not 
+	// reentrant, so copy serially if any are present 
+	bool intracellular_models_present = false; 
+	for( int i=0; i < number_of_divisions; i++ )
+	{
+		if( cells_to_divide[i]->phenotype.intracellular || children[i]->phenotype.intracellular )
+		{ intracellular_models_present = true; break; }
+	}
+	#pragma omp parallel for if( !intracellular_models_present )
+	for( int i=0; i < number_of_divisions; i++ )
+	{
+		Cell* pCell = cells_to_divide[i]; 
+		Cell* child = children[i]; 
+		
+		// child->set_phenotype( phenotype ); 
+		child->phenotype = pCell->phenotype; 
+		
+		// the daughter draws its own event times (new in 1.14.3)
+		child->phenotype.cycle.data.reset_scheduled_transitions(); 
+		child->phenotype.death.reset_scheduled_deaths(); 
+		
+		// changes for new phenotyp March 2022
+		// state.damage = 0.0; 
+		// phenotype.integrity.damage = 0.0; // leave alone - damage is heritable
+		pCell->state.total_attack_time = 0; 
+		child->state.total_attack_time = 0.0; 
+	}
+	
+	// serial: intracellular models and user callbacks 
+	for( int i=0; i < number_of_divisions; i++ )
+	{
+		Cell* pCell = cells_to_divide[i]; 
+		Cell* child = children[i]; 
+
+		if (child->phenotype.intracellular){
+			child->phenotype.intracellular->start();
+			child->phenotype.intracellular->inherit(pCell);
+		}
+
+		if( pCell->functions.cell_division_function )
+		{ pCell->functions.cell_division_function( pCell, child); }
+	}
+	
+	return children; 
+}
+
+void delete_cells( std::vector<Cell*>& cells_to_delete )
+{
+	int number_of_deletions = cells_to_delete.size(); 
+	if( number_of_deletions == 0 )
+	{ return; }
+	
+	// serial: release everything shared with other cells and the microenvironment 
+	for( int i=0; i < number_of_deletions; i++ )
+	{
+		Cell* pDeleteMe = cells_to_delete[i]; 
+		pDeleteMe->remove_all_attached_cells(); 
+		pDeleteMe->remove_all_spring_attachments(); 
+		pDeleteMe->remove_self_from_all_neighbors(); 
+		pDeleteMe->release_internalized_substrates(); 
+	}
+	
+	// one compaction pass: fill each hole from the tail, in the same order 
+	// as delete_cell(), and deregister from the agent container 
+	for( int i=0; i < number_of_deletions; i++ )
+	{
+		Cell* pDeleteMe = cells_to_delete[i]; 
+		int index = pDeleteMe->index; 
+		
+		(*all_cells)[ (*all_cells).size()-1 ]->index=index;
+		(*all_cells)[index] = (*all_cells)[ (*all_cells).size()-1 ];
+		(*all_cells).pop_back();	
+		
+		pDeleteMe->get_container()->remove_agent(pDeleteMe);
+		pDeleteMe->index = -1; // tells ~Cell() that it was removed 
+	}
+	
+	// the recycling pool is shared, so release serially; otherwise, 
+	// de-allocate in parallel 
+	if( PhysiCell_settings.enable_cell_recycling )
+	{
+		for( int i=0; i < number_of_deletions; i++ )
+		{ release_cell( cells_to_delete[i] ); }
+		return; 
+	}
+	// ~Phenotype deletes intracellular models, which are not reentrant 
+	bool intracellular_models_present = false; 
+	for( int i=0; i < number_of_deletions; i++ )
+	{
+		if( cells_to_delete[i]->phenotype.intracellular )
+		{ intracellular_models_present = true; break; }
+	}
+	#pragma omp parallel for if( !intracellular_models_present )
+	for( int i=0; i < number_of_deletions; i++ )
+	{ delete cells_to_delete[i]; }
+	
+	return; 
+}
+
 bool is_neighbor_voxel(Cell* pCell, std::vector<double> my_voxel_center, std::vector<double> other_voxel_center, int other_voxel_index)
 {
 	double max_interactive_distance = pCell->phenotype.mechanics.relative_maximum_adhesion_distance * pCell->phenotype.geometry.radius 
@@ -1686,6 +2039,10 @@ void prebuild_cell_definition_index_maps( void )
 	// Cell_Interactions and Cell_Transformations in the phenotype 
 	// when we set up the cell definitions. 
 	
+	int number_of_definitions = 0; 
+	for( pugi::xml_node count_node = node ; count_node ; count_node = count_node.next_sibling( "cell_definition" ) )
+	{ number_of_definitions++; }
+	
 	int n = 0; 
 	while( node )
 	{
@@ -1698,7 +2055,7 @@ void prebuild_cell_definition_index_maps( void )
 //		cell_definitions_by_type[ pCD->type ] = pCD; 
 		
 		cell_definition_indices_by_name[ type_name ] = n; 
-		cell_definition_indices_by_type[ ID ] = n; 
+		record_cell_definition_index( ID , n , number_of_definitions ); 
 		
 		node = node.next_sibling( "cell_definition" ); 
 		n++; 
@@ -1719,7 +2076,7 @@ void build_cell_definitions_maps( void )
 		cell_definitions_by_type[ pCD->type ] = pCD; 
 		
 		cell_definition_indices_by_name[ pCD->name ] = n; 
-		cell_definition_indices_by_type[ pCD->type ] = n; 
+		record_cell_definition_index( pCD->type , n , cell_definitions_by_index.size() ); 
 	}
 
 	cell_definitions_by_name_constructed = true; 
@@ -3467,10 +3824,10 @@ std::vector<Cell*> find_nearby_cells( Cell* pCell )
 	std::vector<Cell*> neighbors = {}; 
 
 	// First check the neighbors in my current voxel
-	std::vector<Cell*>::iterator neighbor;
-	std::vector<Cell*>::iterator end =
-		pCell->get_container()->agent_grid[pCell->get_current_mechanics_voxel_index()].end();
-	for( neighbor = pCell->get_container()->agent_grid[pCell->get_current_mechanics_voxel_index()].begin(); neighbor != end; ++neighbor)
+	Cell** neighbor;
+	Cell** end;
+	pCell->get_container()->cells_in_voxel( pCell->get_current_mechanics_voxel_index() , neighbor , end ); 
+	for( ; neighbor != end; ++neighbor)
 	{ neighbors.push_back( *neighbor ); }
 
 	std::vector<int>::iterator neighbor_voxel_index;
@@ -3484,8 +3841,8 @@ std::vector<Cell*> find_nearby_cells( Cell* pCell )
 	{
 		if(!is_neighbor_voxel(pCell, pCell->get_container()->underlying_mesh.voxels[pCell->get_current_mechanics_voxel_index()].center, pCell->get_container()->underlying_mesh.voxels[*neighbor_voxel_index].center, *neighbor_voxel_index))
 			continue;
-		end = pCell->get_container()->agent_grid[*neighbor_voxel_index].end();
-		for(neighbor = pCell->get_container()->agent_grid[*neighbor_voxel_index].begin();neighbor != end; ++neighbor)
+		pCell->get_container()->cells_in_voxel( *neighbor_voxel_index , neighbor , end ); 
+		for( ; neighbor != end; ++neighbor)
 		{ neighbors.push_back( *neighbor ); }
 	}
 	
@@ -3497,9 +3854,10 @@ std::vector<Cell*> find_nearby_interacting_cells( Cell* pCell )
 	std::vector<Cell*> neighbors = {}; 
 
 	// First check the neighbors in my current voxel
-	std::vector<Cell*>::iterator neighbor;
-	std::vector<Cell*>::iterator end = pCell->get_container()->agent_grid[pCell->get_current_mechanics_voxel_index()].end();
-	for( neighbor = pCell->get_container()->agent_grid[pCell->get_current_mechanics_voxel_index()].begin(); neighbor != end; ++neighbor)
+	Cell** neighbor;
+	Cell** end;
+	pCell->get_container()->cells_in_voxel( pCell->get_current_mechanics_voxel_index() , neighbor , end ); 
+	for( ; neighbor != end; ++neighbor)
 	{
 		std::vector<double> displacement = (*neighbor)->position - pCell->position; 
 		double distance = norm( displacement ); 
@@ -3520,8 +3878,8 @@ std::vector<Cell*> find_nearby_interacting_cells( Cell* pCell )
 	{
 		if(!is_neighbor_voxel(pCell, pCell->get_container()->underlying_mesh.voxels[pCell->get_current_mechanics_voxel_index()].center, pCell->get_container()->underlying_mesh.voxels[*neighbor_voxel_index].center, *neighbor_voxel_index))
 			continue;
-		end = pCell->get_container()->agent_grid[*neighbor_voxel_index].end();
-		for(neighbor = pCell->get_container()->agent_grid[*neighbor_voxel_index].begin();neighbor != end; ++neighbor)
+		pCell->get_container()->cells_in_voxel( *neighbor_voxel_index , neighbor , end ); 
+		for( ; neighbor != end; ++neighbor)
 		{
 			std::vector<double> displacement = (*neighbor)->position - pCell->position; 
 			double distance = norm( displacement ); 
@@ -3551,6 +3909,10 @@ int find_cell_definition_index( std::string search_string )
 
 int find_cell_definition_index( int search_type )
 {	
+	if( search_type >= 0 && (size_t) search_type < cell_definition_indices_by_type_list.size() && 
+		cell_definition_indices_by_type_list[search_type] > -1 )
+	{ return cell_definition_indices_by_type_list[search_type]; }
+
 	auto search = cell_definition_indices_by_type.find( search_type );
 	// safety first! 
 	if( search != cell_definition_indices_by_type.end() )
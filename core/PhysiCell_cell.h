@@ -167,6 +167,13 @@ class Cell : public Basic_Agent
 	Cell_Container * container;
 	int current_mechanics_voxel_index;
 	int updated_current_mechanics_voxel_index; // keeps the updated voxel index for later adjusting of current voxel index
+	
+	// claimed atomically by Cell_Container::flag_cell_for_division / removal, and 
+	// cleared by Cell_Container::collect_flagged_cells (new in 1.14.3). Use 
+	// flag_for_division() and flag_for_removal() to set them. 
+	int division_claim; 
+	int removal_claim; 
+	friend class Cell_Container; 
 		
  public:
 	std::string type_name; 
@@ -199,6 +206,9 @@ class Cell : public Basic_Agent
 	void die( void ); 
 	void step(double dt);
 	Cell();
+	// the state of a newly constructed cell, for Cell() and recycled cells (new in 1.14.3) 
+	void reset_to_cell_defaults( void ); 
+	void reinitialize( void ); // a recycled cell: Basic_Agent::reinitialize() and the above 
 	
 	virtual ~Cell(); 
 	
@@ -215,6 +225,21 @@ class Cell : public Basic_Agent
 	// mechanics 
 	void update_position( double dt ); //
 	std::vector<double> displacement; // this should be moved to state, or made private  
+	
+	// Verlet neighbor list for mechanics, see Cell_Container::update_verlet_lists (new in 1.14.3) 
+	std::vector<Cell*> verlet_neighbors; 
+	std::vector<double> verlet_reference_position; 
+	double verlet_reference_reach; 
+	double mechanics_reach( void ); // max(1,relative_maximum_adhesion_distance)*radius 
+	
+	// event-driven phenotype, see Cell_Container::mark_due_phenotype_events (new in 1.14.3): 
+	// the phenotype step this cell is queued for (-1: evaluate its cycle and death models 
+	// at every step), its slot in the container's event table, and whether it is due 
+	int phenotype_event_step; 
+	int phenotype_event_slot; 
+	bool phenotype_event_due; 
+	bool phenotype_rates_are_static( void ); 
+	void schedule_phenotype_event( void ); 
 
 	
 	void assign_orientation();  // if set_orientaion is defined, uses it to assign the orientation
@@ -223,6 +248,9 @@ class Cell : public Basic_Agent
 	void copy_function_pointers(Cell*);
 	
 	void update_voxel_in_container(void);
+	// thread-safe part of update_voxel_in_container: updates the voxel indices but 
+	// leaves the container's agent_grid alone. Returns false if the cell left the domain. 
+	bool update_mechanics_voxel_index(void); 
 	void copy_data(Cell *);
 	
 	void ingest_cell( Cell* pCell_to_eat ); // for use in predation, e.g., immune cells 
@@ -258,10 +286,20 @@ Cell* create_cell( Cell_Definition& cd );
 
 void delete_cell( int ); 
 void delete_cell( Cell* ); 
+// batched Cell::divide() and delete_cell() (new in 1.14.3); returns the daughters 
+std::vector<Cell*> divide_cells( std::vector<Cell*>& cells_to_divide ); 
+void delete_cells( std::vector<Cell*>& cells_to_delete ); 
+// with PhysiCell_settings.enable_cell_recycling, deleted (plain) Cell objects 
+// are kept here and reused by create_cell(), vectors and all (new in 1.14.3) 
+extern std::vector<Cell*> recycled_cells; 
+void release_cell( Cell* pCell ); // recycle or delete a cell that is no longer in all_cells 
+void clear_recycled_cells( void ); 
 void save_all_cells_to_matlab( std::string filename ); 
 
 //function to check if a neighbor voxel contains any cell that can interact with me
 bool is_neighbor_voxel(Cell* pCell, std::vector<double> myVoxelCenter, std::vector<double> otherVoxelCenter, int otherVoxelIndex);  
+// Cell::add_potentials for both cells of a pair at once (new in 1.14.3) 
+void add_pairwise_potentials( Cell* pCell_1 , Cell* pCell_2 , bool update_1 , bool update_2 ); 
 
 
 extern std::unordered_map<std::string,Cell_Definition*> cell_definitions_by_name; 
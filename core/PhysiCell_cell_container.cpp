@@ -71,7 +71,8 @@
 #include "PhysiCell_cell.h"
 
 #include <algorithm>
-#include <iterator> 
+#include <iterator>
+#include <functional> 
 
 using namespace BioFVM;
 
@@ -129,9 +130,13 @@ void Cell_Container::update_all_cells(double t, double phenotype_dt_ , double me
 	{
 		if( (*all_cells)[i]->is_out_of_domain == false )
 		{
-			(*all_cells)[i]->phenotype.secretion.advance( (*all_cells)[i], (*all_cells)[i]->phenotype , diffusion_dt_ );
+			(*all_cells)[i]->phenotype.secretion.prepare_to_advance( (*all_cells)[i], (*all_cells)[i]->phenotype , diffusion_dt_ );
 		}
 	}
+	// cells sharing a voxel can't update it concurrently, so BioFVM bins 
+	// them by voxel (out-of-domain cells are inactive and skipped) 
+	if( BioFVM::get_default_microenvironment() )
+	{ BioFVM::get_default_microenvironment()->simulate_cell_sources_and_sinks( diffusion_dt_ ); }
 	
 	//if it is the time for running cell cycle, do it!
 	double time_since_last_cycle= t- last_cell_cycle_time;
@@ -170,6 +175,14 @@ void Cell_Container::update_all_cells(double t, double phenotype_dt_ , double me
 			time_since_last_cycle = phenotype_dt_;
 		}
 		
+		// event-driven phenotype (new in 1.14.3): flag the cells with events due 
+		// at this step. The others may skip their cycle and death models. 
+		if( PhysiCell_settings.enable_event_driven_phenotype )
+		{
+			PhysiCell_globals.phenotype_step++; 
+			mark_due_phenotype_events( PhysiCell_globals.phenotype_step ); 
+		}
+		
 		// new as of 1.2.1 -- bundles cell phenotype parameter update, volume update, geometry update, 
 		// checking for death, and advancing the cell cycle. Not motility, though. (that's in mechanics)
 		#pragma omp parallel for 
@@ -182,14 +195,9 @@ void Cell_Container::update_all_cells(double t, double phenotype_dt_ , double me
 		}
 		
 		// process divides / removes 
-		for( int i=0; i < cells_ready_to_divide.size(); i++ )
-		{
-			cells_ready_to_divide[i]->divide();
-		}
-		for( int i=0; i < cells_ready_to_die.size(); i++ )
-		{	
-			cells_ready_to_die[i]->die();	
-		}
+		collect_flagged_cells(); 
+		divide_cells( cells_ready_to_divide ); 
+		delete_cells( cells_ready_to_die ); 
 		num_divisions_in_current_step+=  cells_ready_to_divide.size();
 		num_deaths_in_current_step+=  cells_ready_to_die.size();
 		
@@ -211,7 +219,7 @@ void Cell_Container::update_all_cells(double t, double phenotype_dt_ , double me
 		// new February 2018 
 		// if we need gradients, compute them
 		if( default_microenvironment_options.calculate_gradients ) 
-		{ microenvironment.compute_all_gradient_vectors();  }
+		{ microenvironment.update_gradient_vectors();  }
 		// end of new in Feb 2018 
 		
 		// perform interactions -- new in June 2020 
@@ -236,10 +244,24 @@ void Cell_Container::update_all_cells(double t, double phenotype_dt_ , double me
 		
 		// update velocities 
 		
+		if( PhysiCell_settings.enable_sorted_cell_list )
+		{
+			build_sorted_cell_list(); 
+			if( PhysiCell_settings.sort_cells_by_voxel )
+			{ sort_all_cells_by_voxel(); }
+		}
+		if( PhysiCell_settings.enable_verlet_lists && !PhysiCell_settings.enable_pairwise_mechanics )
+		{ update_verlet_lists( PhysiCell_settings.verlet_skin ); }
+		
+		if( PhysiCell_settings.enable_pairwise_mechanics )
+		{ pairwise_update_cell_velocities( time_since_last_mechanics ); }
+		
 		#pragma omp parallel for 
 		for( int i=0; i < (*all_cells).size(); i++ )
 		{
 			Cell* pC = (*all_cells)[i]; 
+			if( PhysiCell_settings.enable_pairwise_mechanics && pC->functions.update_velocity == standard_update_cell_velocity )
+			{ continue; } // done in pairwise_update_cell_velocities 
 			if( pC->functions.update_velocity && pC->is_out_of_domain == false && pC->is_movable )
 			{ pC->functions.update_velocity( pC,pC->phenotype,time_since_last_mechanics ); }
 		}
@@ -282,6 +304,9 @@ void Cell_Container::update_all_cells(double t, double phenotype_dt_ , double me
 		// super-critical to performance! clear the "dummy" cells from phagocytosis / fusion
 		// otherwise, comptuational cost increases at polynomial rate VERY fast, as O(10,000) 
 		// dummy cells of size zero are left ot interact mechanically, etc. 
+		// Divisions wait for the next phenotype step, so leave their flags set: 
+		// a flag cleared here could be set again and the cell collected twice. 
+		collect_flagged_cells( false ); 
 		if( cells_ready_to_die.size() > 0 )
 		{
 			/*
@@ -289,8 +314,7 @@ void Cell_Container::update_all_cells(double t, double phenotype_dt_ , double me
 			std::cout << "\t\tClearing " << cells_ready_to_die.size() << " cells ... " << std::endl; 
 			// there might be a lot of "dummy" cells ready for removal. Let's do it. 		
 			*/
-			for( int i=0; i < cells_ready_to_die.size(); i++ )
-			{ cells_ready_to_die[i]->die(); }
+			delete_cells( cells_ready_to_die ); 
 			cells_ready_to_die.clear();
 		}
 		
@@ -305,12 +329,8 @@ void Cell_Container::update_all_cells(double t, double phenotype_dt_ , double me
 			{ pC->update_position(time_since_last_mechanics); }
 		}
 		
-		// When somebody reviews this code, let's add proper braces for clarity!!! 
-		
 		// Update cell indices in the container
-		for( int i=0; i < (*all_cells).size(); i++ )
-			if(!(*all_cells)[i]->is_out_of_domain && (*all_cells)[i]->is_movable)
-				(*all_cells)[i]->update_voxel_in_container();
+		rebin_all_cells(); 
 		last_mechanics_time=t;
 	}
 	
@@ -320,6 +340,8 @@ void Cell_Container::update_all_cells(double t, double phenotype_dt_ , double me
 
 void Cell_Container::register_agent( Cell* agent )
 {
+	sorted_cells_are_current = false; 
+	verlet_lists_are_current = false; 
 	agent_grid[agent->get_current_mechanics_voxel_index()].push_back(agent);
 	return; 
 }
@@ -327,6 +349,67 @@ void Cell_Container::register_agent( Cell* agent )
 void Cell_Container::remove_agent(Cell* agent )
 {
 	remove_agent_from_voxel(agent, agent->get_current_mechanics_voxel_index());
+	
+	// free its event slot; its heap entries are skipped when popped 
+	if( agent->phenotype_event_slot >= 0 )
+	{
+		phenotype_event_cells[ agent->phenotype_event_slot ] = NULL; 
+		free_phenotype_event_slots.push_back( agent->phenotype_event_slot ); 
+		agent->phenotype_event_slot = -1; 
+	}
+	return; 
+}
+
+void Cell_Container::schedule_phenotype_event( Cell* pCell )
+{
+	#pragma omp critical(PhysiCell_phenotype_events)
+	{
+		if( pCell->phenotype_event_slot < 0 )
+		{
+			if( free_phenotype_event_slots.size() > 0 )
+			{
+				pCell->phenotype_event_slot = free_phenotype_event_slots.back(); 
+				free_phenotype_event_slots.pop_back(); 
+				phenotype_event_cells[ pCell->phenotype_event_slot ] = pCell; 
+			}
+			else
+			{
+				pCell->phenotype_event_slot = phenotype_event_cells.size(); 
+				phenotype_event_cells.push_back( pCell ); 
+			}
+		}
+		phenotype_events.push_back( std::make_pair( pCell->phenotype_event_step , pCell->phenotype_event_slot ) ); 
+		std::push_heap( phenotype_events.begin() , phenotype_events.end() , std::greater< std::pair<int,int> >() ); 
+	}
+	return; 
+}
+
+void Cell_Container::mark_due_phenotype_events( int step )
+{
+	// drop the stale entries once they outnumber the cells 
+	if( phenotype_events.size() > 2*(*all_cells).size() + 1024 )
+	{
+		int n = 0; 
+		for( int i=0 ; i < phenotype_events.size() ; i++ )
+		{
+			Cell* pCell = phenotype_event_cells[ phenotype_events[i].second ]; 
+			if( pCell && pCell->phenotype_event_step == phenotype_events[i].first )
+			{ phenotype_events[n++] = phenotype_events[i]; }
+		}
+		phenotype_events.resize( n ); 
+		std::make_heap( phenotype_events.begin() , phenotype_events.end() , std::greater< std::pair<int,int> >() ); 
+	}
+	
+	while( phenotype_events.size() > 0 && phenotype_events.front().first <= step )
+	{
+		Cell* pCell = phenotype_event_cells[ phenotype_events.front().second ]; 
+		// skip entries of deleted cells, and of cells queued for another step since 
+		if( pCell && pCell->phenotype_event_step == phenotype_events.front().first )
+		{ pCell->phenotype_event_due = true; }
+		
+		std::pop_heap( phenotype_events.begin() , phenotype_events.end() , std::greater< std::pair<int,int> >() ); 
+		phenotype_events.pop_back(); 
+	}
 	return; 
 }
 
@@ -335,11 +418,17 @@ void Cell_Container::add_agent_to_outer_voxel(Cell* agent)
 	int escaping_face= find_escaping_face_index(agent);
 	agents_in_outer_voxels[escaping_face].push_back(agent);
 	agent->is_out_of_domain=true;
+	// the escaped cell is still in its neighbors' Verlet lists 
+	verlet_lists_are_current = false; 
 	return; 
 }
 
 void Cell_Container::remove_agent_from_voxel(Cell* agent, int voxel_index)
 {
+	// invalidate even for an out-of-domain cell (voxel -1), which may 
+	// still be in other cells' Verlet lists 
+	sorted_cells_are_current = false; 
+	verlet_lists_are_current = false; 
 	if (voxel_index < 0)
 	{
 		return; 
@@ -360,10 +449,312 @@ void Cell_Container::remove_agent_from_voxel(Cell* agent, int voxel_index)
 
 void Cell_Container::add_agent_to_voxel(Cell* agent, int voxel_index)
 {
+	sorted_cells_are_current = false; 
+	verlet_lists_are_current = false; 
 	agent_grid[voxel_index].push_back(agent); 
 	return; 
 }	
 
+void Cell_Container::rebin_all_cells( void )
+{
+	int number_of_cells = (*all_cells).size(); 
+	int number_of_voxels = agent_grid.size(); 
+	
+	// new voxel indices of the cells that moved (this used to be a serial 
+	// loop of update_voxel_in_container) 
+	cells_leaving_domain.assign( number_of_cells , 0 ); 
+	int cells_changing_voxel = 0; 
+	#pragma omp parallel for reduction(+:cells_changing_voxel)
+	for( int i=0; i < number_of_cells; i++ )
+	{
+		Cell* pC = (*all_cells)[i]; 
+		if( pC->is_out_of_domain || !pC->is_movable )
+		{ continue; }
+		
+		int previous_voxel_index = pC->get_current_mechanics_voxel_index(); 
+		if( pC->update_mechanics_voxel_index() == false )
+		{ cells_leaving_domain[i] = 1; }
+		if( pC->get_current_mechanics_voxel_index() != previous_voxel_index )
+		{ cells_changing_voxel++; }
+	}
+	
+	if( cells_changing_voxel == 0 )
+	{ return; }
+	sorted_cells_are_current = false; 
+	
+	// rare, so serial 
+	for( int i=0; i < number_of_cells; i++ )
+	{
+		if( cells_leaving_domain[i] )
+		{ add_agent_to_outer_voxel( (*all_cells)[i] ); }
+	}
+	
+	// counting sort of the cells into their voxels 
+	voxel_cell_counts.assign( number_of_voxels , 0 ); 
+	#pragma omp parallel for 
+	for( int i=0; i < number_of_cells; i++ )
+	{
+		int n = (*all_cells)[i]->get_current_mechanics_voxel_index(); 
+		if( n >= 0 )
+		{
+			#pragma omp atomic 
+			voxel_cell_counts[n]++; 
+		}
+	}
+	
+	#pragma omp parallel for 
+	for( int n=0; n < number_of_voxels; n++ )
+	{
+		agent_grid[n].resize( voxel_cell_counts[n] ); 
+		voxel_cell_counts[n] = 0; 
+	}
+	
+	#pragma omp parallel for 
+	for( int i=0; i < number_of_cells; i++ )
+	{
+		Cell* pC = (*all_cells)[i]; 
+		int n = pC->get_current_mechanics_voxel_index(); 
+		if( n < 0 )
+		{ continue; }
+		
+		int slot; 
+		#pragma omp atomic capture 
+		slot = voxel_cell_counts[n]++; 
+		agent_grid[n][slot] = pC; 
+	}
+	
+	// the slots above depend on thread timing; list each voxel's cells in 
+	// all_cells order so that neighbor loops are reproducible 
+	#pragma omp parallel for schedule(dynamic,64)
+	for( int n=0; n < number_of_voxels; n++ )
+	{
+		if( agent_grid[n].size() > 1 )
+		{
+			std::sort( agent_grid[n].begin() , agent_grid[n].end() , 
+				[]( Cell* pA , Cell* pB ){ return pA->index < pB->index; } ); 
+		}
+	}
+	
+	return; 
+}
+
+void Cell_Container::build_sorted_cell_list( void )
+{
+	int number_of_voxels = agent_grid.size(); 
+	
+	voxel_offsets.resize( number_of_voxels+1 ); 
+	voxel_offsets[0] = 0; 
+	for( int n=0; n < number_of_voxels; n++ )
+	{ voxel_offsets[n+1] = voxel_offsets[n] + agent_grid[n].size(); }
+	
+	// same order as agent_grid, so that mechanics gives the same result 
+	// with or without the sorted list 
+	sorted_cells.resize( voxel_offsets[number_of_voxels] ); 
+	#pragma omp parallel for 
+	for( int n=0; n < number_of_voxels; n++ )
+	{ std::copy( agent_grid[n].begin() , agent_grid[n].end() , sorted_cells.begin() + voxel_offsets[n] ); }
+	
+	sorted_cells_are_current = true; 
+	return; 
+}
+
+void Cell_Container::sort_all_cells_by_voxel( void )
+{
+	// reorder all_cells to follow the sorted cell list, so that cells handled 
+	// by the same thread are also close in space. Cells that are not in any 
+	// voxel keep their relative order at the end. 
+	int number_of_cells = (*all_cells).size(); 
+	std::vector<Cell*> reordered( sorted_cells ); 
+	for( int i=0; i < number_of_cells; i++ )
+	{
+		if( (*all_cells)[i]->get_current_mechanics_voxel_index() < 0 )
+		{ reordered.push_back( (*all_cells)[i] ); }
+	}
+	if( reordered.size() != number_of_cells )
+	{ return; }
+	
+	#pragma omp parallel for 
+	for( int i=0; i < number_of_cells; i++ )
+	{
+		(*all_cells)[i] = reordered[i]; 
+		(*all_cells)[i]->index = i; 
+	}
+	
+	return; 
+}
+
+inline double verlet_distance_squared( std::vector<double>& p1 , std::vector<double>& p2 )
+{
+	double dx = p1[0]-p2[0]; 
+	double dy = p1[1]-p2[1]; 
+	double dz = p1[2]-p2[2]; 
+	return dx*dx + dy*dy + dz*dz; 
+}
+
+void Cell_Container::update_verlet_lists( double skin )
+{
+	if( verlet_lists_are_current )
+	{
+		// largest distance a cell has moved, plus how much its reach has 
+		// grown, since the last build 
+		double max_drift = 0.0; 
+		#pragma omp parallel for reduction(max:max_drift)
+		for( int i=0; i < (*all_cells).size(); i++ )
+		{
+			Cell* pC = (*all_cells)[i]; 
+			if( pC->is_out_of_domain )
+			{ continue; }
+			double drift = sqrt( verlet_distance_squared( pC->position , pC->verlet_reference_position ) ) 
+				+ std::max( 0.0 , pC->mechanics_reach() - pC->verlet_reference_reach ); 
+			max_drift = std::max( max_drift , drift ); 
+		}
+		if( max_drift <= 0.5*skin )
+		{ return; }
+	}
+	
+	build_verlet_lists( skin ); 
+	return; 
+}
+
+void Cell_Container::build_verlet_lists( double skin )
+{
+	#pragma omp parallel for 
+	for( int i=0; i < (*all_cells).size(); i++ )
+	{
+		Cell* pC = (*all_cells)[i]; 
+		pC->verlet_neighbors.clear(); 
+		pC->verlet_reference_position = pC->position; 
+		pC->verlet_reference_reach = pC->mechanics_reach(); 
+		
+		int voxel_index = pC->get_current_mechanics_voxel_index(); 
+		if( pC->is_out_of_domain || voxel_index < 0 )
+		{ continue; }
+		
+		// same visiting order as standard_update_cell_velocity: own voxel first 
+		std::vector<int>& moore_voxels = underlying_mesh.moore_connected_voxel_indices[voxel_index]; 
+		for( int m=-1; m < (int) moore_voxels.size(); m++ )
+		{
+			Cell** neighbor; 
+			Cell** end; 
+			cells_in_voxel( m < 0 ? voxel_index : moore_voxels[m] , neighbor , end ); 
+			for( ; neighbor != end; ++neighbor )
+			{
+				if( *neighbor == pC )
+				{ continue; }
+				double cutoff = pC->verlet_reference_reach + (*neighbor)->mechanics_reach() + skin; 
+				if( verlet_distance_squared( pC->position , (*neighbor)->position ) < cutoff*cutoff )
+				{ pC->verlet_neighbors.push_back( *neighbor ); }
+			}
+		}
+	}
+	
+	verlet_list_builds++; 
+	verlet_lists_are_current = true; 
+	return; 
+}
+
+inline bool pairwise_in_reach( Cell* pA , Cell* pB , std::vector<double>& reach )
+{
+	// add_potentials does nothing beyond the summed mechanics reaches 
+	double cutoff = reach[pA->index] + reach[pB->index]; 
+	return verlet_distance_squared( pA->position , pB->position ) < cutoff*cutoff; 
+}
+
+void Cell_Container::pairwise_update_cell_velocities( double dt )
+{
+	int number_of_cells = (*all_cells).size(); 
+	
+	if( voxels_by_color.size() == 0 )
+	{
+		voxels_by_color.resize( 27 ); 
+		for( int n=0; n < underlying_mesh.voxels.size(); n++ )
+		{
+			std::vector<unsigned int> ijk = underlying_mesh.cartesian_indices( n ); 
+			voxels_by_color[ (ijk[0]%3) + 3*(ijk[1]%3) + 9*(ijk[2]%3) ].push_back( n ); 
+		}
+	}
+	
+	// the cells that standard_update_cell_velocity would update 
+	std::vector<char>& updated = pairwise_updated_cells; 
+	std::vector<double>& reach = pairwise_cell_reach; 
+	updated.assign( number_of_cells , 0 ); 
+	reach.resize( number_of_cells ); 
+	#pragma omp parallel for 
+	for( int i=0; i < number_of_cells; i++ )
+	{
+		Cell* pC = (*all_cells)[i]; 
+		reach[i] = pC->mechanics_reach(); 
+		if( pC->functions.update_velocity != standard_update_cell_velocity || pC->is_out_of_domain || !pC->is_movable )
+		{ continue; }
+		updated[i] = 1; 
+		
+		if( pC->functions.add_cell_basement_membrane_interactions )
+		{ pC->functions.add_cell_basement_membrane_interactions( pC, pC->phenotype, dt ); }
+		pC->state.simple_pressure = 0.0; 
+		pC->state.neighbors.clear(); 
+	}
+	
+	// each pair once: within a voxel, and from each voxel to the Moore 
+	// neighbors with a larger voxel index 
+	for( int color=0; color < 27; color++ )
+	{
+		std::vector<int>& voxels = voxels_by_color[color]; 
+		#pragma omp parallel for schedule(dynamic,16)
+		for( int v=0; v < voxels.size(); v++ )
+		{
+			int n = voxels[v]; 
+			Cell** first; 
+			Cell** last; 
+			cells_in_voxel( n , first , last ); 
+			if( first == last )
+			{ continue; }
+			
+			for( Cell** pA = first; pA != last; ++pA )
+			{
+				bool update_A = updated[ (*pA)->index ]; 
+				for( Cell** pB = pA+1; pB != last; ++pB )
+				{
+					bool update_B = updated[ (*pB)->index ]; 
+					if( (update_A || update_B) && pairwise_in_reach( *pA , *pB , reach ) )
+					{ add_pairwise_potentials( *pA , *pB , update_A , update_B ); }
+				}
+			}
+			
+			std::vector<int>& moore_voxels = underlying_mesh.moore_connected_voxel_indices[n]; 
+			for( int m=0; m < moore_voxels.size(); m++ )
+			{
+				if( moore_voxels[m] < n )
+				{ continue; }
+				Cell** neighbor_first; 
+				Cell** neighbor_last; 
+				cells_in_voxel( moore_voxels[m] , neighbor_first , neighbor_last ); 
+				for( Cell** pA = first; pA != last; ++pA )
+				{
+					bool update_A = updated[ (*pA)->index ]; 
+					for( Cell** pB = neighbor_first; pB != neighbor_last; ++pB )
+					{
+						bool update_B = updated[ (*pB)->index ]; 
+						if( (update_A || update_B) && pairwise_in_reach( *pA , *pB , reach ) )
+						{ add_pairwise_potentials( *pA , *pB , update_A , update_B ); }
+					}
+				}
+			}
+		}
+	}
+	
+	#pragma omp parallel for 
+	for( int i=0; i < number_of_cells; i++ )
+	{
+		if( updated[i] == 0 )
+		{ continue; }
+		Cell* pC = (*all_cells)[i]; 
+		pC->update_motility_vector( dt ); 
+		pC->velocity += pC->phenotype.motility.motility_vector; 
+	}
+	
+	return; 
+}
+
 bool Cell_Container::contain_any_cell(int voxel_index)
 {
 	// Let's replace this with clearer statements. 
@@ -389,23 +780,63 @@ int find_escaping_face_index(Cell* agent)
 
 void Cell_Container::flag_cell_for_division( Cell* pCell )
 { 
-	#pragma omp critical
+	// lock-free as of 1.14.3: an atomic flag on the cell, gathered later 
+	// by collect_flagged_cells 
+	int already_flagged; 
+	#pragma omp atomic capture
+	{ already_flagged = pCell->division_claim; pCell->division_claim = 1; }
+	if( already_flagged == 0 )
 	{
-		auto result = std::find(std::begin(cells_ready_to_divide), std::end(cells_ready_to_divide), pCell );
-		if( result == std::end(cells_ready_to_divide) )
-		{ cells_ready_to_divide.push_back( pCell ); }
-	} 
+		#pragma omp atomic
+		number_of_cells_flagged_for_division++; 
+	}
 	return; 
 }
 
 void Cell_Container::flag_cell_for_removal( Cell* pCell )
 { 
-	#pragma omp critical
+	int already_flagged; 
+	#pragma omp atomic capture
+	{ already_flagged = pCell->removal_claim; pCell->removal_claim = 1; }
+	if( already_flagged == 0 )
+	{
+		#pragma omp atomic
+		number_of_cells_flagged_for_removal++; 
+	}
+	return; 
+}
+
+void Cell_Container::collect_flagged_cells( bool include_divisions )
+{
+	if( include_divisions == false )
 	{
-		auto result = std::find(std::begin(cells_ready_to_die), std::end(cells_ready_to_die), pCell );
-		if( result == std::end(cells_ready_to_die) )
-		{ cells_ready_to_die.push_back( pCell ); }		
-	} 
+		if( number_of_cells_flagged_for_removal == 0 )
+		{ return; }
+	}
+	else if( number_of_cells_flagged_for_division == 0 && number_of_cells_flagged_for_removal == 0 )
+	{ return; }
+	
+	if( include_divisions )
+	{ cells_ready_to_divide.reserve( cells_ready_to_divide.size() + number_of_cells_flagged_for_division ); }
+	cells_ready_to_die.reserve( cells_ready_to_die.size() + number_of_cells_flagged_for_removal ); 
+	for( int i=0; i < (*all_cells).size(); i++ )
+	{
+		Cell* pC = (*all_cells)[i]; 
+		if( include_divisions && pC->division_claim )
+		{
+			cells_ready_to_divide.push_back( pC ); 
+			pC->division_claim = 0; 
+		}
+		if( pC->removal_claim )
+		{
+			cells_ready_to_die.push_back( pC ); 
+			pC->removal_claim = 0; 
+		}
+	}
+	
+	if( include_divisions )
+	{ number_of_cells_flagged_for_division = 0; }
+	number_of_cells_flagged_for_removal = 0; 
 	return; 
 }
 
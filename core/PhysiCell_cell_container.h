@@ -83,6 +83,10 @@ class Cell_Container : public BioFVM::Agent_Container
  private:	
 	std::vector<Cell*> cells_ready_to_divide; // the index of agents ready to divide
 	std::vector<Cell*> cells_ready_to_die;
+	int number_of_cells_flagged_for_division = 0; 
+	int number_of_cells_flagged_for_removal = 0; 
+	std::vector<int> voxel_cell_counts; // scratch space for rebin_all_cells 
+	std::vector<char> cells_leaving_domain; 
 	int boundary_condition_for_pushed_out_agents; 	// what to do with pushed out cells
 	bool initialzed = false;
 	
@@ -101,6 +105,55 @@ class Cell_Container : public BioFVM::Agent_Container
 	std::vector<std::vector<Cell*> > agent_grid;
 	std::vector<std::vector<Cell*> > agents_in_outer_voxels;
 	
+	// optional compact (CSR) copy of agent_grid, rebuilt each mechanics step 
+	// (new in 1.14.3): the cells of voxel n are sorted_cells[ voxel_offsets[n] ] 
+	// up to sorted_cells[ voxel_offsets[n+1] ]. It goes stale as soon as 
+	// agent_grid changes, and cells_in_voxel falls back to agent_grid. 
+	std::vector<Cell*> sorted_cells; 
+	std::vector<int> voxel_offsets; 
+	bool sorted_cells_are_current = false; 
+	void build_sorted_cell_list( void ); 
+	void sort_all_cells_by_voxel( void ); 
+	
+	// optional Verlet neighbor lists for mechanics (new in 1.14.3): each cell 
+	// lists the cells within the two mechanics reaches plus verlet_skin, and the 
+	// lists are only rebuilt once some cell has moved (or grown) by half the skin 
+	bool verlet_lists_are_current = false; 
+	int verlet_list_builds = 0; 
+	void update_verlet_lists( double skin ); 
+	void build_verlet_lists( double skin ); 
+	
+	// pairwise mechanics (new in 1.14.3): each pair of neighboring cells is visited 
+	// once, for all cells that use standard_update_cell_velocity. Voxels are 
+	// split into 27 colors (i%3,j%3,k%3) so that voxels of one color never write 
+	// to the same cells. 
+	std::vector< std::vector<int> > voxels_by_color; 
+	std::vector<char> pairwise_updated_cells; 
+	std::vector<double> pairwise_cell_reach; 
+	void pairwise_update_cell_velocities( double dt ); 
+	
+	inline void cells_in_voxel( int voxel_index , Cell**& first , Cell**& last )
+	{
+		if( sorted_cells_are_current )
+		{
+			first = sorted_cells.data() + voxel_offsets[voxel_index]; 
+			last = sorted_cells.data() + voxel_offsets[voxel_index+1]; 
+			return; 
+		}
+		first = agent_grid[voxel_index].data(); 
+		last = first + agent_grid[voxel_index].size(); 
+		return; 
+	}
+	
+	// event-driven phenotype (new in 1.14.3): a min-heap of ( phenotype step, slot ) 
+	// pairs, with the cell of each slot in phenotype_event_cells (NULL: free). Entries 
+	// for deleted or rescheduled cells stay in the heap, and are ignored when popped. 
+	std::vector< std::pair<int,int> > phenotype_events; 
+	std::vector<Cell*> phenotype_event_cells; 
+	std::vector<int> free_phenotype_event_slots; 
+	void schedule_phenotype_event( Cell* pCell ); // thread-safe 
+	void mark_due_phenotype_events( int step ); 
+	
 	void update_all_cells(double t);
 	void update_all_cells(double t, double dt);
 	void update_all_cells(double t, double phenotype_dt, double mechanics_dt);
@@ -111,9 +164,14 @@ class Cell_Container : public BioFVM::Agent_Container
 	void remove_agent(Cell* agent );
 	void remove_agent_from_voxel(Cell* agent, int voxel_index);
 	void add_agent_to_voxel(Cell* agent, int voxel_index);
+	// rebuild agent_grid after update_position, in parallel (new in 1.14.3) 
+	void rebin_all_cells( void ); 
 	
 	void flag_cell_for_division( Cell* pCell ); 
 	void flag_cell_for_removal( Cell* pCell ); 
+	// fill cells_ready_to_divide / cells_ready_to_die from the cell flags, in all_cells order. 
+	// With include_divisions = false, division flags stay set for a later call. 
+	void collect_flagged_cells( bool include_divisions = true ); 
 	bool contain_any_cell(int voxel_index);
 };
 
@@ -66,11 +66,14 @@
 */
 
 #include "./PhysiCell_phenotype.h"
+#include "./PhysiCell_cell.h"
 
 #include "../BioFVM/BioFVM.h"
 #include "./PhysiCell_constants.h"
 #include "./PhysiCell_utilities.h"
 
+#include <limits>
+
 using namespace BioFVM; 
 
 namespace PhysiCell{
@@ -100,6 +103,13 @@ Phase_Link::Phase_Link()
 	return; 
 }
 
+Scheduled_Event::Scheduled_Event()
+{
+	rate = -1.0; 
+	step = -1; 
+	return; 
+}
+
 Cycle_Data::Cycle_Data()
 {
 	inverse_index_maps.resize(0); 
@@ -112,9 +122,89 @@ Cycle_Data::Cycle_Data()
 
 	current_phase_index = 0; 
 	elapsed_time_in_phase = 0.0; 
+	
+	scheduled_phase_index = -1; 
+	scheduled_dt = 0.0; 
+	scheduled_events.resize( 0 ); 
+	next_scheduled_step = -1; 
 	return; 
 }
 
+void Cycle_Data::reset_scheduled_transitions( void )
+{
+	scheduled_phase_index = -1; 
+	next_scheduled_step = -1; 
+	return; 
+}
+
+// the schedule is for the current phase, and the same phenotype step 
+bool Cycle_Data::schedule_is_current( double dt )
+{
+	return scheduled_phase_index == current_phase_index 
+		&& fabs( dt - scheduled_dt ) <= 0.001 * dt; 
+}
+
+// event-driven scheduling (new in 1.14.3): the step of events with rate 0 
+static const int never_scheduled = std::numeric_limits<int>::max(); 
+
+// the probability that an event with this rate fires within one phenotype 
+// step: rate*dt as in the default per-step draws, or with 
+// <event_driven_exponential_times>, 1-exp(-rate*dt) for exactly exponential 
+// waiting times 
+static double event_probability_per_step( double rate , double dt )
+{
+	if( PhysiCell_settings.event_driven_exponential_times )
+	{ return -std::expm1( -rate*dt ); }
+	return rate*dt; 
+}
+
+// the phenotype step that an event with per-step probability prob fires on, 
+// counting step now: now plus a geometric number of failed steps, 
+// floor( log(U) / log(1-prob) ), with U uniform in (0,1] 
+static int draw_event_step( int now , double prob )
+{
+	if( prob <= 0.0 )
+	{ return never_scheduled; }
+	if( prob >= 1.0 )
+	{ return now; }
+	double failures = std::floor( std::log( 1.0 - UniformRandom() ) / std::log1p( -prob ) ); 
+	if( failures >= (double) never_scheduled - now )
+	{ return never_scheduled; }
+	return now + (int) failures; 
+}
+
+// whether a stochastic event (a cycle link or a death model) fires on step now. 
+// Rather than one uniform draw per step, draw the step it fires on once, and 
+// keep it while the rate is unchanged. Steps are independent trials, so this 
+// has the same distribution as the default draws. If the rate has changed 
+// since the last step, draw as the default does and reschedule at the next 
+// step, so that rates that change every step cost no more than the default. 
+static bool scheduled_event_fires( double rate , double dt , Scheduled_Event& event , int now )
+{
+	double prob = event_probability_per_step( rate , dt ); 
+	if( rate != event.rate )
+	{
+		bool first_schedule = event.rate < 0.0; 
+		event.rate = rate; 
+		event.step = -1; 
+		if( first_schedule == false )
+		{ return UniformRandom() < prob; }
+	}
+	// a step in the past was missed (e.g., while the cell was out of the 
+	// domain): draw again from now 
+	if( event.step < now )
+	{ event.step = draw_event_step( now , prob ); }
+	return event.step == now; 
+}
+
+// the earliest of two scheduled steps, where -1 (every step) comes first 
+static int earliest_scheduled_step( int step1 , int step2 )
+{
+	if( step1 < 0 || step2 < 0 )
+	{ return -1; }
+	return std::min( step1 , step2 ); 
+}
+
 void Cycle_Data::sync_to_cycle_model( void )
 {
 	// make sure the inverse map is the right size 
@@ -280,6 +370,23 @@ void Cycle_Model::advance_model( Cell* pCell, Phenotype& phenotype, double dt )
 	int i = phenotype.cycle.data.current_phase_index; 
 	
 	phenotype.cycle.data.elapsed_time_in_phase += dt; 
+	
+	// event-driven scheduling (new in 1.14.3): in cells whose rates only change 
+	// with the phase, links without an arrest function keep the step they fire 
+	// on, see scheduled_event_fires() 
+	Cycle_Data& data = phenotype.cycle.data; 
+	bool scheduled = PhysiCell_settings.enable_event_driven_phenotype && pCell->phenotype_rates_are_static(); 
+	int now = PhysiCell_globals.phenotype_step; 
+	if( scheduled )
+	{
+		if( data.schedule_is_current( dt ) == false )
+		{
+			data.scheduled_phase_index = i; 
+			data.scheduled_dt = dt; 
+			data.scheduled_events.assign( phase_links[i].size() , Scheduled_Event() ); 
+		}
+		data.next_scheduled_step = never_scheduled; 
+	}
 
 	// Evaluate each linked phase: 
 	// advance to that phase IF probabiltiy is in the range, 
@@ -306,10 +413,24 @@ void Cycle_Model::advance_model( Cell* pCell, Phenotype& phenotype, double dt )
 				{
 					continue_transition = true; 
 				}
+				else if( scheduled && phase_links[i][k].arrest_function == NULL )
+				{
+					// check again a step before the elapsed time can pass 
+					double steps = std::floor( ( (1.0/phenotype.cycle.data.transition_rates[i][k]) - 0.5*dt 
+						- phenotype.cycle.data.elapsed_time_in_phase ) / dt ); 
+					data.scheduled_events[k].step = never_scheduled; 
+					if( steps < (double) never_scheduled - now )
+					{ data.scheduled_events[k].step = now + std::max( (int) steps , 1 ); }
+				}
+			}
+			else if( scheduled && phase_links[i][k].arrest_function == NULL )
+			{
+				continue_transition = scheduled_event_fires( phenotype.cycle.data.transition_rates[i][k] , dt , 
+					data.scheduled_events[k] , now ); 
 			}
 			else
 			{
-				double prob = phenotype.cycle.data.transition_rates[i][k]*dt; 
+				double prob = event_probability_per_step( phenotype.cycle.data.transition_rates[i][k] , dt ); 
 				if( UniformRandom() < prob )
 				{
 					continue_transition = true; 
@@ -320,6 +441,8 @@ void Cycle_Model::advance_model( Cell* pCell, Phenotype& phenotype, double dt )
 			
 			if( continue_transition )
 			{
+				phenotype.cycle.data.reset_scheduled_transitions(); 
+				
 				// if the phase transition has an exit function, execute it
 				if( phase_links[i][k].exit_function )
 				{
@@ -353,6 +476,12 @@ void Cycle_Model::advance_model( Cell* pCell, Phenotype& phenotype, double dt )
 			
 		}
 		
+		// links with an arrest function are evaluated at every step 
+		if( scheduled )
+		{
+			int step = phase_links[i][k].arrest_function ? -1 : data.scheduled_events[k].step; 
+			data.next_scheduled_step = earliest_scheduled_step( data.next_scheduled_step , step ); 
+		}
 	}
 	
 	return; 
@@ -390,6 +519,9 @@ Death::Death()
 	dead = false; 
 	current_death_model_index = 0;
 	
+	scheduled_dt = 0.0; 
+	next_scheduled_step = -1; 
+	
 	return; 
 }
 
@@ -433,19 +565,49 @@ int Death::find_death_model_index( std::string name )
 }
 	
 bool Death::check_for_death( double dt )
+{ return check_for_death( dt , false ); }
+
+bool Death::check_for_death( double dt , bool scheduled )
 {
 	// If the cell is already dead, exit. 
 	if( dead == true )
 	{
+		next_scheduled_step = never_scheduled; 
 		return false;
 	} 
 	
+	// event-driven scheduling (new in 1.14.3): each death model keeps the 
+	// step it fires on, see scheduled_event_fires() 
+	if( scheduled )
+	{
+		int now = PhysiCell_globals.phenotype_step; 
+		if( schedule_is_current( dt ) == false )
+		{
+			scheduled_dt = dt; 
+			scheduled_events.assign( rates.size() , Scheduled_Event() ); 
+		}
+		next_scheduled_step = never_scheduled; 
+		
+		for( int i=0 ; i < rates.size() ; i++ )
+		{
+			if( scheduled_event_fires( rates[i] , dt , scheduled_events[i] , now ) )
+			{
+				dead = true; 
+				current_death_model_index = i; 
+				reset_scheduled_deaths(); 
+				return dead; 
+			}
+			next_scheduled_step = earliest_scheduled_step( next_scheduled_step , scheduled_events[i].step ); 
+		}
+		return dead; 
+	}
+	
 	// If the cell is alive, evaluate all the 
 	// death rates for each registered death type. 
 	int i = 0; 
 	while( !dead && i < rates.size() )
 	{
-		if( UniformRandom() < rates[i]*dt )
+		if( UniformRandom() < event_probability_per_step( rates[i] , dt ) )
 		{
 			// update the Death data structure 
 			dead = true; 
@@ -461,10 +623,25 @@ bool Death::check_for_death( double dt )
 	return dead; 
 }
 
+void Death::reset_scheduled_deaths( void )
+{
+	scheduled_events.clear(); 
+	next_scheduled_step = -1; 
+	return; 
+}
+
+bool Death::schedule_is_current( double dt )
+{
+	if( dead )
+	{ return true; }
+	return scheduled_events.size() == rates.size() && fabs( dt - scheduled_dt ) <= 0.001 * dt; 
+}
+
 void Death::trigger_death( int death_model_index )
 {
 	dead = true; 
 	current_death_model_index = death_model_index; 
+	reset_scheduled_deaths(); 
 	
 /*	
 	// if so, change the cycle model to the current death model 
@@ -712,13 +889,38 @@ void Mechanics::sync_to_cell_definitions()
 	return; 
 }
 
+// defined in PhysiCell_cell.cpp 
+int find_cell_definition_index( std::string search_string ); 
+int find_cell_definition_index( int search_type ); 
+
+// Look up without inserting: operator[] on the maps could insert, which is a 
+// data race in parallel code. Unknown types map to the first definition, as 
+// before. (new in 1.14.3) 
+int cell_definition_index_or_zero( std::string type_name )
+{
+	int n = find_cell_definition_index( type_name ); 
+	if( n < 0 )
+	{ return 0; }
+	return n; 
+}
+
+int cell_definition_index_or_zero( int type )
+{
+	int n = find_cell_definition_index( type ); 
+	if( n < 0 )
+	{ return 0; }
+	return n; 
+}
+
 double& Mechanics::cell_adhesion_affinity( std::string type_name )
 {
-	extern std::unordered_map<std::string,int> cell_definition_indices_by_name; 
-	int n = cell_definition_indices_by_name[type_name]; 
+	int n = cell_definition_index_or_zero( type_name ); 
 	return cell_adhesion_affinities[n]; 
 }
 
+double& Mechanics::cell_adhesion_affinity( int type )
+{ return cell_adhesion_affinities[ cell_definition_index_or_zero( type ) ]; }
+
 void Mechanics::set_fully_heterotypic( void )
 {
 	extern std::unordered_map<std::string,int> cell_definition_indices_by_name; 
@@ -922,10 +1124,22 @@ void Secretion::sync_to_microenvironment( Microenvironment* pNew_Microenvironmen
 }
 
 void Secretion::advance( Basic_Agent* pCell, Phenotype& phenotype , double dt )
+{
+	if( prepare_to_advance( pCell, phenotype, dt ) == false )
+	{ return; }
+
+	// now, call the BioFVM secretion/uptake function 
+	
+	pCell->simulate_secretion_and_uptake( pMicroenvironment , dt ); 
+	
+	return; 
+}
+
+bool Secretion::prepare_to_advance( Basic_Agent* pCell, Phenotype& phenotype , double dt )
 {
 	// if this phenotype is not associated with a cell, exit 
 	if( pCell == NULL )
-	{ return; }
+	{ return false; }
 
 	// if there is no microenvironment, attempt to sync. 
 	if( pMicroenvironment == NULL )
@@ -944,7 +1158,7 @@ void Secretion::advance( Basic_Agent* pCell, Phenotype& phenotype , double dt )
 		// if we've still failed, return. 
 		if( pMicroenvironment == NULL ) 
 		{
-			return; 
+			return false; 
 		}
 	}
 
@@ -965,11 +1179,7 @@ void Secretion::advance( Basic_Agent* pCell, Phenotype& phenotype , double dt )
 		pCell->set_internal_uptake_constants( dt );
 	}
 
-	// now, call the BioFVM secretion/uptake function 
-	
-	pCell->simulate_secretion_and_uptake( pMicroenvironment , dt ); 
-	
-	return; 
+	return true; 
 }
 
 void Secretion::set_all_secretion_to_zero( void )
@@ -1069,6 +1279,10 @@ void Molecular::sync_to_microenvironment( Microenvironment* pNew_Microenvironmen
 
 void Molecular::sync_to_cell( Basic_Agent* pCell )
 {
+	// already linked (e.g., a recycled cell) 
+	if( pCell->internalized_substrates == &internalized_total_substrates )
+	{ return; }
+	
 	delete pCell->internalized_substrates;
 	pCell->internalized_substrates = &internalized_total_substrates;
 	
@@ -1305,33 +1519,41 @@ void Cell_Interactions::sync_to_cell_definitions()
 // ease of access 
 double& Cell_Interactions::live_phagocytosis_rate( std::string type_name )
 {
-	extern std::unordered_map<std::string,int> cell_definition_indices_by_name; 
-	int n = cell_definition_indices_by_name[type_name]; 
+	int n = cell_definition_index_or_zero( type_name ); 
 	// std::cout << type_name << " " << n << std::endl; 
 	return live_phagocytosis_rates[n]; 
 }
 
+double& Cell_Interactions::live_phagocytosis_rate( int type )
+{ return live_phagocytosis_rates[ cell_definition_index_or_zero( type ) ]; }
+
 double& Cell_Interactions::attack_rate( std::string type_name ) 
 {
-	extern std::unordered_map<std::string,int> cell_definition_indices_by_name; 
-	int n = cell_definition_indices_by_name[type_name]; 
+	int n = cell_definition_index_or_zero( type_name ); 
 	return attack_rates[n]; 
 }
 
+double& Cell_Interactions::attack_rate( int type )
+{ return attack_rates[ cell_definition_index_or_zero( type ) ]; }
+
 double& Cell_Interactions::fusion_rate( std::string type_name )
 {
-	extern std::unordered_map<std::string,int> cell_definition_indices_by_name; 
-	int n = cell_definition_indices_by_name[type_name]; 
+	int n = cell_definition_index_or_zero( type_name ); 
 	return fusion_rates[n]; 
 }
 
+double& Cell_Interactions::fusion_rate( int type )
+{ return fusion_rates[ cell_definition_index_or_zero( type ) ]; }
+
 double& Cell_Interactions::immunogenicity( std::string type_name )
 {
-	extern std::unordered_map<std::string,int> cell_definition_indices_by_name; 
-	int n = cell_definition_indices_by_name[type_name]; 
+	int n = cell_definition_index_or_zero( type_name ); 
 	return immunogenicities[n]; 
 }
 
+double& Cell_Interactions::immunogenicity( int type )
+{ return immunogenicities[ cell_definition_index_or_zero( type ) ]; }
+
 Cell_Transformations::Cell_Transformations()
 {
 	transformation_rates = {0.0}; 
@@ -1353,11 +1575,13 @@ void Cell_Transformations::sync_to_cell_definitions()
 // ease of access 
 double& Cell_Transformations::transformation_rate( std::string type_name )
 {
-	extern std::unordered_map<std::string,int> cell_definition_indices_by_name; 
-	int n = cell_definition_indices_by_name[type_name]; 
+	int n = cell_definition_index_or_zero( type_name ); 
 	return transformation_rates[n]; 
 }
 
+double& Cell_Transformations::transformation_rate( int type )
+{ return transformation_rates[ cell_definition_index_or_zero( type ) ]; }
+
 Asymmetric_Division::Asymmetric_Division()
 {
 	asymmetric_division_probabilities = {0.0};
@@ -1385,11 +1609,13 @@ double Asymmetric_Division::probabilities_total( void )
 // ease of access
 double& Asymmetric_Division::asymmetric_division_probability( std::string type_name )
 {
-	extern std::unordered_map<std::string,int> cell_definition_indices_by_name; 
-	int n = cell_definition_indices_by_name[type_name]; 
+	int n = cell_definition_index_or_zero( type_name ); 
 	return asymmetric_division_probabilities[n]; 
 }
 
+double& Asymmetric_Division::asymmetric_division_probability( int type )
+{ return asymmetric_division_probabilities[ cell_definition_index_or_zero( type ) ]; }
+
 // beta functionality in 1.10.3 
 Cell_Integrity::Cell_Integrity()
 {
@@ -134,6 +134,19 @@ class Phase_Link
 	Phase_Link(); // done
 };
 
+// event-driven scheduling (new in 1.14.3): a stochastic cycle link or death 
+// model, with the rate it was scheduled with (-1: not yet scheduled) and the 
+// phenotype step (PhysiCell_globals.phenotype_step) it fires on (-1: evaluate 
+// at every step) 
+class Scheduled_Event
+{
+ public:
+	double rate; 
+	int step; 
+	
+	Scheduled_Event(); 
+};
+
 class Cycle_Data
 {
  private:
@@ -155,6 +168,14 @@ class Cycle_Data
 	int current_phase_index; 
 	double elapsed_time_in_phase; 
 	
+	// event-driven scheduling (new in 1.14.3): the events of the links out of 
+	// scheduled_phase_index (-1: not yet scheduled), and the earliest of their 
+	// steps 
+	int scheduled_phase_index; 
+	double scheduled_dt; 
+	std::vector<Scheduled_Event> scheduled_events; 
+	int next_scheduled_step; 
+	
 	Cycle_Data(); // done 
 	
 	// return current phase (by reference)
@@ -169,6 +190,12 @@ class Cycle_Data
 	double& exit_rate(int phase_index ); // This returns the first transition rate out of 
 		// phase # phase_index. It is only relevant if the phase has only one phase link 
 		// (true for many cycle models). 
+	
+	// reschedule the transitions at the next step (new in 1.14.3). Call this after 
+	// changing transition rates or the elapsed time outside of update_phenotype, the 
+	// rules, custom_cell_rule, contact_function or an intracellular model. 
+	void reset_scheduled_transitions( void ); 
+	bool schedule_is_current( double dt ); 
 };
 
 class Cycle_Model
@@ -228,6 +255,7 @@ public:
 
 	// ease of access 
 	double& asymmetric_division_probability( std::string type_name ); // done
+	double& asymmetric_division_probability( int type ); // by type ID (Cell::type), new in 1.14.3 
 };
 
 class Cycle
@@ -280,6 +308,11 @@ class Death
 	bool dead; 
 	int current_death_model_index;
 	
+	// event-driven scheduling (new in 1.14.3): as in Cycle_Data, for each death model 
+	double scheduled_dt; 
+	std::vector<Scheduled_Event> scheduled_events; 
+	int next_scheduled_step; 
+	
 	Death(); // done 
 	
 	int add_death_model( double rate, Cycle_Model* pModel );  // done
@@ -289,7 +322,10 @@ class Death
 	int find_death_model_index( std::string name ); // done 
 	
 	bool check_for_death( double dt ); // done
+	bool check_for_death( double dt , bool scheduled ); // new in 1.14.3 
 	void trigger_death( int death_model_index ); // done 
+	void reset_scheduled_deaths( void ); // new in 1.14.3, as reset_scheduled_transitions() 
+	bool schedule_is_current( double dt ); // new in 1.14.3 
 	
 	Cycle_Model& current_model( void ); // done
 	Death_Parameters& current_parameters( void ); // done '
@@ -387,6 +423,7 @@ class Mechanics
 
 	std::vector<double> cell_adhesion_affinities; 
 	double& cell_adhesion_affinity( std::string type_name ); // done 
+	double& cell_adhesion_affinity( int type ); // by type ID (Cell::type), new in 1.14.3 
 	void sync_to_cell_definitions(); // done 
 	void set_fully_heterotypic( void ); // done 
 	void set_fully_homotypic( Cell* pCell ); // done 
@@ -473,6 +510,10 @@ class Secretion
 	void sync_to_current_microenvironment( void ); // done 
 	
 	void advance( Basic_Agent* pCell, Phenotype& phenotype , double dt ); 
+	// advance() without the BioFVM secretion/uptake step, for callers that run 
+	// Microenvironment::simulate_cell_sources_and_sinks() on all cells at once. 
+	// Returns false if there is no microenvironment. (new in 1.14.3) 
+	bool prepare_to_advance( Basic_Agent* pCell, Phenotype& phenotype , double dt ); 
 	
 	// use this to properly size the secretion parameters to the microenvironment 
 	void sync_to_microenvironment( Microenvironment* pNew_Microenvironment ); // done 
@@ -715,6 +756,12 @@ class Cell_Interactions
 	double& fusion_rate( std::string type_name ); // done 
 	double& immunogenicity( std::string type_name ); // done 
 	
+	// by type ID (Cell::type), without hashing the type name (new in 1.14.3) 
+	double& live_phagocytosis_rate( int type ); 
+	double& attack_rate( int type ); 
+	double& fusion_rate( int type ); 
+	double& immunogenicity( int type ); 
+	
 	// automated cell phagocytosis, attack, and fusion 
 //	void perform_interactions( Cell* pCell, Phenotype& phenotype, double dt ); 
 };
@@ -732,6 +779,7 @@ class Cell_Transformations
 	
 	// ease of access 
 	double& transformation_rate( std::string type_name ); // done
+	double& transformation_rate( int type ); // by type ID (Cell::type), new in 1.14.3 
 	
 	// automated cell transformations
 	// void perform_transformations( Cell* pCell, Phenotype& phenotype, double dt ); 
@@ -711,6 +711,186 @@ double get_single_base_behavior( Cell_Definition* pCD , std::string name )
 }
 */
 
+/* compiled rules (new in 1.14.3) */ 
+
+// how a compiled rule writes a behavior (signals are read by Signal_Accessor). 
+// Behaviors without a direct kind go through set_single_behavior. 
+enum compiled_behavior_kinds { generic_behavior , secretion_behavior , secretion_target_behavior , 
+	uptake_behavior , export_behavior , death_rate_behavior , migration_speed_behavior , 
+	migration_bias_behavior , persistence_time_behavior , chemotaxis_behavior , custom_behavior }; 
+
+void resolve_compiled_behavior( Compiled_Rule& rule , Cell_Definition* pCD )
+{
+	int m = microenvironment.number_of_densities(); 
+	int index = rule.behavior_index; 
+	rule.behavior_kind = generic_behavior; 
+	rule.offset = 0; 
+
+	int first = find_behavior_index( microenvironment.density_names[0] + " secretion" ); 
+	if( index >= first && index < first + m )
+	{ rule.behavior_kind = secretion_behavior; rule.offset = index - first; return; }
+
+	first = find_behavior_index( microenvironment.density_names[0] + " secretion target" ); 
+	if( index >= first && index < first + m )
+	{ rule.behavior_kind = secretion_target_behavior; rule.offset = index - first; return; }
+
+	first = find_behavior_index( microenvironment.density_names[0] + " uptake" ); 
+	if( index >= first && index < first + m )
+	{ rule.behavior_kind = uptake_behavior; rule.offset = index - first; return; }
+
+	first = find_behavior_index( microenvironment.density_names[0] + " export" ); 
+	if( index >= first && index < first + m )
+	{ rule.behavior_kind = export_behavior; rule.offset = index - first; return; }
+
+	first = find_behavior_index( "chemotactic response to " + microenvironment.density_names[0] ); 
+	if( index >= first && index < first + m )
+	{ rule.behavior_kind = chemotaxis_behavior; rule.offset = index - first; return; }
+
+	if( pCD && index == find_behavior_index( "apoptosis" ) )
+	{
+		rule.behavior_kind = death_rate_behavior; 
+		rule.offset = pCD->phenotype.death.find_death_model_index( PhysiCell_constants::apoptosis_death_model ); 
+		return; 
+	}
+	if( pCD && index == find_behavior_index( "necrosis" ) )
+	{
+		rule.behavior_kind = death_rate_behavior; 
+		rule.offset = pCD->phenotype.death.find_death_model_index( PhysiCell_constants::necrosis_death_model ); 
+		return; 
+	}
+
+	if( index == find_behavior_index( "migration speed" ) )
+	{ rule.behavior_kind = migration_speed_behavior; return; }
+	if( index == find_behavior_index( "migration bias" ) )
+	{ rule.behavior_kind = migration_bias_behavior; return; }
+	if( index == find_behavior_index( "migration persistence time" ) )
+	{ rule.behavior_kind = persistence_time_behavior; return; }
+
+	first = find_behavior_index( "custom 0" ); 
+	if( pCD && first > -1 && index >= first && index < first + (int) pCD->custom_data.variables.size() )
+	{ rule.behavior_kind = custom_behavior; rule.offset = index - first; return; }
+
+	return; 
+}
+
+inline void compiled_set_behavior( Cell* pCell , const Compiled_Rule& rule , double parameter )
+{
+	switch( rule.behavior_kind )
+	{
+		case secretion_behavior: 
+			pCell->phenotype.secretion.secretion_rates[rule.offset] = parameter; return; 
+		case secretion_target_behavior: 
+			pCell->phenotype.secretion.saturation_densities[rule.offset] = parameter; return; 
+		case uptake_behavior: 
+			pCell->phenotype.secretion.uptake_rates[rule.offset] = parameter; return; 
+		case export_behavior: 
+			pCell->phenotype.secretion.net_export_rates[rule.offset] = parameter; return; 
+		case death_rate_behavior: 
+			pCell->phenotype.death.rates[rule.offset] = parameter; return; 
+		case migration_speed_behavior: 
+			pCell->phenotype.motility.migration_speed = parameter; return; 
+		case migration_bias_behavior: 
+			pCell->phenotype.motility.migration_bias = parameter; return; 
+		case persistence_time_behavior: 
+			pCell->phenotype.motility.persistence_time = parameter; return; 
+		case chemotaxis_behavior: 
+			pCell->phenotype.motility.chemotactic_sensitivities[rule.offset] = parameter; return; 
+		case custom_behavior: 
+			pCell->custom_data.variables[rule.offset].value = parameter; return; 
+		default: 
+			set_single_behavior( pCell , rule.behavior_index , parameter ); 
+	}
+	return; 
+}
+
+void Compiled_Ruleset::compile( Hypothesis_Ruleset& ruleset )
+{
+	rules.clear(); 
+	terms.clear(); 
+	Cell_Definition* pCD = ruleset.pCell_Definition; 
+
+	for( int i=0; i < ruleset.rules.size() ; i++ )
+	{
+		Hypothesis_Rule* pHR = ruleset.rules[i]; 
+
+		Compiled_Rule rule; 
+		rule.behavior_index = find_behavior_index( pHR->behavior ); 
+		resolve_compiled_behavior( rule , pCD ); 
+		rule.base_value = pHR->base_value; 
+		rule.max_value = pHR->max_value; 
+		rule.min_value = pHR->min_value; 
+		rule.first_term = terms.size(); 
+		rule.up_terms = 0; 
+		rule.down_terms = 0; 
+
+		// up-regulating terms first, then down-regulating ones, each in signal order 
+		for( int pass=0 ; pass < 2 ; pass++ )
+		{
+			for( int j=0; j < pHR->signals.size(); j++ )
+			{
+				if( pHR->responses[j] != (pass == 0) )
+				{ continue; }
+
+				Compiled_Hill_Term term; 
+				term.signal = Signal_Accessor( find_signal_index( pHR->signals[j] ) ); 
+				term.half_max = pHR->half_maxes[j]; 
+				term.hill_power = pHR->hill_powers[j]; 
+				term.applies_to_dead_cells = pHR->applies_to_dead_cells[j]; 
+				terms.push_back( term ); 
+
+				if( pass == 0 )
+				{ rule.up_terms++; }
+				else
+				{ rule.down_terms++; }
+			}
+		}
+		rules.push_back( rule ); 
+	}
+	return; 
+}
+
+// the same arithmetic as Hypothesis_Rule::evaluate and multivariate_Hill_response_function 
+void Compiled_Ruleset::apply( Cell* pCell ) const
+{
+	bool dead = pCell->phenotype.death.dead; 
+
+	for( int r=0; r < rules.size() ; r++ )
+	{
+		const Compiled_Rule& rule = rules[r]; 
+
+		// Hill sums of the up- and down-regulating signals. Signals that do 
+		// not apply to dead cells count as zero. 
+		bool apply_rule = false; 
+		double sums[2] = { 0.0 , 0.0 }; 
+		int first_down_term = rule.first_term + rule.up_terms; 
+		int end = first_down_term + rule.down_terms; 
+		for( int t=rule.first_term ; t < end ; t++ )
+		{
+			const Compiled_Hill_Term& term = terms[t]; 
+			double signal = 0.0; 
+			if( term.applies_to_dead_cells || dead == false )
+			{
+				signal = term.signal.value( pCell ); 
+				apply_rule = true; 
+			}
+			signal /= term.half_max; 
+			sums[ t >= first_down_term ] += pow( signal , term.hill_power ); 
+		}
+
+		// if none of the signals apply, leave the behavior as it is 
+		if( apply_rule == false )
+		{ continue; }
+
+		double HU = sums[0] / ( sums[0] + 1.0 ); 
+		double U = rule.base_value + (rule.max_value-rule.base_value)*HU; 
+		double DU = sums[1] / ( sums[1] + 1.0 ); 
+		double output = U + (rule.min_value-U)*DU; 
+
+		compiled_set_behavior( pCell , rule , output ); 
+	}
+	return; 
+}
+
 Hypothesis_Ruleset::Hypothesis_Ruleset()
 {
 	cell_type = "none"; 
@@ -719,6 +899,8 @@ Hypothesis_Ruleset::Hypothesis_Ruleset()
 	rules.resize(0); 
 	rules_map.clear(); 
 
+	compiled_up_to_date = false; 
+
 	return; 
 }
 
@@ -750,12 +932,15 @@ void Hypothesis_Ruleset::sync_to_cell_definition( Cell_Definition* pCD )
 
 	for( int i=0; i < rules.size(); i++ )
 	{ rules[i]->sync_to_cell_definition(pCD); }
+	compiled_up_to_date = false; 
 
 	return; 
 }
 
 Hypothesis_Rule* Hypothesis_Ruleset::add_behavior( std::string behavior , double min_behavior, double max_behavior )
 {
+	compiled_up_to_date = false; 
+
     // check: is this a valid signal? (is it in the dictionary?)
     if( find_behavior_index(behavior) < 0 )
     {
@@ -831,13 +1016,26 @@ Hypothesis_Rule& Hypothesis_Ruleset::operator[]( std::string name )
 
 void Hypothesis_Ruleset::apply( Cell* pCell )
 {
+	if( compiled_up_to_date )
+	{ compiled.apply( pCell ); return; }
+
 	for( int n=0; n < rules.size() ; n++ )
 	{ rules[n]->apply( pCell );  }
 	return; 
 }
 
+void Hypothesis_Ruleset::compile( void )
+{
+	compiled.compile( *this ); 
+	compiled_up_to_date = true; 
+	return; 
+}
+
 std::unordered_map< Cell_Definition* , Hypothesis_Ruleset > hypothesis_rulesets; 
 
+// rulesets indexed by cell type, so apply_ruleset() needs no name lookup (new in 1.14.3)
+std::vector< Hypothesis_Ruleset* > hypothesis_rulesets_by_type; 
+
 void add_hypothesis_ruleset( Cell_Definition* pCD )
 {
 	auto search = hypothesis_rulesets.find( pCD );
@@ -853,6 +1051,7 @@ void add_hypothesis_ruleset( Cell_Definition* pCD )
 void intialize_hypothesis_rulesets( void )
 {
 	hypothesis_rulesets.clear(); // empty(); 
+	hypothesis_rulesets_by_type.clear(); 
 
 	for( int n; n < cell_definitions_by_index.size() ; n++ )
 	{
@@ -912,6 +1111,7 @@ void add_rule( std::string cell_type, std::string signal, std::string behavior ,
 	pHRS->add_behavior(behavior); 
 
 	(*pHRS)[behavior].add_signal(signal,response); 
+	pHRS->compiled_up_to_date = false; 
 
 	return; 
 }
@@ -948,6 +1148,7 @@ void add_rule( std::string cell_type, std::string signal, std::string behavior ,
 
 	int n = (*pHRS)[behavior].find_signal(signal); 
 	(*pHRS)[behavior].applies_to_dead_cells[n] = use_for_dead; 
+	pHRS->compiled_up_to_date = false; 
 
 	return; 
 }
@@ -998,6 +1199,7 @@ void set_hypothesis_parameters(std::string cell_type, std::string signal, std::s
 
 	hypothesis_rulesets[pCD][behavior].set_half_max(signal,half_max); 
 	hypothesis_rulesets[pCD][behavior].set_hill_power(signal,hill_power); 
+	hypothesis_rulesets[pCD].compiled_up_to_date = false; 
 	
 	return; 
 }
@@ -1032,6 +1234,7 @@ void set_behavior_parameters( std::string cell_type, std::string behavior,
 	
 	hypothesis_rulesets[pCD][behavior].min_value = min_value; 
 	hypothesis_rulesets[pCD][behavior].max_value = max_value; 
+	hypothesis_rulesets[pCD].compiled_up_to_date = false; 
 	
 	return;
 }
@@ -1070,6 +1273,7 @@ void set_behavior_parameters( std::string cell_type, std::string behavior,
 	if ( max_value > hypothesis_rulesets[pCD][behavior].max_value )
 	{ hypothesis_rulesets[pCD][behavior].max_value = max_value; } 
 	hypothesis_rulesets[pCD][behavior].base_value = base_value; 
+	hypothesis_rulesets[pCD].compiled_up_to_date = false; 
 	
 	return;
 }
@@ -1103,6 +1307,7 @@ void set_behavior_base_value( std::string cell_type, std::string behavior, doubl
     }
 
 	hypothesis_rulesets[pCD][behavior].base_value = base_value; 
+	hypothesis_rulesets[pCD].compiled_up_to_date = false; 
 
 	return;
 }
@@ -1136,6 +1341,7 @@ void set_behavior_min_value( std::string cell_type, std::string behavior, double
 	
 	if ( min_value < hypothesis_rulesets[pCD][behavior].min_value )
 	{ hypothesis_rulesets[pCD][behavior].min_value = min_value; }
+	hypothesis_rulesets[pCD].compiled_up_to_date = false; 
 
 	return;
 }
@@ -1169,14 +1375,35 @@ void set_behavior_max_value( std::string cell_type, std::string behavior, double
 
 	if ( max_value > hypothesis_rulesets[pCD][behavior].max_value )
 	{ hypothesis_rulesets[pCD][behavior].max_value = max_value; }
+	hypothesis_rulesets[pCD].compiled_up_to_date = false; 
 	
 	return;
 }
 
 
 
+void compile_hypothesis_rulesets( void )
+{
+	hypothesis_rulesets_by_type.clear(); 
+	for( auto it = hypothesis_rulesets.begin() ; it != hypothesis_rulesets.end() ; it++ )
+	{
+		Cell_Definition* pCD = it->first; 
+		it->second.compile(); 
+		if( pCD == NULL || pCD->type < 0 )
+		{ continue; }
+		if( (size_t) pCD->type >= hypothesis_rulesets_by_type.size() )
+		{ hypothesis_rulesets_by_type.resize( pCD->type + 1 , NULL ); }
+		hypothesis_rulesets_by_type[ pCD->type ] = &(it->second); 
+	}
+	return; 
+}
+
 void apply_ruleset( Cell* pCell )
 {
+	if( pCell->type >= 0 && (size_t) pCell->type < hypothesis_rulesets_by_type.size() && 
+		hypothesis_rulesets_by_type[pCell->type] )
+	{ hypothesis_rulesets_by_type[pCell->type]->apply( pCell ); return; }
+
 	Cell_Definition* pCD = find_cell_definition( pCell->type_name ); 
 	hypothesis_rulesets[pCD].apply( pCell );
 	return; 
@@ -2353,6 +2580,9 @@ void setup_cell_rules( void )
 	// load rules 
 	parse_rules_from_pugixml(); 
 
+	// compile them into flat programs (new in 1.14.3) 
+	compile_hypothesis_rulesets(); 
+
 	// display rules to screen
 	display_hypothesis_rulesets( std::cout );
 
@@ -67,6 +67,7 @@
 
 #include "../core/PhysiCell.h"
 #include "../modules/PhysiCell_standard_modules.h" 
+#include "./PhysiCell_signal_behavior.h" 
 
 #include <typeinfo>
 
@@ -137,6 +138,49 @@ class Hypothesis_Rule
     void English_detailed_display_HTML( std::ostream& os ); 
 }; 
 
+/* compiled rules (new in 1.14.3) */ 
+
+// one Hill term of a compiled rule, with its signal resolved to an accessor 
+class Compiled_Hill_Term
+{
+ public:
+    Signal_Accessor signal; 
+    double half_max; 
+    double hill_power; 
+    bool applies_to_dead_cells; 
+}; 
+
+class Compiled_Rule
+{
+ public:
+    int behavior_index; 
+    int behavior_kind; // how the behavior is written (direct field, or set_single_behavior) 
+    int offset; // substrate, death model, or custom variable number, for the direct kinds 
+
+    double base_value; 
+    double max_value; 
+    double min_value; 
+
+    // terms[first_term ... first_term+up_terms-1] raise the behavior, and 
+    // the next down_terms terms lower it 
+    int first_term; 
+    int up_terms; 
+    int down_terms; 
+}; 
+
+class Hypothesis_Ruleset; 
+
+// a ruleset as a flat program: evaluation does no lookups by name and no allocation 
+class Compiled_Ruleset
+{
+ public:
+    std::vector<Compiled_Rule> rules; 
+    std::vector<Compiled_Hill_Term> terms; 
+
+    void compile( Hypothesis_Ruleset& ruleset ); 
+    void apply( Cell* pCell ) const; 
+}; 
+
 class Hypothesis_Ruleset
 {
  private:
@@ -159,6 +203,13 @@ class Hypothesis_Ruleset
 
     void apply( Cell* pCell ); 
 
+    // compiled program (new in 1.14.3). apply() uses it while it is up to date. 
+    // Functions that edit rules mark it out of date; after editing rules 
+    // directly (e.g., a rule's base_value), call compile() again. 
+    Compiled_Ruleset compiled; 
+    bool compiled_up_to_date; 
+    void compile( void ); 
+
     void sync_to_cell_definition( Cell_Definition* pCD ); // done 
     void sync_to_cell_definition( std::string cell_name ); // done 
 
@@ -199,6 +250,7 @@ void detailed_display_hypothesis_rulesets( std::ostream& os );
 // applying to a cell 
 
 void apply_ruleset( Cell* pCell ); 
+void compile_hypothesis_rulesets( void ); // new in 1.14.3 
 void rule_phenotype_function( Cell* pCell, Phenotype& phenotype, double dt ); 
 
 
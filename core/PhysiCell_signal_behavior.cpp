@@ -827,7 +827,7 @@ std::vector<double> get_signals( Cell* pCell )
 		} 
 		else
 		{ live_cells++; } 
-		int nCT = cell_definition_indices_by_type[pC->type]; 
+		int nCT = find_cell_definition_index( pC->type ); 
 		signals[contact_ind+nCT] += 1; 
 	}
 	other_dead_cells = dead_cells - apop_cells - necro_cells; 
@@ -949,7 +949,7 @@ std::vector<double> get_cell_contact_signals( Cell* pCell )
 		} 
 		else
 		{ live_cells++; } 
-		int nCT = cell_definition_indices_by_type[pC->type]; 
+		int nCT = find_cell_definition_index( pC->type ); 
 		output[nCT] += 1; 
 	}
     other_dead_cells = dead_cells - apop_cells - necro_cells; 
@@ -1065,7 +1065,7 @@ double get_single_signal( Cell* pCell, int index )
 	// physical contact with cells (of each type) 
 	// individual contact signals are a bit costly 
 	static int contact_ind = find_signal_index( "contact with " + cell_definitions_by_type[0]->name ); 
-	if( contact_ind <= index && index < contact_ind + n+2 )
+	if( contact_ind <= index && index < contact_ind + n+5 )
 	{
 		std::vector<int> counts( n , 0 ); 
 		// process all neighbors 
@@ -1089,7 +1089,7 @@ double get_single_signal( Cell* pCell, int index )
 			} 
 			else
 			{ live_cells++; } 
-			int nCT = cell_definition_indices_by_type[pC->type]; 
+			int nCT = find_cell_definition_index( pC->type ); 
 			counts[nCT] += 1; 
 		}
 		other_dead_cells = dead_cells - apop_cells - necro_cells; 		
@@ -2817,4 +2817,235 @@ std::vector<double> get_base_behaviors( Cell* pCell , std::vector<std::string> n
 	return parameters; 
 }
 
+/* batched signals (new in 1.14.3) */ 
+
+enum signal_accessor_kinds { unknown_signal , generic_signal , substrate_signal , intracellular_signal , 
+	gradient_signal , pressure_signal , volume_signal , contact_signal , BM_contact_signal , damage_signal , 
+	damage_delivered_signal , attacking_signal , dead_signal , attack_time_signal , time_signal , 
+	custom_signal , apoptotic_signal , necrotic_signal }; 
+
+Signal_Accessor::Signal_Accessor()
+{
+	signal_index = -1; 
+	kind = unknown_signal; 
+	offset = 0; 
+	return; 
+}
+
+Signal_Accessor::Signal_Accessor( int index )
+{
+	int m = microenvironment.number_of_densities(); 
+	int n = cell_definition_indices_by_name.size(); 
+
+	signal_index = index; 
+	kind = generic_signal; 
+	offset = 0; 
+	if( index < 0 || index >= signal_scales.size() )
+	{ kind = unknown_signal; return; }
+
+	int first = find_signal_index( microenvironment.density_names[0] ); 
+	if( index >= first && index < first + m )
+	{ kind = substrate_signal; offset = index - first; return; }
+
+	first = find_signal_index( "intracellular " + microenvironment.density_names[0] ); 
+	if( index >= first && index < first + m )
+	{ kind = intracellular_signal; offset = index - first; return; }
+
+	first = find_signal_index( microenvironment.density_names[0] + " gradient" ); 
+	if( index >= first && index < first + m )
+	{ kind = gradient_signal; offset = index - first; return; }
+
+	// cell types, then live, dead, apoptotic, necrotic, and other dead cells 
+	first = find_signal_index( "contact with " + cell_definitions_by_type[0]->name ); 
+	if( index >= first && index < first + n+5 )
+	{ kind = contact_signal; offset = index - first; return; }
+
+	first = find_signal_index( "custom 0" ); 
+	if( first > -1 && index >= first && index < first + (int) cell_defaults.custom_data.variables.size() )
+	{ kind = custom_signal; offset = index - first; return; }
+
+	if( index == find_signal_index( "pressure" ) )
+	{ kind = pressure_signal; }
+	else if( index == find_signal_index( "volume" ) )
+	{ kind = volume_signal; }
+	else if( index == find_signal_index( "contact with basement membrane" ) )
+	{ kind = BM_contact_signal; }
+	else if( index == find_signal_index( "damage" ) )
+	{ kind = damage_signal; }
+	else if( index == find_signal_index( "damage delivered" ) )
+	{ kind = damage_delivered_signal; }
+	else if( index == find_signal_index( "attacking" ) )
+	{ kind = attacking_signal; }
+	else if( index == find_signal_index( "dead" ) )
+	{ kind = dead_signal; }
+	else if( index == find_signal_index( "total attack time" ) )
+	{ kind = attack_time_signal; }
+	else if( index == find_signal_index( "time" ) )
+	{ kind = time_signal; }
+	else if( index == find_signal_index( "apoptotic" ) )
+	{ kind = apoptotic_signal; }
+	else if( index == find_signal_index( "necrotic" ) )
+	{ kind = necrotic_signal; }
+
+	return; 
+}
+
+// the same values as get_single_signal 
+double Signal_Accessor::value( Cell* pCell ) const
+{
+	double out = 0.0; 
+	int code; 
+	switch( kind )
+	{
+		case substrate_signal: 
+			out = pCell->nearest_density_vector()[offset]; break; 
+		case intracellular_signal: 
+			out = pCell->phenotype.molecular.internalized_total_substrates[offset]; 
+			out /= pCell->phenotype.volume.total; break; 
+		case gradient_signal: 
+			out = norm( pCell->nearest_gradient(offset) ); break; 
+		case pressure_signal: 
+			out = pCell->state.simple_pressure; break; 
+		case volume_signal: 
+			out = pCell->phenotype.volume.total; break; 
+		case BM_contact_signal: 
+			out = (double) pCell->state.contact_with_basement_membrane; break; 
+		case damage_signal: 
+			out = pCell->phenotype.cell_integrity.damage; break; 
+		case damage_delivered_signal: 
+			out = pCell->phenotype.cell_interactions.total_damage_delivered; break; 
+		case dead_signal: 
+			out = (double) pCell->phenotype.death.dead; break; 
+		case attack_time_signal: 
+			out = pCell->state.total_attack_time; break; 
+		case time_signal: 
+			out = PhysiCell_globals.current_time; break; 
+		case custom_signal: 
+			out = pCell->custom_data.variables[offset].value; break; 
+
+		// these are not scaled 
+		case attacking_signal: 
+			return pCell->phenotype.cell_interactions.pAttackTarget ? 1.0 : 0.0; 
+		case apoptotic_signal: 
+			return pCell->phenotype.cycle.current_phase().code == PhysiCell_constants::apoptotic ? 1.0 : 0.0; 
+		case necrotic_signal: 
+			code = pCell->phenotype.cycle.current_phase().code; 
+			if( code == PhysiCell_constants::necrotic_swelling || code == PhysiCell_constants::necrotic_lysed || 
+				code == PhysiCell_constants::necrotic )
+			{ return 1.0; }
+			return 0.0; 
+
+		case unknown_signal: 
+			return 0.0; 
+		default: 
+			return get_single_signal( pCell , signal_index ); 
+	}
+	out /= signal_scales[signal_index]; 
+	return out; 
+}
+
+double& Signal_Matrix::operator()( int cell , int signal )
+{ return values[ signal*cells.size() + cell ]; }
+
+double* Signal_Matrix::column( int signal )
+{ return values.data() + signal*cells.size(); }
+
+// counts of neighbors by cell type, then live, dead, apoptotic, necrotic, and other dead 
+void count_cell_contacts( Cell* pCell , std::vector<double>& counts )
+{
+	int n = cell_definition_indices_by_name.size(); 
+	counts.assign( n+5 , 0.0 ); 
+	for( int i=0; i < pCell->state.neighbors.size(); i++ )
+	{
+		Cell* pC = pCell->state.neighbors[i]; 
+		if( pC->phenotype.death.dead == true )
+		{
+			counts[n+1] += 1; 
+			int code = pC->phenotype.cycle.current_phase().code; 
+			if( code == PhysiCell_constants::apoptotic )
+			{ counts[n+2] += 1; }
+			else if( code == PhysiCell_constants::necrotic_swelling || 
+				code == PhysiCell_constants::necrotic_lysed || code == PhysiCell_constants::necrotic )
+			{ counts[n+3] += 1; }
+			else
+			{ counts[n+4] += 1; }
+		} 
+		else
+		{ counts[n] += 1; } 
+		counts[ find_cell_definition_index( pC->type ) ] += 1; 
+	}
+	return; 
+}
+
+void gather_signals( std::vector<Cell*>& cells , std::vector<int>& indices , Signal_Matrix& output )
+{
+	if( &cells != &output.cells )
+	{ output.cells = cells; }
+	output.signal_indices = indices; 
+
+	int number_of_cells = output.cells.size(); 
+	int number_of_signals = indices.size(); 
+	output.values.resize( number_of_cells * number_of_signals ); 
+
+	std::vector<Signal_Accessor> accessors( number_of_signals ); 
+	bool count_contacts = false; 
+	for( int j=0; j < number_of_signals; j++ )
+	{
+		accessors[j] = Signal_Accessor( indices[j] ); 
+		if( accessors[j].kind == unknown_signal )
+		{
+			std::cout << "Warning: Requested unknown signal number " << indices[j] << " in gather_signals!" << std::endl
+			          << "         Returning 0.0, but you should fix this!" << std::endl << std::endl; 
+		}
+		if( accessors[j].kind == contact_signal )
+		{ count_contacts = true; }
+	}
+
+	#pragma omp parallel 
+	{
+		// contacts are counted once per cell, for all contact signals 
+		std::vector<double> counts; 
+
+		#pragma omp for 
+		for( int i=0; i < number_of_cells; i++ )
+		{
+			Cell* pCell = output.cells[i]; 
+			if( count_contacts )
+			{ count_cell_contacts( pCell , counts ); }
+
+			for( int j=0; j < number_of_signals; j++ )
+			{
+				double out; 
+				if( accessors[j].kind == contact_signal )
+				{
+					out = counts[ accessors[j].offset ]; 
+					out /= signal_scales[ indices[j] ]; 
+				}
+				else
+				{ out = accessors[j].value( pCell ); }
+				output.values[ j*number_of_cells + i ] = out; 
+			}
+		}
+	}
+	return; 
+}
+
+void gather_signals( std::vector<int>& indices , Signal_Matrix& output )
+{
+	output.cells.clear(); 
+	for( int i=0; i < (*all_cells).size(); i++ )
+	{
+		Cell* pCell = (*all_cells)[i]; 
+		if( pCell->phenotype.death.dead == false )
+		{ output.cells.push_back( pCell ); }
+	}
+	return gather_signals( output.cells , indices , output ); 
+}
+
+void gather_signals( std::vector<std::string>& names , Signal_Matrix& output )
+{
+	std::vector<int> indices = find_signal_indices( names ); 
+	return gather_signals( indices , output ); 
+}
+
 };
@@ -71,6 +71,29 @@
 #ifndef __PhysiCell_signal_response__
 #define __PhysiCell_signal_response__
 
+// Signal_Accessor is declared ahead of the includes: the compiled rules in 
+// PhysiCell_rules.h use it, and that header is read from PhysiCell_cell.h. 
+namespace PhysiCell{
+
+class Cell; 
+
+// a signal resolved once to a direct field read; signals without one 
+// (and the contact counts) fall back on get_single_signal 
+class Signal_Accessor
+{
+ public:
+	int signal_index; 
+	int kind; 
+	int offset; // substrate, custom variable, or contact number 
+
+	Signal_Accessor(); 
+	Signal_Accessor( int index ); 
+
+	double value( Cell* pCell ) const; 
+};
+
+}; 
+
 #include "./PhysiCell_constants.h" 
 #include "./PhysiCell_phenotype.h" 
 #include "./PhysiCell_cell.h" 
@@ -178,6 +201,28 @@ double get_single_base_behavior( Cell* pCell , std::string name ); // done
 
 double get_single_base_behavior( Cell_Definition* pCD , std::string name ); 
 
+/* batched signals (new in 1.14.3); see also Signal_Accessor above */ 
+
+// selected signals of a set of cells, stored by column: values[ j*cells.size() + i ] 
+// is signal signal_indices[j] of cells[i] 
+class Signal_Matrix
+{
+ public:
+	std::vector<int> signal_indices; 
+	std::vector<Cell*> cells; 
+	std::vector<double> values; 
+
+	double& operator()( int cell , int signal ); 
+	double* column( int signal ); 
+}; 
+
+// gather the selected signals of all live cells in one parallel pass. The 
+// output is only resized, so reusing it avoids allocation from call to call. 
+void gather_signals( std::vector<int>& indices , Signal_Matrix& output ); 
+void gather_signals( std::vector<std::string>& names , Signal_Matrix& output ); 
+// ... or of the given cells (live or dead) 
+void gather_signals( std::vector<Cell*>& cells , std::vector<int>& indices , Signal_Matrix& output ); 
+
 
 }; 
 
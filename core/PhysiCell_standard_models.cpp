@@ -621,10 +621,26 @@ void standard_update_cell_velocity( Cell* pCell, Phenotype& phenotype, double dt
 	pCell->state.simple_pressure = 0.0; 
 	pCell->state.neighbors.clear(); // new 1.8.0
 	
+	// Verlet neighbor list, when enabled and up to date (new in 1.14.3) 
+	if( pCell->get_container()->verlet_lists_are_current )
+	{
+		// out-of-domain cells are no longer in the grid walk below 
+		for( int i=0; i < pCell->verlet_neighbors.size(); i++ )
+		{
+			if( pCell->verlet_neighbors[i]->is_out_of_domain == false )
+			{ pCell->add_potentials( pCell->verlet_neighbors[i] ); }
+		}
+		
+		pCell->update_motility_vector(dt); 
+		pCell->velocity += phenotype.motility.motility_vector; 
+		return; 
+	}
+	
 	//First check the neighbors in my current voxel
-	std::vector<Cell*>::iterator neighbor;
-	std::vector<Cell*>::iterator end = pCell->get_container()->agent_grid[pCell->get_current_mechanics_voxel_index()].end();
-	for(neighbor = pCell->get_container()->agent_grid[pCell->get_current_mechanics_voxel_index()].begin(); neighbor != end; ++neighbor)
+	Cell** neighbor;
+	Cell** end;
+	pCell->get_container()->cells_in_voxel( pCell->get_current_mechanics_voxel_index() , neighbor , end ); 
+	for( ; neighbor != end; ++neighbor)
 	{
 		pCell->add_potentials(*neighbor);
 	}
@@ -639,8 +655,8 @@ void standard_update_cell_velocity( Cell* pCell, Phenotype& phenotype, double dt
 	{
 		if(!is_neighbor_voxel(pCell, pCell->get_container()->underlying_mesh.voxels[pCell->get_current_mechanics_voxel_index()].center, pCell->get_container()->underlying_mesh.voxels[*neighbor_voxel_index].center, *neighbor_voxel_index))
 			continue;
-		end = pCell->get_container()->agent_grid[*neighbor_voxel_index].end();
-		for(neighbor = pCell->get_container()->agent_grid[*neighbor_voxel_index].begin();neighbor != end; ++neighbor)
+		pCell->get_container()->cells_in_voxel( *neighbor_voxel_index , neighbor , end ); 
+		for( ; neighbor != end; ++neighbor)
 		{
 			pCell->add_potentials(*neighbor);
 		}
@@ -1191,7 +1207,6 @@ void standard_cell_cell_interactions( Cell* pCell, Phenotype& phenotype, double
 	
 	Cell* pTarget = NULL; 
 	int type = -1; 
-	std::string type_name = "none";
 	double probability = 0.0; 
 	
 	bool attacked = false; 
@@ -1202,7 +1217,6 @@ void standard_cell_cell_interactions( Cell* pCell, Phenotype& phenotype, double
 	{
 		pTarget = pCell->state.neighbors[n]; 
 		type = pTarget->type; 
-		type_name = pTarget->type_name; 
 		
 		if( pTarget->phenotype.volume.total < 1e-15 )
 		{ break; } 
@@ -1211,8 +1225,10 @@ void standard_cell_cell_interactions( Cell* pCell, Phenotype& phenotype, double
 		{
 			// ADD SPECIFIC PHAGOCYTOSIS HERE JUNE 2024 
 
-			bool apoptotic = (bool) get_single_signal( pTarget , "apoptotic" ); 
-			bool necrotic = (bool) get_single_signal( pTarget , "necrotic" ); 
+			static int apoptotic_index = find_signal_index( "apoptotic" ); 
+			static int necrotic_index = find_signal_index( "necrotic" ); 
+			bool apoptotic = (bool) get_single_signal( pTarget , apoptotic_index ); 
+			bool necrotic = (bool) get_single_signal( pTarget , necrotic_index ); 
 			bool other = !(apoptotic || necrotic); // neither apoptotic nor necrotic 
 
 			// apoptotic phagocytosis 
@@ -1246,7 +1262,7 @@ void standard_cell_cell_interactions( Cell* pCell, Phenotype& phenotype, double
 		{
 			// live phagocytosis
 			// assume you can only phagocytose one at a time for now 
-			probability = phenotype.cell_interactions.live_phagocytosis_rate(type_name) * dt; // s[type] * dt;  
+			probability = phenotype.cell_interactions.live_phagocytosis_rate(type) * dt; // s[type] * dt;  
 			if( UniformRandom() < probability && phagocytosed == false ) 
 			{
 				pCell->ingest_cell(pTarget);
@@ -1257,8 +1273,8 @@ void standard_cell_cell_interactions( Cell* pCell, Phenotype& phenotype, double
 			// assume you can only attack one cell at a time 
 			// probability = phenotype.cell_interactions.attack_rate(type_name)*dt; // s[type] * dt;  
 
-			double attack_ij = phenotype.cell_interactions.attack_rate(type_name); 
-			double immunogenicity_ji = pTarget->phenotype.cell_interactions.immunogenicity(pCell->type_name); 
+			double attack_ij = phenotype.cell_interactions.attack_rate(type); 
+			double immunogenicity_ji = pTarget->phenotype.cell_interactions.immunogenicity(pCell->type); 
 
 			// probability of STARTING an attack 
 			probability = attack_ij * immunogenicity_ji * dt; 
@@ -1306,7 +1322,7 @@ void standard_cell_cell_interactions( Cell* pCell, Phenotype& phenotype, double
 			
 			// fusion 
 			// assume you can only fuse once cell at a time 
-			probability = phenotype.cell_interactions.fusion_rate(type_name)*dt; // s[type] * dt;  
+			probability = phenotype.cell_interactions.fusion_rate(type)*dt; // s[type] * dt;  
 			if( UniformRandom() < probability && fused == false  ) 
 			{
 				pCell->fuse_cell(pTarget);
@@ -1447,7 +1463,7 @@ void dynamic_attachments( Cell* pCell , Phenotype& phenotype, double dt )
         {
             // std::string search_string = "adhesive affinity to " + pTest->type_name; 
             // double affinity = get_single_behavior( pCell , search_string );
-			double affinity = phenotype.mechanics.cell_adhesion_affinity(pTest->type_name); 
+			double affinity = phenotype.mechanics.cell_adhesion_affinity(pTest->type); 
 
             double prob = attachment_probability * affinity; 
             if( UniformRandom() <= prob )
@@ -1489,7 +1505,7 @@ void dynamic_spring_attachments( Cell* pCell , Phenotype& phenotype, double dt )
         {
             // std::string search_string = "adhesive affinity to " + pTest->type_name; 
             // double affinity = get_single_behavior( pCell , search_string );
-			double affinity = phenotype.mechanics.cell_adhesion_affinity(pTest->type_name); 
+			double affinity = phenotype.mechanics.cell_adhesion_affinity(pTest->type); 
 
             double prob = attachment_probability * affinity; 
             if( UniformRandom() <= prob )
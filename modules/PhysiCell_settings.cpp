@@ -269,6 +269,64 @@ void PhysiCell_Settings::read_from_pugixml( void )
 			PhysiCell_settings.disable_automated_spring_adhesions = true;
 		}
 
+		settings = xml_get_bool_value(node_options, "sorted_cell_list");
+		if (settings)
+		{
+			std::cout << "Using a sorted (CSR) cell list for mechanics" << std::endl;
+			PhysiCell_settings.enable_sorted_cell_list = true;
+			
+			if( xml_get_bool_value(node_options, "sort_cells_by_voxel") )
+			{
+				std::cout << "Sorting all cells by mechanics voxel" << std::endl;
+				PhysiCell_settings.sort_cells_by_voxel = true;
+			}
+		}
+
+		settings = xml_get_bool_value(node_options, "verlet_lists");
+		if (settings)
+		{
+			PhysiCell_settings.enable_verlet_lists = true;
+			if( xml_find_node(node_options, "verlet_skin") )
+			{ PhysiCell_settings.verlet_skin = xml_get_double_value(node_options, "verlet_skin"); }
+			std::cout << "Using Verlet neighbor lists for mechanics (skin: " 
+				<< PhysiCell_settings.verlet_skin << " " << PhysiCell_settings.space_units << ")" << std::endl;
+		}
+
+		settings = xml_get_bool_value(node_options, "pairwise_mechanics");
+		if (settings)
+		{
+			std::cout << "Using pairwise (symmetric) mechanics" << std::endl;
+			PhysiCell_settings.enable_pairwise_mechanics = true;
+			if( PhysiCell_settings.enable_verlet_lists )
+			{ std::cout << "Warning: pairwise mechanics replaces the Verlet neighbor lists" << std::endl; }
+		}
+
+		settings = xml_get_bool_value(node_options, "event_driven_phenotype");
+		if (settings)
+		{
+			std::cout << "Using event-driven cycle and death scheduling" << std::endl;
+			PhysiCell_settings.enable_event_driven_phenotype = true;
+		}
+
+		settings = xml_get_bool_value(node_options, "event_driven_exponential_times");
+		if (settings)
+		{
+			if( PhysiCell_settings.enable_event_driven_phenotype )
+			{
+				std::cout << "Using exponential waiting times for cycle and death events" << std::endl;
+				PhysiCell_settings.event_driven_exponential_times = true;
+			}
+			else
+			{ std::cout << "Warning: event_driven_exponential_times requires event_driven_phenotype; ignored" << std::endl; }
+		}
+
+		settings = xml_get_bool_value(node_options, "recycle_cells");
+		if (settings)
+		{
+			std::cout << "Recycling deleted cells" << std::endl;
+			PhysiCell_settings.enable_cell_recycling = true;
+		}
+
 		pugi::xml_node random_seed_node = xml_find_node(node_options, "random_seed");
 		std::string random_seed = ""; // default is system clock, even if this element is not present
 		if (random_seed_node)
@@ -727,6 +785,12 @@ bool setup_microenvironment_from_XML( pugi::xml_node root_node )
 			xml_get_double_value( node1, "diffusion_coefficient" ); 
 		microenvironment.decay_rates[i] = 
 			xml_get_double_value( node1, "decay_rate" ); 
+		// optional (new in 1.14.3): only diffuse this substrate on every k-th step 
+		if( xml_find_node( node1 , "diffusion_step_multiplier" ) )
+		{ microenvironment.set_diffusion_step_multiplier( i , xml_get_int_value( node1, "diffusion_step_multiplier" ) ); }
+		// optional (new in 1.14.3): solve less often once the relative change per step is below this 
+		if( xml_find_node( node1 , "quasi_static_tolerance" ) )
+		{ microenvironment.set_quasi_static_tolerance( i , xml_get_double_value( node1, "quasi_static_tolerance" ) ); }
 			
 		// now, get the initial value  
 		node1 = xml_find_node( node, "initial_condition" ); 
@@ -951,6 +1015,27 @@ bool setup_microenvironment_from_XML( pugi::xml_node root_node )
 	// track internalized substrates in each agent? 
 	default_microenvironment_options.track_internalized_substrates_in_each_agent 
 		= xml_get_bool_value( node, "track_internalized_substrates_in_each_agent" );
+	
+	// diffusion solver (new in 1.14.3): LOD (default), vectorized_LOD, tiled_LOD, variable_LOD, active_region_LOD, multigrid, or auto 
+	// (multigrid is a steady-state / quasi-static option, not a faster time stepper) 
+	if( xml_find_node( node , "diffusion_solver" ) )
+	{ default_microenvironment_options.diffusion_solver = xml_get_string_value( node, "diffusion_solver" ); }
+	
+	// gradient mode (new in 1.14.3): all_voxels (default), occupied_voxels, or on_demand 
+	if( xml_find_node( node , "gradient_mode" ) )
+	{ default_microenvironment_options.gradient_mode = gradient_mode_from_name( xml_get_string_value( node, "gradient_mode" ) ); }
+	
+	// largest step factor of the quasi-static diffusion mode (new in 1.14.3) 
+	if( xml_find_node( node , "quasi_static_max_factor" ) )
+	{ default_microenvironment_options.quasi_static_max_factor = xml_get_int_value( node, "quasi_static_max_factor" ); }
+	
+	// tiles of the active-region LOD solver (new in 1.14.3) 
+	if( xml_find_node( node , "active_region_tile_size" ) )
+	{ default_microenvironment_options.active_region_tile_size = xml_get_int_value( node, "active_region_tile_size" ); }
+	if( xml_find_node( node , "active_region_tolerance" ) )
+	{ default_microenvironment_options.active_region_tolerance = xml_get_double_value( node, "active_region_tolerance" ); }
+	if( xml_find_node( node , "active_region_refresh_interval" ) )
+	{ default_microenvironment_options.active_region_refresh_interval = xml_get_int_value( node, "active_region_refresh_interval" ); }
 
 	node = xml_find_node(node, "initial_condition");
 	if (node)
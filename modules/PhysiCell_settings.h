@@ -115,6 +115,26 @@ class PhysiCell_Settings
 
 	bool disable_automated_spring_adhesions = false; 
 	
+	// compact (CSR) cell list for the mechanics neighbor loops -- new in 1.14.3 
+	bool enable_sorted_cell_list = false; 
+	bool sort_cells_by_voxel = false; 
+	
+	// Verlet neighbor lists for mechanics -- new in 1.14.3 
+	bool enable_verlet_lists = false; 
+	double verlet_skin = 2.0; 
+	
+	// visit each pair of cells once in mechanics -- new in 1.14.3 
+	bool enable_pairwise_mechanics = false; 
+	
+	// event-driven cycle and death scheduling -- new in 1.14.3. Exponential 
+	// waiting times change the per-step event probability from rate*dt to 
+	// 1-exp(-rate*dt). 
+	bool enable_event_driven_phenotype = false; 
+	bool event_driven_exponential_times = false; 
+	
+	// reuse deleted Cell objects and their vectors -- new in 1.14.3 
+	bool enable_cell_recycling = false; 
+	
 	double SVG_save_interval = 60; 
 	bool enable_SVG_saves = true; 
 
@@ -155,6 +175,7 @@ class PhysiCell_Globals
 	int full_output_index = 0; 
 	int SVG_output_index = 0; 
 	int intracellular_output_index = 0; 
+	int phenotype_step = 0; // counted by the event-driven phenotype (new in 1.14.3) 
 };
 
 template <class T> 
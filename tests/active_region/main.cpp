@@ -0,0 +1,202 @@
+/*
+###############################################################################
+# If you use PhysiCell in your project, please cite PhysiCell and the version #
+# number, such as below:                                                      #
+#                                                                             #
+# We implemented and solved the model using PhysiCell (Version x.y.z) [1].    #
+#                                                                             #
+# [1] A Ghaffarizadeh, R Heiland, SH Friedman, SM Mumenthaler, and P Macklin, #
+#     PhysiCell: an Open Source Physics-Based Cell Simulator for Multicellu-  #
+#     lar Systems, PLoS Comput. Biol. 14(2): e1005991, 2018                   #
+#     DOI: 10.1371/journal.pcbi.1005991                                       #
+#                                                                             #
+# See VERSION.txt or call get_PhysiCell_version() to get the current version  #
+#     x.y.z. Call display_citations() to get detailed information on all cite-#
+#     able software used in your PhysiCell application.                       #
+#                                                                             #
+# Because PhysiCell extensively uses BioFVM, we suggest you also cite BioFVM  #
+#     as below:                                                               #
+#                                                                             #
+# We implemented and solved the model using PhysiCell (Version x.y.z) [1],    #
+# with BioFVM [2] to solve the transport equations.                           #
+#                                                                             #
+# [1] A Ghaffarizadeh, R Heiland, SH Friedman, SM Mumenthaler, and P Macklin, #
+#     PhysiCell: an Open Source Physics-Based Cell Simulator for Multicellu-  #
+#     lar Systems, PLoS Comput. Biol. 14(2): e1005991, 2018                   #
+#     DOI: 10.1371/journal.pcbi.1005991                                       #
+#                                                                             #
+# [2] A Ghaffarizadeh, SH Friedman, and P Macklin, BioFVM: an efficient para- #
+#     llelized diffusive transport solver for 3-D biological simulations,     #
+#     Bioinformatics 32(8): 1256-8, 2016. DOI: 10.1093/bioinformatics/btv730  #
+#                                                                             #
+###############################################################################
+#                                                                             #
+# BSD 3-Clause License (see https://opensource.org/licenses/BSD-3-Clause)     #
+#                                                                             #
+# Copyright (c) 2015-2018, Paul Macklin and the PhysiCell Project             #
+# All rights reserved.                                                        #
+#                                                                             #
+# Redistribution and use in source and binary forms, with or without          #
+# modification, are permitted provided that the following conditions are met: #
+#                                                                             #
+# 1. Redistributions of source code must retain the above copyright notice,   #
+# this list of conditions and the following disclaimer.                       #
+#                                                                             #
+# 2. Redistributions in binary form must reproduce the above copyright        #
+# notice, this list of conditions and the following disclaimer in the         #
+# documentation and/or other materials provided with the distribution.        #
+#                                                                             #
+# 3. Neither the name of the copyright holder nor the names of its            #
+# contributors may be used to endorse or promote products derived from this   #
+# software without specific prior written permission.                         #
+#                                                                             #
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" #
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   #
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  #
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   #
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         #
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        #
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    #
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     #
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     #
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  #
+# POSSIBILITY OF SUCH DAMAGE.                                                 #
+#                                                                             #
+###############################################################################
+*/
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+#include "../../BioFVM/BioFVM.h" 
+
+// Accuracy and speed of the active-region LOD solver on a mostly empty 
+// domain: a small ball of agents (consuming oxygen, secreting a signal) 
+// in a cube held at Dirichlet values on all faces, with a second ball 
+// placed halfway through so the active region has to grow. Compare to 
+// the full LOD_3D solver on the same problem. 
+//
+// usage: ./active_region_tests [voxels per side] [steps] [tile size] 
+
+int nodes = 64; 
+int steps = 200; 
+int tile_size = 8; 
+double dt = 0.01; 
+double oxygen_boundary = 38.0; 
+double tolerance = 1e-3; // relative to the largest density 
+
+void setup( BioFVM::Microenvironment& M , void (*solver)( BioFVM::Microenvironment& , double ) ) 
+{
+	M.set_density( 0 , "oxygen" , "mmHg" , 1e5 , 0.0 ); 
+	M.add_density( "signal" , "dimensionless" , 1e3 , 0.01 ); 
+	
+	double L = 10.0 * nodes; 
+	M.resize_space( -L , L , -L , L , -L , L , 20.0 , 20.0 , 20.0 ); 
+	M.diffusion_decay_solver = solver; 
+	M.set_active_region_parameters( tile_size , 1e-6 , 100 ); 
+	
+	std::vector<double> boundary_values = { oxygen_boundary , 0.0 }; 
+	for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+	{
+		M(n) = boundary_values; 
+		std::vector<double>& center = M.mesh.voxels[n].center; 
+		if( fabs( center[0] ) > L-20.0 || fabs( center[1] ) > L-20.0 || fabs( center[2] ) > L-20.0 )
+		{ M.add_dirichlet_node( n , boundary_values ); }
+	}
+	return; 
+}
+
+// agents on a lattice inside a ball 
+void place_agents( BioFVM::Microenvironment& M , std::vector<double> center , double radius , 
+	std::vector<BioFVM::Basic_Agent*>& agents )
+{
+	for( double x=-radius ; x <= radius ; x += 20.0 )
+	{
+		for( double y=-radius ; y <= radius ; y += 20.0 )
+		{
+			for( double z=-radius ; z <= radius ; z += 20.0 )
+			{
+				if( x*x + y*y + z*z > radius*radius )
+				{ continue; }
+				BioFVM::Basic_Agent* pAgent = BioFVM::create_basic_agent(); 
+				pAgent->register_microenvironment( &M ); 
+				pAgent->assign_position( center[0]+x , center[1]+y , center[2]+z ); 
+				(*pAgent->uptake_rates)[0] = 10.0; 
+				(*pAgent->secretion_rates)[1] = 1.0; 
+				(*pAgent->saturation_densities)[1] = 1.0; 
+				pAgent->set_internal_uptake_constants( dt ); 
+				agents.push_back( pAgent ); 
+			}
+		}
+	}
+	return; 
+}
+
+double run( BioFVM::Microenvironment& M , double& active_fraction )
+{
+	std::vector<BioFVM::Basic_Agent*> agents; 
+	place_agents( M , { 0.0 , 0.0 , 0.0 } , 60.0 , agents ); 
+	
+	active_fraction = 0.0; 
+	auto start = std::chrono::steady_clock::now();
+	for( int i=0 ; i < steps ; i++ )
+	{
+		if( i == steps/2 )
+		{ place_agents( M , { 150.0 , 0.0 , 0.0 } , 40.0 , agents ); }
+		M.simulate_diffusion_decay( dt ); 
+		M.simulate_cell_sources_and_sinks( agents , dt ); 
+		active_fraction += M.active_region_fraction(); 
+	}
+	auto end = std::chrono::steady_clock::now();
+	active_fraction /= steps; 
+	
+	for( unsigned int a=0 ; a < agents.size() ; a++ )
+	{ BioFVM::delete_basic_agent( agents[a]->index ); }
+	return std::chrono::duration<double>( end - start ).count(); 
+}
+
+int main( int argc, char* argv[] )
+{
+	if( argc > 1 )
+	{ nodes = atoi( argv[1] ); }
+	if( argc > 2 )
+	{ steps = atoi( argv[2] ); }
+	if( argc > 3 )
+	{ tile_size = atoi( argv[3] ); }
+
+	std::cout << ">>>>>>>>>  Active-region LOD tests: " << nodes << "^3 voxels, " << steps 
+		<< " steps, " << tile_size << "^3-voxel tiles" << std::endl; 
+	
+	double fraction; 
+	BioFVM::Microenvironment reference; 
+	setup( reference , BioFVM::diffusion_decay_solver__constant_coefficients_LOD_3D ); 
+	double reference_time = run( reference , fraction ); 
+	
+	BioFVM::Microenvironment M; 
+	setup( M , BioFVM::diffusion_decay_solver__constant_coefficients_LOD_active_region ); 
+	double time = run( M , fraction ); 
+	
+	int failures = 0; 
+	printf( "\n%-14s %10s %9s %16s\n" , "solver" , "time (s)" , "speedup" , "active tiles" ); 
+	printf( "%-14s %10.3f %9.2f %16s\n" , "LOD_3D" , reference_time , 1.0 , "" ); 
+	printf( "%-14s %10.3f %9.2f %15.1f%%\n\n" , "active_region" , time , reference_time / time , 100.0*fraction ); 
+	
+	std::vector<double> scale = { oxygen_boundary , 1.0 }; 
+	std::vector<std::string> names = { "oxygen" , "signal" }; 
+	for( int q=0 ; q < 2 ; q++ )
+	{
+		double difference = 0.0; 
+		for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+		{ difference = std::max( difference , fabs( M(n)[q] - reference(n)[q] ) ); }
+		difference /= scale[q]; 
+		printf( "%-8s max rel. diff %.3e %s\n" , names[q].c_str() , difference , 
+			difference <= tolerance ? "" : "FAILED" ); 
+		if( difference > tolerance )
+		{ failures++; }
+	}
+	
+	return failures; 
+}
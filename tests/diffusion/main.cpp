@@ -0,0 +1,309 @@
+/*
+###############################################################################
+# If you use PhysiCell in your project, please cite PhysiCell and the version #
+# number, such as below:                                                      #
+#                                                                             #
+# We implemented and solved the model using PhysiCell (Version x.y.z) [1].    #
+#                                                                             #
+# [1] A Ghaffarizadeh, R Heiland, SH Friedman, SM Mumenthaler, and P Macklin, #
+#     PhysiCell: an Open Source Physics-Based Cell Simulator for Multicellu-  #
+#     lar Systems, PLoS Comput. Biol. 14(2): e1005991, 2018                   #
+#     DOI: 10.1371/journal.pcbi.1005991                                       #
+#                                                                             #
+# See VERSION.txt or call get_PhysiCell_version() to get the current version  #
+#     x.y.z. Call display_citations() to get detailed information on all cite-#
+#     able software used in your PhysiCell application.                       #
+#                                                                             #
+# Because PhysiCell extensively uses BioFVM, we suggest you also cite BioFVM  #
+#     as below:                                                               #
+#                                                                             #
+# We implemented and solved the model using PhysiCell (Version x.y.z) [1],    #
+# with BioFVM [2] to solve the transport equations.                           #
+#                                                                             #
+# [1] A Ghaffarizadeh, R Heiland, SH Friedman, SM Mumenthaler, and P Macklin, #
+#     PhysiCell: an Open Source Physics-Based Cell Simulator for Multicellu-  #
+#     lar Systems, PLoS Comput. Biol. 14(2): e1005991, 2018                   #
+#     DOI: 10.1371/journal.pcbi.1005991                                       #
+#                                                                             #
+# [2] A Ghaffarizadeh, SH Friedman, and P Macklin, BioFVM: an efficient para- #
+#     llelized diffusive transport solver for 3-D biological simulations,     #
+#     Bioinformatics 32(8): 1256-8, 2016. DOI: 10.1093/bioinformatics/btv730  #
+#                                                                             #
+###############################################################################
+#                                                                             #
+# BSD 3-Clause License (see https://opensource.org/licenses/BSD-3-Clause)     #
+#                                                                             #
+# Copyright (c) 2015-2018, Paul Macklin and the PhysiCell Project             #
+# All rights reserved.                                                        #
+#                                                                             #
+# Redistribution and use in source and binary forms, with or without          #
+# modification, are permitted provided that the following conditions are met: #
+#                                                                             #
+# 1. Redistributions of source code must retain the above copyright notice,   #
+# this list of conditions and the following disclaimer.                       #
+#                                                                             #
+# 2. Redistributions in binary form must reproduce the above copyright        #
+# notice, this list of conditions and the following disclaimer in the         #
+# documentation and/or other materials provided with the distribution.        #
+#                                                                             #
+# 3. Neither the name of the copyright holder nor the names of its            #
+# contributors may be used to endorse or promote products derived from this   #
+# software without specific prior written permission.                         #
+#                                                                             #
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" #
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   #
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  #
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   #
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         #
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        #
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    #
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     #
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     #
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  #
+# POSSIBILITY OF SUCH DAMAGE.                                                 #
+#                                                                             #
+###############################################################################
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+#include "../../BioFVM/BioFVM.h" 
+
+// Compare the fast LOD variants against the reference 3-D LOD solver on the 
+// same problem: a cube of voxels, several substrates with very different 
+// diffusion lengths, and Dirichlet conditions on the x-min face. Then check 
+// the variable-coefficient LOD solver on anisotropic voxels and on a 
+// layered diffusion coefficient. 
+//
+// usage: ./diffusion_tests [voxels per side] [substrates] [steps] 
+
+int nodes = 100; 
+int substrates = 6; 
+int steps = 20; 
+double dt = 0.01; 
+double tolerance = 1e-12; // relative to the largest density 
+
+struct Solver_Run
+{
+	std::string name; 
+	void (*solver)( BioFVM::Microenvironment& , double ); 
+	// store the (uniform) diffusion coefficients per voxel 
+	bool voxel_field; 
+}; 
+
+double run_solver( Solver_Run& run , std::vector< std::vector<double> >& result )
+{
+	BioFVM::Microenvironment M; 
+	M.name = run.name; 
+	M.set_density( 0 , "substrate0" , "dimensionless" , 1e5 , 0.1 ); 
+	for( int q=1 ; q < substrates ; q++ )
+	{
+		M.add_density( "substrate" + std::to_string(q) , "dimensionless" , 
+			1e5 / pow( 10.0 , q ) , 0.1*q ); 
+	}
+	
+	double L = 10.0 * nodes; 
+	M.resize_space( -L , L , -L , L , -L , L , 20.0 , 20.0 , 20.0 ); 
+	M.diffusion_decay_solver = run.solver; 
+	if( run.voxel_field )
+	{
+		for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+		{
+			for( int q=0 ; q < substrates ; q++ )
+			{ M.set_diffusion_coefficient( n , q , M.diffusion_coefficients[q] ); }
+		}
+	}
+	
+	// smooth but non-trivial initial condition 
+	for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+	{
+		std::vector<double>& center = M.mesh.voxels[n].center; 
+		for( int q=0 ; q < substrates ; q++ )
+		{ M(n)[q] = 1.0 + 0.5*sin( 0.01*(q+1)*center[0] ) * cos( 0.02*center[1] + 0.003*q*center[2] ); }
+	}
+	
+	std::vector<double> boundary_values( substrates , 2.0 ); 
+	std::vector<bool> boundary_activation( substrates , true ); 
+	boundary_activation[ substrates-1 ] = false; 
+	for( unsigned int k=0 ; k < M.mesh.z_coordinates.size() ; k++ )
+	{
+		for( unsigned int j=0 ; j < M.mesh.y_coordinates.size() ; j++ )
+		{
+			int n = M.voxel_index( 0 , j , k ); 
+			M.add_dirichlet_node( n , boundary_values ); 
+			M.set_substrate_dirichlet_activation( n , boundary_activation ); 
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for( int i=0 ; i < steps ; i++ )
+	{ M.simulate_diffusion_decay( dt ); }
+	auto end = std::chrono::steady_clock::now();
+	
+	result.resize( M.number_of_voxels() ); 
+	for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+	{ result[n] = M(n); }
+	
+	return std::chrono::duration<double>( end - start ).count(); 
+}
+
+// A field that only varies along y must not depend on dx or dz: solve it on 
+// 20 x 40 x 100 voxels with a solver that uses each axis's spacing (the 
+// variable-coefficient or the sub-cycled one) and on 40^3 voxels with the 
+// reference solver. 
+
+int anisotropic_test( void (*anisotropic_solver)( BioFVM::Microenvironment& , double ) , std::string name )
+{
+	std::vector< std::vector<double> > results[2]; 
+	std::vector<int> y_indices[2]; 
+	double spacing[2][3] = { { 20.0 , 40.0 , 100.0 } , { 40.0 , 40.0 , 40.0 } }; 
+	
+	for( int m=0 ; m < 2 ; m++ )
+	{
+		BioFVM::Microenvironment M; 
+		M.set_density( 0 , "substrate0" , "dimensionless" , 1e4 , 0.1 ); 
+		M.add_density( "substrate1" , "dimensionless" , 1e3 , 1.0 ); 
+		M.resize_space( -200 , 200 , -400 , 400 , -500 , 500 , spacing[m][0] , spacing[m][1] , spacing[m][2] ); 
+		M.diffusion_decay_solver = ( m == 0 ) ? anisotropic_solver 
+			: BioFVM::diffusion_decay_solver__constant_coefficients_LOD_3D; 
+		
+		int nx = M.mesh.x_coordinates.size(); 
+		int ny = M.mesh.y_coordinates.size(); 
+		for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+		{
+			double y = M.mesh.voxels[n].center[1]; 
+			M(n)[0] = 1.0 + 0.5*sin( 0.01*y ); 
+			M(n)[1] = ( y > 0 ) ? 1.0 : 0.0; 
+			y_indices[m].push_back( ( n / nx ) % ny ); 
+		}
+		
+		for( int i=0 ; i < steps ; i++ )
+		{ M.simulate_diffusion_decay( dt ); }
+		
+		// one row of voxels per y index 
+		results[m].assign( ny , std::vector<double>() ); 
+		for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+		{ results[m][ y_indices[m][n] ] = M(n); }
+	}
+	
+	double difference = 0.0; 
+	for( unsigned int j=0 ; j < results[0].size() ; j++ )
+	{ difference = std::max( difference , BioFVM::max_abs_difference( results[0][j] , results[1][j] ) ); }
+	
+	printf( "anisotropic voxels (20 x 40 x 100) vs 40^3, %s: max diff %.3e %s\n" , 
+		name.c_str() , difference , difference <= 1e-10 ? "" : "FAILED" ); 
+	return ( difference <= 1e-10 ) ? 0 : 1; 
+}
+
+// A line of voxels with D = 1000 in the left half and D = 10 in the right: 
+// one step must solve the backward Euler system with harmonic face 
+// coefficients, (1 + r- + r+) u_i - r- u_{i-1} - r+ u_{i+1} = old u_i, with 
+// r = dt D_face / dx^2. Setting the field must switch any constant-coefficient 
+// solver (the starting solver) to the variable one. 
+
+int layered_test( void (*starting_solver)( BioFVM::Microenvironment& , double ) , std::string name )
+{
+	BioFVM::Microenvironment M; 
+	M.set_density( 0 , "substrate0" , "dimensionless" , 1000.0 , 0.0 ); 
+	M.resize_space( 0 , 800 , 0 , 20 , 0 , 20 , 20.0 , 20.0 , 20.0 ); 
+	M.diffusion_decay_solver = starting_solver; 
+	int nx = M.number_of_voxels(); 
+	double step_dt = 10.0; 
+	
+	std::vector<double> coefficients( nx , 1000.0 ); 
+	std::vector<double> old_values( nx , 0.0 ); 
+	for( int n=0 ; n < nx ; n++ )
+	{
+		if( n >= nx/2 )
+		{ coefficients[n] = 10.0; }
+		old_values[n] = ( n % 7 < 3 ) ? 1.0 : 0.25; 
+		M.set_diffusion_coefficient( n , 0 , coefficients[n] ); 
+		M(n)[0] = old_values[n]; 
+	}
+	
+	M.simulate_diffusion_decay( step_dt ); 
+	
+	double residual = 0.0; 
+	for( int n=0 ; n < nx ; n++ )
+	{
+		double r_minus = 0.0; 
+		double r_plus = 0.0; 
+		if( n > 0 )
+		{ r_minus = step_dt / 400.0 * 2.0*coefficients[n-1]*coefficients[n] / ( coefficients[n-1] + coefficients[n] ); }
+		if( n < nx-1 )
+		{ r_plus = step_dt / 400.0 * 2.0*coefficients[n]*coefficients[n+1] / ( coefficients[n] + coefficients[n+1] ); }
+		
+		double row = ( 1.0 + r_minus + r_plus )*M(n)[0] - old_values[n]; 
+		if( n > 0 )
+		{ row -= r_minus*M(n-1)[0]; }
+		if( n < nx-1 )
+		{ row -= r_plus*M(n+1)[0]; }
+		residual = std::max( residual , fabs( row ) ); 
+	}
+	
+	bool switched = ( M.diffusion_decay_solver == BioFVM::diffusion_decay_solver__variable_coefficients_LOD_3D ); 
+	bool passed = ( residual <= 1e-10 && switched ); 
+	printf( "layered diffusion coefficient (1000 | 10), from %s: max residual %.3e %s\n" , 
+		name.c_str() , residual , passed ? "" : "FAILED" ); 
+	return passed ? 0 : 1; 
+}
+
+int main( int argc, char* argv[] )
+{
+	if( argc > 1 )
+	{ nodes = atoi( argv[1] ); }
+	if( argc > 2 )
+	{ substrates = atoi( argv[2] ); }
+	if( argc > 3 )
+	{ steps = atoi( argv[3] ); }
+
+	std::cout << ">>>>>>>>>  Diffusion solver tests: " << nodes << "^3 voxels, " 
+		<< substrates << " substrates, " << steps << " steps" << std::endl; 
+
+	std::vector<Solver_Run> runs = { 
+		{ "LOD_3D (reference)" , BioFVM::diffusion_decay_solver__constant_coefficients_LOD_3D }, 
+		{ "LOD_3D_vectorized" , BioFVM::diffusion_decay_solver__constant_coefficients_LOD_3D_vectorized }, 
+		{ "LOD_3D_tiled" , BioFVM::diffusion_decay_solver__constant_coefficients_LOD_3D_tiled }, 
+		{ "LOD_subcycled (all k=1)" , BioFVM::diffusion_decay_solver__constant_coefficients_LOD_subcycled }, 
+		{ "variable_LOD" , BioFVM::diffusion_decay_solver__variable_coefficients_LOD_3D }, 
+		{ "variable_LOD (voxel field)" , BioFVM::diffusion_decay_solver__variable_coefficients_LOD_3D , true } 
+	}; 
+	
+	std::vector< std::vector<double> > reference; 
+	std::vector< std::vector<double> > result; 
+	double reference_time = run_solver( runs[0] , reference ); 
+	
+	double scale = 0.0; 
+	for( unsigned int n=0 ; n < reference.size() ; n++ )
+	{ scale = std::max( scale , BioFVM::maxabs( reference[n] ) ); }
+
+	int failures = 0; 
+	printf( "%-26s %10s %9s %14s\n" , "solver" , "time (s)" , "speedup" , "max rel. diff" ); 
+	printf( "%-26s %10.3f %9.2f %14s\n" , runs[0].name.c_str() , reference_time , 1.0 , "-" ); 
+	for( unsigned int r=1 ; r < runs.size() ; r++ )
+	{
+		double time = run_solver( runs[r] , result ); 
+		double difference = 0.0; 
+		for( unsigned int n=0 ; n < reference.size() ; n++ )
+		{ difference = std::max( difference , BioFVM::max_abs_difference( reference[n] , result[n] ) ); }
+		difference /= scale; 
+		
+		printf( "%-26s %10.3f %9.2f %14.3e %s\n" , runs[r].name.c_str() , time , reference_time / time , 
+			difference , difference <= tolerance ? "" : "FAILED" ); 
+		if( difference > tolerance )
+		{ failures++; }
+	}
+	
+	failures += anisotropic_test( BioFVM::diffusion_decay_solver__variable_coefficients_LOD_3D , "variable_LOD" ); 
+	failures += anisotropic_test( BioFVM::diffusion_decay_solver__constant_coefficients_LOD_subcycled , "LOD_subcycled" ); 
+	failures += layered_test( BioFVM::diffusion_decay_solver__constant_coefficients_LOD_3D , "LOD" ); 
+	failures += layered_test( BioFVM::diffusion_decay_solver__constant_coefficients_multigrid , "multigrid" ); 
+	failures += layered_test( BioFVM::diffusion_decay_solver__constant_coefficients_LOD_active_region , "active_region_LOD" ); 
+	
+	return failures; 
+}
@@ -0,0 +1,249 @@
+/*
+###############################################################################
+# If you use PhysiCell in your project, please cite PhysiCell and the version #
+# number, such as below:                                                      #
+#                                                                             #
+# We implemented and solved the model using PhysiCell (Version x.y.z) [1].    #
+#                                                                             #
+# [1] A Ghaffarizadeh, R Heiland, SH Friedman, SM Mumenthaler, and P Macklin, #
+#     PhysiCell: an Open Source Physics-Based Cell Simulator for Multicellu-  #
+#     lar Systems, PLoS Comput. Biol. 14(2): e1005991, 2018                   #
+#     DOI: 10.1371/journal.pcbi.1005991                                       #
+#                                                                             #
+# See VERSION.txt or call get_PhysiCell_version() to get the current version  #
+#     x.y.z. Call display_citations() to get detailed information on all cite-#
+#     able software used in your PhysiCell application.                       #
+#                                                                             #
+# Because PhysiCell extensively uses BioFVM, we suggest you also cite BioFVM  #
+#     as below:                                                               #
+#                                                                             #
+# We implemented and solved the model using PhysiCell (Version x.y.z) [1],    #
+# with BioFVM [2] to solve the transport equations.                           #
+#                                                                             #
+# [1] A Ghaffarizadeh, R Heiland, SH Friedman, SM Mumenthaler, and P Macklin, #
+#     PhysiCell: an Open Source Physics-Based Cell Simulator for Multicellu-  #
+#     lar Systems, PLoS Comput. Biol. 14(2): e1005991, 2018                   #
+#     DOI: 10.1371/journal.pcbi.1005991                                       #
+#                                                                             #
+# [2] A Ghaffarizadeh, SH Friedman, and P Macklin, BioFVM: an efficient para- #
+#     llelized diffusive transport solver for 3-D biological simulations,     #
+#     Bioinformatics 32(8): 1256-8, 2016. DOI: 10.1093/bioinformatics/btv730  #
+#                                                                             #
+###############################################################################
+#                                                                             #
+# BSD 3-Clause License (see https://opensource.org/licenses/BSD-3-Clause)     #
+#                                                                             #
+# Copyright (c) 2015-2018, Paul Macklin and the PhysiCell Project             #
+# All rights reserved.                                                        #
+#                                                                             #
+# Redistribution and use in source and binary forms, with or without          #
+# modification, are permitted provided that the following conditions are met: #
+#                                                                             #
+# 1. Redistributions of source code must retain the above copyright notice,   #
+# this list of conditions and the following disclaimer.                       #
+#                                                                             #
+# 2. Redistributions in binary form must reproduce the above copyright        #
+# notice, this list of conditions and the following disclaimer in the         #
+# documentation and/or other materials provided with the distribution.        #
+#                                                                             #
+# 3. Neither the name of the copyright holder nor the names of its            #
+# contributors may be used to endorse or promote products derived from this   #
+# software without specific prior written permission.                         #
+#                                                                             #
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" #
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   #
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  #
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   #
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         #
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        #
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    #
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     #
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     #
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  #
+# POSSIBILITY OF SUCH DAMAGE.                                                 #
+#                                                                             #
+###############################################################################
+*/
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include "../../core/PhysiCell.h" 
+#include "../../modules/PhysiCell_standard_modules.h" 
+
+using namespace BioFVM; 
+using namespace PhysiCell; 
+
+// Times whole cell update steps (Cell_Container::update_all_cells: secretion, 
+// phenotype, mechanics and motion) with <event_driven_phenotype> off and on, 
+// for three populations of default cells: 
+//   0 quiescent     : rare cycle entry, no phenotype function 
+//   1 proliferating : default Ki67 advanced rates, no phenotype function 
+//   2 oxygen-driven : update_cell_and_death_parameters_O2_based, with a slow 
+//                     uptake, so that the rates change at every step 
+// Without a population, run all of them in both modes, and check that both 
+// modes give the same expected numbers of divisions and deaths. 
+// 
+// The memory layout of the cells changes the step time by up to 25% (fresh 
+// cells vs. cells allocated where others were deleted), so compare timings 
+// of single runs, each in its own process. 
+//
+// usage: ./event_phenotype_tests [cells] [steps] [population mode] 
+//        (mode 0: default, 1: event-driven) 
+
+int number_of_cells = 100000; 
+int steps = 100; 
+double dt = 6.0; // phenotype step (min), also used for mechanics and secretion 
+double t = 0.0; 
+
+const int number_of_populations = 3; 
+std::string population_names[number_of_populations] = { "quiescent    ", "proliferating", "oxygen-driven" }; 
+
+void remove_all_cells( void )
+{
+	while( (*all_cells).size() > 0 )
+	{ delete_cell( (int) (*all_cells).size() - 1 ); }
+	return; 
+}
+
+// a square lattice, far enough apart that cells do not touch. Cells that 
+// cycle start spread over the fixed-duration Ki67+ (premitotic) phase, so 
+// that some of them divide within the run. 
+void place_cells( int population )
+{
+	remove_all_cells(); 
+	
+	// Ki67- to Ki67+ (premitotic) 
+	double default_rate = Ki67_advanced.transition_rate( 0 , 1 ); 
+	cell_defaults.phenotype.cycle.data.transition_rate( 0 , 1 ) = ( population == 0 ) ? 1e-5 : default_rate; 
+	cell_defaults.functions.update_phenotype = NULL; 
+	cell_defaults.phenotype.secretion.uptake_rates[0] = 0.0; 
+	if( population == 2 )
+	{
+		// a slow uptake lowers the oxygen (by about 0.2% per step), and so the rates 
+		cell_defaults.functions.update_phenotype = update_cell_and_death_parameters_O2_based; 
+		cell_defaults.phenotype.secretion.uptake_rates[0] = 0.001; 
+	}
+	
+	int n = (int) ceil( sqrt( (double) number_of_cells ) ); 
+	for( int i=0 ; i < number_of_cells ; i++ )
+	{
+		Cell* pCell = create_cell( cell_defaults ); 
+		pCell->assign_position( -0.5*n*25.0 + 25.0*(i % n) , -0.5*n*25.0 + 25.0*(i / n) , 0 ); 
+		if( population > 0 )
+		{
+			pCell->phenotype.cycle.data.current_phase_index = 1; 
+			pCell->phenotype.cycle.data.elapsed_time_in_phase = 
+				UniformRandom() / pCell->phenotype.cycle.data.transition_rate( 1 , 2 ); 
+		}
+	}
+	return; 
+}
+
+// returns the number of divisions and of deaths (removed or still dead) 
+void run_steps( bool event_driven , double& seconds , int& divisions , int& deaths )
+{
+	PhysiCell_settings.enable_event_driven_phenotype = event_driven; 
+	Cell_Container* pContainer = (Cell_Container*) microenvironment.agent_container; 
+	pContainer->num_divisions_in_current_step = 0; 
+	pContainer->num_deaths_in_current_step = 0; 
+	
+	auto start = std::chrono::steady_clock::now(); 
+	for( int s=0 ; s < steps ; s++ )
+	{
+		t += dt; 
+		PhysiCell_globals.current_time = t; 
+		pContainer->update_all_cells( t , dt , dt , dt ); 
+	}
+	auto end = std::chrono::steady_clock::now(); 
+	seconds = std::chrono::duration<double>( end - start ).count(); 
+	
+	divisions = pContainer->num_divisions_in_current_step; 
+	deaths = pContainer->num_deaths_in_current_step; 
+	for( int i=0 ; i < (*all_cells).size() ; i++ )
+	{
+		if( (*all_cells)[i]->phenotype.death.dead )
+		{ deaths++; }
+	}
+	return; 
+}
+
+// the counts are (nearly) Poisson, so their difference has a variance of 
+// about their sum: allow five standard deviations 
+int compare_counts( std::string name , int count0 , int count1 )
+{
+	double spread = 5.0*sqrt( count0 + count1 + 1.0 ); 
+	if( fabs( (double) count0 - (double) count1 ) > spread )
+	{
+		std::cout << "FAILED: the " << name << " differ by more than " << spread << std::endl; 
+		return 1; 
+	}
+	return 0; 
+}
+
+int main( int argc, char* argv[] )
+{
+	if( argc > 1 )
+	{ number_of_cells = atoi( argv[1] ); }
+	if( argc > 2 )
+	{ steps = atoi( argv[2] ); }
+	
+	omp_set_num_threads( 1 ); 
+	SeedRandom( 0 ); 
+	
+	std::cout << ">>>>>>>>>  Event-driven phenotype tests: " << number_of_cells << " cells, " 
+		<< steps << " steps of " << dt << " min" << std::endl; 
+	
+	int n = (int) ceil( sqrt( (double) number_of_cells ) ); 
+	double half_width = 0.5*n*25.0 + 50.0; 
+	microenvironment.name = "event phenotype test"; 
+	microenvironment.set_density( 0 , "oxygen" , "mmHg" ); 
+	microenvironment.resize_space_uniform( -half_width,half_width , -half_width,half_width , -10,10 , 20 ); 
+	for( int i=0 ; i < microenvironment.number_of_voxels() ; i++ )
+	{ microenvironment.density_vector(i)[0] = 38.0; }
+	create_cell_container_for_microenvironment( microenvironment , 30 ); 
+	initialize_default_cell_definition(); 
+	build_cell_definitions_maps(); 
+	setup_signal_behavior_dictionaries(); 
+	cell_defaults.functions.update_velocity = NULL; // no forces, so dt = 6 min is safe 
+	
+	// one timed run 
+	if( argc > 4 )
+	{
+		int population = atoi( argv[3] ); 
+		int mode = atoi( argv[4] ); 
+		double seconds; 
+		int divisions; 
+		int deaths; 
+		place_cells( population ); 
+		run_steps( mode == 1 , seconds , divisions , deaths ); 
+		std::cout << population_names[population] << ( mode == 1 ? " event-driven: " : " default     : " ) 
+			<< 1e3*seconds/steps << " ms/step, " 
+			<< 1e9*seconds/steps/number_of_cells << " ns/cell/step, " 
+			<< divisions << " divisions, " << deaths << " deaths" << std::endl; 
+		return 0; 
+	}
+	
+	int failures = 0; 
+	for( int population=0 ; population < number_of_populations ; population++ )
+	{
+		int divisions[2]; 
+		int deaths[2]; 
+		for( int mode=0 ; mode < 2 ; mode++ )
+		{
+			double seconds; 
+			place_cells( population ); 
+			run_steps( mode == 1 , seconds , divisions[mode] , deaths[mode] ); 
+			std::cout << population_names[population] << ( mode == 1 ? " event-driven: " : " default     : " ) 
+				<< divisions[mode] << " divisions, " << deaths[mode] << " deaths" << std::endl; 
+		}
+		failures += compare_counts( "divisions" , divisions[0] , divisions[1] ); 
+		failures += compare_counts( "deaths" , deaths[0] , deaths[1] ); 
+	}
+	
+	return failures; 
+}
@@ -0,0 +1,286 @@
+/*
+###############################################################################
+# If you use PhysiCell in your project, please cite PhysiCell and the version #
+# number, such as below:                                                      #
+#                                                                             #
+# We implemented and solved the model using PhysiCell (Version x.y.z) [1].    #
+#                                                                             #
+# [1] A Ghaffarizadeh, R Heiland, SH Friedman, SM Mumenthaler, and P Macklin, #
+#     PhysiCell: an Open Source Physics-Based Cell Simulator for Multicellu-  #
+#     lar Systems, PLoS Comput. Biol. 14(2): e1005991, 2018                   #
+#     DOI: 10.1371/journal.pcbi.1005991                                       #
+#                                                                             #
+# See VERSION.txt or call get_PhysiCell_version() to get the current version  #
+#     x.y.z. Call display_citations() to get detailed information on all cite-#
+#     able software used in your PhysiCell application.                       #
+#                                                                             #
+# Because PhysiCell extensively uses BioFVM, we suggest you also cite BioFVM  #
+#     as below:                                                               #
+#                                                                             #
+# We implemented and solved the model using PhysiCell (Version x.y.z) [1],    #
+# with BioFVM [2] to solve the transport equations.                           #
+#                                                                             #
+# [1] A Ghaffarizadeh, R Heiland, SH Friedman, SM Mumenthaler, and P Macklin, #
+#     PhysiCell: an Open Source Physics-Based Cell Simulator for Multicellu-  #
+#     lar Systems, PLoS Comput. Biol. 14(2): e1005991, 2018                   #
+#     DOI: 10.1371/journal.pcbi.1005991                                       #
+#                                                                             #
+# [2] A Ghaffarizadeh, SH Friedman, and P Macklin, BioFVM: an efficient para- #
+#     llelized diffusive transport solver for 3-D biological simulations,     #
+#     Bioinformatics 32(8): 1256-8, 2016. DOI: 10.1093/bioinformatics/btv730  #
+#                                                                             #
+###############################################################################
+#                                                                             #
+# BSD 3-Clause License (see https://opensource.org/licenses/BSD-3-Clause)     #
+#                                                                             #
+# Copyright (c) 2015-2018, Paul Macklin and the PhysiCell Project             #
+# All rights reserved.                                                        #
+#                                                                             #
+# Redistribution and use in source and binary forms, with or without          #
+# modification, are permitted provided that the following conditions are met: #
+#                                                                             #
+# 1. Redistributions of source code must retain the above copyright notice,   #
+# this list of conditions and the following disclaimer.                       #
+#                                                                             #
+# 2. Redistributions in binary form must reproduce the above copyright        #
+# notice, this list of conditions and the following disclaimer in the         #
+# documentation and/or other materials provided with the distribution.        #
+#                                                                             #
+# 3. Neither the name of the copyright holder nor the names of its            #
+# contributors may be used to endorse or promote products derived from this   #
+# software without specific prior written permission.                         #
+#                                                                             #
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" #
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   #
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  #
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   #
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         #
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        #
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    #
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     #
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     #
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  #
+# POSSIBILITY OF SUCH DAMAGE.                                                 #
+#                                                                             #
+###############################################################################
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+#include "../../BioFVM/BioFVM.h" 
+#include "../../BioFVM/BioFVM_MPI.h" 
+
+// Compare the slab-decomposed LOD solver against the serial 3-D LOD solver, 
+// then check halo gradients, agent migration, and ghost agents. 
+//
+// usage: mpirun -np [ranks] ./mpi_tests [voxels per side] [substrates] [steps] 
+
+int nodes = 40; 
+int substrates = 3; 
+int steps = 10; 
+double dt = 0.01; 
+double dx = 20.0; 
+double tolerance = 1e-12; // relative to the largest density 
+
+void setup_problem( BioFVM::Microenvironment& M , int z_offset )
+{
+	M.set_density( 0 , "substrate0" , "dimensionless" , 1e5 , 0.1 ); 
+	for( int q=1 ; q < substrates ; q++ )
+	{
+		M.add_density( "substrate" + std::to_string(q) , "dimensionless" , 
+			1e5 / pow( 10.0 , q ) , 0.1*q ); 
+	}
+	
+	// initial condition from the global voxel indices, so that every rank 
+	// sets exactly the values of the serial problem 
+	for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+	{
+		std::vector<unsigned int> ijk = M.mesh.cartesian_indices( n ); 
+		double x = ijk[0]; 
+		double y = ijk[1]; 
+		double z = ijk[2] + z_offset; 
+		for( int q=0 ; q < substrates ; q++ )
+		{ M(n)[q] = 1.0 + 0.5*sin( 0.2*(q+1)*x ) * cos( 0.4*y + 0.06*(q+1)*z ); }
+	}
+	
+	// Dirichlet conditions on the x-min face and the global z-min face 
+	std::vector<double> boundary_values( substrates , 2.0 ); 
+	for( unsigned int k=0 ; k < M.mesh.z_coordinates.size() ; k++ )
+	{
+		for( unsigned int j=0 ; j < M.mesh.y_coordinates.size() ; j++ )
+		{ M.add_dirichlet_node( M.voxel_index( 0 , j , k ) , boundary_values ); }
+	}
+	if( z_offset == 0 )
+	{
+		for( unsigned int j=0 ; j < M.mesh.y_coordinates.size() ; j++ )
+		{
+			for( unsigned int i=1 ; i < M.mesh.x_coordinates.size() ; i++ )
+			{ M.add_dirichlet_node( M.voxel_index( i , j , 0 ) , boundary_values ); }
+		}
+	}
+	
+	return; 
+}
+
+int main( int argc, char* argv[] )
+{
+	MPI_Init( &argc , &argv ); 
+	
+	if( argc > 1 )
+	{ nodes = atoi( argv[1] ); }
+	if( argc > 2 )
+	{ substrates = atoi( argv[2] ); }
+	if( argc > 3 )
+	{ steps = atoi( argv[3] ); }
+	
+	double L = 0.5 * dx * nodes; 
+	int failures = 0; 
+	
+	// decomposed problem 
+	
+	BioFVM::Microenvironment M; 
+	M.name = "slab"; 
+	M.agent_container = new BioFVM::Agent_Container; 
+	BioFVM::Domain_Decomposition decomposition; 
+	decomposition.setup( M , MPI_COMM_WORLD , -L , L , -L , L , -L , L , dx , dx , dx ); 
+	setup_problem( M , decomposition.z_offset ); 
+	
+	if( decomposition.rank == 0 )
+	{
+		std::cout << ">>>>>>>>>  MPI tests: " << nodes << "^3 voxels, " << substrates << " substrates, " 
+			<< steps << " steps, " << decomposition.size << " ranks" << std::endl; 
+	}
+	
+	MPI_Barrier( MPI_COMM_WORLD ); 
+	auto start = std::chrono::steady_clock::now();
+	for( int i=0 ; i < steps ; i++ )
+	{ M.simulate_diffusion_decay( dt ); }
+	MPI_Barrier( MPI_COMM_WORLD ); 
+	auto end = std::chrono::steady_clock::now();
+	double slab_time = std::chrono::duration<double>( end - start ).count(); 
+	
+	std::vector<double> result = decomposition.gather_densities( M ); 
+	
+	// serial reference, on every rank for the gradient check below 
+	
+	BioFVM::Microenvironment reference; 
+	reference.name = "reference"; 
+	reference.resize_space( -L , L , -L , L , -L , L , dx , dx , dx ); 
+	setup_problem( reference , 0 ); 
+	reference.diffusion_decay_solver = BioFVM::diffusion_decay_solver__constant_coefficients_LOD_3D; 
+	
+	start = std::chrono::steady_clock::now();
+	for( int i=0 ; i < steps ; i++ )
+	{ reference.simulate_diffusion_decay( dt ); }
+	end = std::chrono::steady_clock::now();
+	double reference_time = std::chrono::duration<double>( end - start ).count(); 
+	
+	if( decomposition.rank == 0 )
+	{
+		double scale = 0.0; 
+		double difference = 0.0; 
+		for( unsigned int n=0 ; n < reference.number_of_voxels() ; n++ )
+		{
+			for( int q=0 ; q < substrates ; q++ )
+			{
+				scale = std::max( scale , fabs( reference(n)[q] ) ); 
+				difference = std::max( difference , fabs( reference(n)[q] - result[n*substrates+q] ) ); 
+			}
+		}
+		difference /= scale; 
+		
+		printf( "%-26s %10s %14s\n" , "test" , "time (s)" , "max rel. diff" ); 
+		printf( "%-26s %10.3f %14s\n" , "LOD_3D (serial)" , reference_time , "-" ); 
+		printf( "%-26s %10.3f %14.3e %s\n" , "LOD_3D_MPI" , slab_time , difference , 
+			difference <= tolerance ? "" : "FAILED" ); 
+		if( difference > tolerance )
+		{ failures++; }
+	}
+	
+	// gradients across the slab boundaries 
+	
+	decomposition.compute_all_gradient_vectors( M ); 
+	reference.compute_all_gradient_vectors(); 
+	double gradient_difference = 0.0; 
+	int plane_voxels = nodes*nodes; 
+	for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+	{
+		std::vector<BioFVM::gradient>& local = M.gradient_vector( n ); 
+		std::vector<BioFVM::gradient>& global = reference.gradient_vector( n + decomposition.z_offset*plane_voxels ); 
+		for( int q=0 ; q < substrates ; q++ )
+		{
+			for( int d=0 ; d < 3 ; d++ )
+			{ gradient_difference = std::max( gradient_difference , fabs( local[q][d] - global[q][d] ) ); }
+		}
+	}
+	MPI_Allreduce( MPI_IN_PLACE , &gradient_difference , 1 , MPI_DOUBLE , MPI_MAX , MPI_COMM_WORLD ); 
+	if( decomposition.rank == 0 )
+	{
+		printf( "%-26s %10s %14.3e %s\n" , "gradients" , "" , gradient_difference , 
+			gradient_difference <= tolerance ? "" : "FAILED" ); 
+		if( gradient_difference > tolerance )
+		{ failures++; }
+	}
+	
+	// agents: each rank places agents in its own slab, then moves them up 
+	// by a few voxels so that some cross into the next slab 
+	
+	int agents_per_rank = 50; 
+	double local_z_start = -L + decomposition.z_offset*dx; 
+	double local_z_end = local_z_start + decomposition.local_z_nodes*dx; 
+	for( int a=0 ; a < agents_per_rank ; a++ )
+	{
+		BioFVM::Basic_Agent* pAgent = BioFVM::create_basic_agent(); 
+		pAgent->register_microenvironment( &M ); 
+		pAgent->ID = decomposition.rank*agents_per_rank + a; 
+		double fraction = (a+0.5) / agents_per_rank; 
+		pAgent->assign_position( -L + 2*L*fraction , 0.0 , local_z_start + (local_z_end-local_z_start)*fraction ); 
+		(*pAgent->secretion_rates)[0] = pAgent->ID; 
+	}
+	
+	std::vector<BioFVM::Ghost_Agent> ghosts; 
+	double cutoff = 2.0*dx; 
+	decomposition.exchange_ghost_agents( cutoff , ghosts ); 
+	int bad_ghosts = 0; 
+	for( unsigned int g=0 ; g < ghosts.size() ; g++ )
+	{
+		double z = ghosts[g].position[2]; 
+		if( z > local_z_start - cutoff && z < local_z_start )
+		{ continue; }
+		if( z < local_z_end + cutoff && z > local_z_end )
+		{ continue; }
+		bad_ghosts++; 
+	}
+	
+	for( unsigned int i=0 ; i < BioFVM::all_basic_agents.size() ; i++ )
+	{ BioFVM::all_basic_agents[i]->position[2] += 3.0*dx; }
+	decomposition.migrate_basic_agents( M ); 
+	
+	int total_agents = BioFVM::all_basic_agents.size(); 
+	int misplaced_agents = bad_ghosts; 
+	for( unsigned int i=0 ; i < BioFVM::all_basic_agents.size() ; i++ )
+	{
+		BioFVM::Basic_Agent* pAgent = BioFVM::all_basic_agents[i]; 
+		if( !decomposition.is_local( pAgent->position ) || (*pAgent->secretion_rates)[0] != pAgent->ID )
+		{ misplaced_agents++; }
+	}
+	MPI_Allreduce( MPI_IN_PLACE , &total_agents , 1 , MPI_INT , MPI_SUM , MPI_COMM_WORLD ); 
+	MPI_Allreduce( MPI_IN_PLACE , &misplaced_agents , 1 , MPI_INT , MPI_SUM , MPI_COMM_WORLD ); 
+	if( decomposition.rank == 0 )
+	{
+		bool passed = ( total_agents == agents_per_rank*decomposition.size && misplaced_agents == 0 ); 
+		printf( "%-26s %10s %14s %s\n" , "agent migration" , "" , "-" , passed ? "" : "FAILED" ); 
+		if( !passed )
+		{ failures++; }
+	}
+	
+	MPI_Bcast( &failures , 1 , MPI_INT , 0 , MPI_COMM_WORLD ); 
+	MPI_Finalize(); 
+	
+	return failures; 
+}
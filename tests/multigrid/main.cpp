@@ -0,0 +1,245 @@
+/*
+###############################################################################
+# If you use PhysiCell in your project, please cite PhysiCell and the version #
+# number, such as below:                                                      #
+#                                                                             #
+# We implemented and solved the model using PhysiCell (Version x.y.z) [1].    #
+#                                                                             #
+# [1] A Ghaffarizadeh, R Heiland, SH Friedman, SM Mumenthaler, and P Macklin, #
+#     PhysiCell: an Open Source Physics-Based Cell Simulator for Multicellu-  #
+#     lar Systems, PLoS Comput. Biol. 14(2): e1005991, 2018                   #
+#     DOI: 10.1371/journal.pcbi.1005991                                       #
+#                                                                             #
+# See VERSION.txt or call get_PhysiCell_version() to get the current version  #
+#     x.y.z. Call display_citations() to get detailed information on all cite-#
+#     able software used in your PhysiCell application.                       #
+#                                                                             #
+# Because PhysiCell extensively uses BioFVM, we suggest you also cite BioFVM  #
+#     as below:                                                               #
+#                                                                             #
+# We implemented and solved the model using PhysiCell (Version x.y.z) [1],    #
+# with BioFVM [2] to solve the transport equations.                           #
+#                                                                             #
+# [1] A Ghaffarizadeh, R Heiland, SH Friedman, SM Mumenthaler, and P Macklin, #
+#     PhysiCell: an Open Source Physics-Based Cell Simulator for Multicellu-  #
+#     lar Systems, PLoS Comput. Biol. 14(2): e1005991, 2018                   #
+#     DOI: 10.1371/journal.pcbi.1005991                                       #
+#                                                                             #
+# [2] A Ghaffarizadeh, SH Friedman, and P Macklin, BioFVM: an efficient para- #
+#     llelized diffusive transport solver for 3-D biological simulations,     #
+#     Bioinformatics 32(8): 1256-8, 2016. DOI: 10.1093/bioinformatics/btv730  #
+#                                                                             #
+###############################################################################
+#                                                                             #
+# BSD 3-Clause License (see https://opensource.org/licenses/BSD-3-Clause)     #
+#                                                                             #
+# Copyright (c) 2015-2018, Paul Macklin and the PhysiCell Project             #
+# All rights reserved.                                                        #
+#                                                                             #
+# Redistribution and use in source and binary forms, with or without          #
+# modification, are permitted provided that the following conditions are met: #
+#                                                                             #
+# 1. Redistributions of source code must retain the above copyright notice,   #
+# this list of conditions and the following disclaimer.                       #
+#                                                                             #
+# 2. Redistributions in binary form must reproduce the above copyright        #
+# notice, this list of conditions and the following disclaimer in the         #
+# documentation and/or other materials provided with the distribution.        #
+#                                                                             #
+# 3. Neither the name of the copyright holder nor the names of its            #
+# contributors may be used to endorse or promote products derived from this   #
+# software without specific prior written permission.                         #
+#                                                                             #
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" #
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   #
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  #
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   #
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         #
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        #
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    #
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     #
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     #
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  #
+# POSSIBILITY OF SUCH DAMAGE.                                                 #
+#                                                                             #
+###############################################################################
+*/
+
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+#include "../../BioFVM/BioFVM.h" 
+
+// Convergence and throughput of the multigrid backend, against the 3-D LOD 
+// solver: an oxygen-like field with Dirichlet faces and a ball of consuming 
+// agents in the middle. 
+//
+// usage: ./multigrid_tests [voxels per side] [LOD steps to steady state] [timed steps] 
+
+int nodes = 48; 
+int steady_steps = 2000; 
+int timed_steps = 20; 
+double dt = 0.01; 
+double steady_tolerance = 2e-2; // relative to the boundary value; LOD splits off the uptake, an O(dt) error 
+
+double boundary_value = 38.0; 
+
+void setup( BioFVM::Microenvironment& M , void (*solver)( BioFVM::Microenvironment& , double ) )
+{
+	M.set_density( 0 , "oxygen" , "mmHg" , 1e5 , 0.1 ); 
+	double L = 10.0 * nodes; 
+	M.resize_space( -L , L , -L , L , -L , L , 20.0 , 20.0 , 20.0 ); 
+	M.diffusion_decay_solver = solver; 
+	
+	std::vector<double> values( 1 , boundary_value ); 
+	std::vector<bool> activation( 1 , true ); 
+	for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+	{
+		M(n)[0] = boundary_value; 
+		std::vector<unsigned int> ijk = M.cartesian_indices( n ); 
+		if( ijk[0] == 0 || ijk[1] == 0 || ijk[2] == 0 || ijk[0] == M.mesh.x_coordinates.size()-1 || 
+			ijk[1] == M.mesh.y_coordinates.size()-1 || ijk[2] == M.mesh.z_coordinates.size()-1 )
+		{
+			M.add_dirichlet_node( n , values ); 
+			M.set_substrate_dirichlet_activation( n , activation ); 
+		}
+	}
+	return; 
+}
+
+// consuming agents on a lattice inside a ball of a third of the domain 
+std::vector<BioFVM::Basic_Agent*> place_agents( BioFVM::Microenvironment& M )
+{
+	std::vector<BioFVM::Basic_Agent*> agents; 
+	double R = 10.0 * nodes / 3.0; 
+	for( double x=-R ; x <= R ; x += 30.0 )
+	{
+		for( double y=-R ; y <= R ; y += 30.0 )
+		{
+			for( double z=-R ; z <= R ; z += 30.0 )
+			{
+				if( x*x + y*y + z*z > R*R )
+				{ continue; }
+				BioFVM::Basic_Agent* pAgent = BioFVM::create_basic_agent(); 
+				pAgent->register_microenvironment( &M ); 
+				pAgent->assign_position( x , y , z ); 
+				(*pAgent->uptake_rates)[0] = 10.0; 
+				pAgent->set_internal_uptake_constants( dt ); 
+				agents.push_back( pAgent ); 
+			}
+		}
+	}
+	return agents; 
+}
+
+void remove_agents( std::vector<BioFVM::Basic_Agent*>& agents )
+{
+	for( unsigned int a=0 ; a < agents.size() ; a++ )
+	{ BioFVM::delete_basic_agent( agents[a]->index ); }
+	agents.clear(); 
+	return; 
+}
+
+double max_difference( BioFVM::Microenvironment& A , BioFVM::Microenvironment& B )
+{
+	double difference = 0.0; 
+	for( unsigned int n=0 ; n < A.number_of_voxels() ; n++ )
+	{ difference = std::max( difference , fabs( A(n)[0] - B(n)[0] ) ); }
+	return difference; 
+}
+
+int main( int argc, char* argv[] )
+{
+	if( argc > 1 )
+	{ nodes = atoi( argv[1] ); }
+	if( argc > 2 )
+	{ steady_steps = atoi( argv[2] ); }
+	if( argc > 3 )
+	{ timed_steps = atoi( argv[3] ); }
+
+	std::cout << ">>>>>>>>>  Multigrid tests: " << nodes << "^3 voxels" << std::endl; 
+	int failures = 0; 
+	
+	// convergence of the steady-state solve 
+	
+	BioFVM::Microenvironment steady; 
+	setup( steady , BioFVM::diffusion_decay_solver__constant_coefficients_multigrid ); 
+	std::vector<BioFVM::Basic_Agent*> agents = place_agents( steady ); 
+	printf( "%d consuming agents\n\n" , (int) agents.size() ); 
+	
+	printf( "%-12s %8s %16s %10s\n" , "tolerance" , "cycles" , "rate per cycle" , "time (s)" ); 
+	std::vector<double> tolerances = { 1e-2 , 1e-4 , 1e-6 , 1e-8 , 1e-10 }; 
+	double steady_time = 0.0; 
+	for( unsigned int t=0 ; t < tolerances.size() ; t++ )
+	{
+		for( unsigned int n=0 ; n < steady.number_of_voxels() ; n++ )
+		{ steady(n)[0] = boundary_value; }
+		steady.set_multigrid_tolerance( tolerances[t] , 100 ); 
+		
+		auto start = std::chrono::steady_clock::now();
+		int cycles = BioFVM::multigrid_steady_state_solve( steady , agents ); 
+		auto end = std::chrono::steady_clock::now();
+		
+		steady_time = std::chrono::duration<double>( end - start ).count(); 
+		printf( "%-12.0e %8d %16.3f %10.3f %s\n" , tolerances[t] , cycles , pow( tolerances[t] , 1.0/cycles ) , 
+			steady_time , cycles < 100 ? "" : "FAILED" ); 
+		if( cycles >= 100 )
+		{ failures++; }
+	}
+	remove_agents( agents ); 
+	
+	// the same steady state by LOD time stepping 
+	
+	BioFVM::Microenvironment stepped; 
+	setup( stepped , BioFVM::diffusion_decay_solver__constant_coefficients_LOD_3D ); 
+	agents = place_agents( stepped ); 
+	auto start = std::chrono::steady_clock::now();
+	for( int i=0 ; i < steady_steps ; i++ )
+	{
+		stepped.simulate_diffusion_decay( dt ); 
+		stepped.simulate_cell_sources_and_sinks( agents , dt ); 
+	}
+	auto end = std::chrono::steady_clock::now();
+	double stepped_time = std::chrono::duration<double>( end - start ).count(); 
+	remove_agents( agents ); 
+	
+	double difference = max_difference( steady , stepped ) / boundary_value; 
+	printf( "\nsteady state vs %d LOD steps (%.3f s, %.1fx the multigrid solve): max rel. diff %.3e %s\n\n" , 
+		steady_steps , stepped_time , stepped_time / steady_time , difference , 
+		difference <= steady_tolerance ? "" : "FAILED" ); 
+	if( difference > steady_tolerance )
+	{ failures++; }
+	
+	// throughput of one diffusion-decay step (agents handled by the split step) 
+	
+	printf( "%-12s %14s %9s\n" , "solver" , "time/step (s)" , "speedup" ); 
+	double LOD_time = 0.0; 
+	std::vector< void (*)( BioFVM::Microenvironment& , double ) > solvers = { 
+		BioFVM::diffusion_decay_solver__constant_coefficients_LOD_3D , 
+		BioFVM::diffusion_decay_solver__constant_coefficients_multigrid }; 
+	std::vector< std::string > names = { "LOD_3D" , "multigrid" }; 
+	for( unsigned int s=0 ; s < solvers.size() ; s++ )
+	{
+		BioFVM::Microenvironment M; 
+		setup( M , solvers[s] ); 
+		for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+		{ M(n)[0] = stepped(n)[0]; }
+		M.simulate_diffusion_decay( dt ); // set-up 
+		
+		auto start = std::chrono::steady_clock::now();
+		for( int i=0 ; i < timed_steps ; i++ )
+		{ M.simulate_diffusion_decay( dt ); }
+		auto end = std::chrono::steady_clock::now();
+		double time = std::chrono::duration<double>( end - start ).count() / timed_steps; 
+		if( s == 0 )
+		{ LOD_time = time; }
+		printf( "%-12s %14.4f %9.2f\n" , names[s].c_str() , time , LOD_time / time ); 
+	}
+	
+	return failures; 
+}
@@ -0,0 +1,262 @@
+/*
+###############################################################################
+# If you use PhysiCell in your project, please cite PhysiCell and the version #
+# number, such as below:                                                      #
+#                                                                             #
+# We implemented and solved the model using PhysiCell (Version x.y.z) [1].    #
+#                                                                             #
+# [1] A Ghaffarizadeh, R Heiland, SH Friedman, SM Mumenthaler, and P Macklin, #
+#     PhysiCell: an Open Source Physics-Based Cell Simulator for Multicellu-  #
+#     lar Systems, PLoS Comput. Biol. 14(2): e1005991, 2018                   #
+#     DOI: 10.1371/journal.pcbi.1005991                                       #
+#                                                                             #
+# See VERSION.txt or call get_PhysiCell_version() to get the current version  #
+#     x.y.z. Call display_citations() to get detailed information on all cite-#
+#     able software used in your PhysiCell application.                       #
+#                                                                             #
+# Because PhysiCell extensively uses BioFVM, we suggest you also cite BioFVM  #
+#     as below:                                                               #
+#                                                                             #
+# We implemented and solved the model using PhysiCell (Version x.y.z) [1],    #
+# with BioFVM [2] to solve the transport equations.                           #
+#                                                                             #
+# [1] A Ghaffarizadeh, R Heiland, SH Friedman, SM Mumenthaler, and P Macklin, #
+#     PhysiCell: an Open Source Physics-Based Cell Simulator for Multicellu-  #
+#     lar Systems, PLoS Comput. Biol. 14(2): e1005991, 2018                   #
+#     DOI: 10.1371/journal.pcbi.1005991                                       #
+#                                                                             #
+# [2] A Ghaffarizadeh, SH Friedman, and P Macklin, BioFVM: an efficient para- #
+#     llelized diffusive transport solver for 3-D biological simulations,     #
+#     Bioinformatics 32(8): 1256-8, 2016. DOI: 10.1093/bioinformatics/btv730  #
+#                                                                             #
+###############################################################################
+#                                                                             #
+# BSD 3-Clause License (see https://opensource.org/licenses/BSD-3-Clause)     #
+#                                                                             #
+# Copyright (c) 2015-2018, Paul Macklin and the PhysiCell Project             #
+# All rights reserved.                                                        #
+#                                                                             #
+# Redistribution and use in source and binary forms, with or without          #
+# modification, are permitted provided that the following conditions are met: #
+#                                                                             #
+# 1. Redistributions of source code must retain the above copyright notice,   #
+# this list of conditions and the following disclaimer.                       #
+#                                                                             #
+# 2. Redistributions in binary form must reproduce the above copyright        #
+# notice, this list of conditions and the following disclaimer in the         #
+# documentation and/or other materials provided with the distribution.        #
+#                                                                             #
+# 3. Neither the name of the copyright holder nor the names of its            #
+# contributors may be used to endorse or promote products derived from this   #
+# software without specific prior written permission.                         #
+#                                                                             #
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" #
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   #
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  #
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   #
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         #
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        #
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    #
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     #
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     #
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  #
+# POSSIBILITY OF SUCH DAMAGE.                                                 #
+#                                                                             #
+###############################################################################
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <chrono>
+#include <random>
+#include <omp.h>
+
+#include "../../BioFVM/BioFVM.h" 
+
+// Check the voxel-binned cell source/sink solver 
+// (Microenvironment::simulate_cell_sources_and_sinks) against a serial sweep 
+// over the agents in list order: the densities and the internalized 
+// substrates must match bit for bit at 1, 4, and 8 threads. Then time it 
+// against the baseline scatter (a parallel loop over the agents, which races 
+// when two agents share a voxel). 
+//
+// usage: ./secretion_tests [voxels per side] [agents] [steps] 
+
+using namespace BioFVM; 
+
+int nodes = 64; 
+int number_of_agents = 200000; 
+int steps = 10; 
+int substrates = 4; 
+double dt = 0.01; 
+
+std::mt19937_64 generator( 0 ); 
+std::uniform_real_distribution<double> uniform( 0.0 , 1.0 ); 
+double UniformRandom( void )
+{ return uniform( generator ); }
+
+std::vector< std::vector<double> > initial_densities; 
+std::vector< std::vector<double> > initial_internalized; 
+
+void reset( Microenvironment& M )
+{
+	for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+	{ M(n) = initial_densities[n]; }
+	for( unsigned int i=0 ; i < all_basic_agents.size() ; i++ )
+	{ *(all_basic_agents[i]->internalized_substrates) = initial_internalized[i]; }
+	return; 
+}
+
+bool bitwise_equal( const std::vector<double>& a , const std::vector<double>& b )
+{
+	return a.size() == b.size() && 
+		std::memcmp( a.data() , b.data() , a.size()*sizeof(double) ) == 0; 
+}
+
+int compare( Microenvironment& M , 
+	std::vector< std::vector<double> >& densities , std::vector< std::vector<double> >& internalized )
+{
+	int mismatches = 0; 
+	for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+	{
+		if( !bitwise_equal( M(n) , densities[n] ) )
+		{ mismatches++; }
+	}
+	for( unsigned int i=0 ; i < all_basic_agents.size() ; i++ )
+	{
+		if( !bitwise_equal( *(all_basic_agents[i]->internalized_substrates) , internalized[i] ) )
+		{ mismatches++; }
+	}
+	return mismatches; 
+}
+
+void serial_sweep( Microenvironment& M )
+{
+	for( unsigned int i=0 ; i < all_basic_agents.size() ; i++ )
+	{ all_basic_agents[i]->simulate_secretion_and_uptake( &M , dt ); }
+	return; 
+}
+
+void baseline_scatter( Microenvironment& M )
+{
+	#pragma omp parallel for 
+	for( int i=0 ; i < (int) all_basic_agents.size() ; i++ )
+	{ all_basic_agents[i]->simulate_secretion_and_uptake( &M , dt ); }
+	return; 
+}
+
+double time_steps( Microenvironment& M , bool binned )
+{
+	reset( M ); 
+	auto start = std::chrono::steady_clock::now(); 
+	for( int s=0 ; s < steps ; s++ )
+	{
+		if( binned )
+		{ M.simulate_cell_sources_and_sinks( all_basic_agents , dt ); }
+		else
+		{ baseline_scatter( M ); }
+	}
+	auto end = std::chrono::steady_clock::now(); 
+	return std::chrono::duration<double>( end - start ).count(); 
+}
+
+int main( int argc, char* argv[] )
+{
+	if( argc > 1 )
+	{ nodes = atoi( argv[1] ); }
+	if( argc > 2 )
+	{ number_of_agents = atoi( argv[2] ); }
+	if( argc > 3 )
+	{ steps = atoi( argv[3] ); }
+	int max_threads = omp_get_max_threads(); 
+	
+	std::cout << ">>>>>>>>>  Cell source/sink tests: " << nodes << "^3 voxels, " 
+		<< number_of_agents << " agents, " << steps << " steps, " 
+		<< max_threads << " threads" << std::endl; 
+	
+	Microenvironment M; 
+	M.name = "secretion test"; 
+	M.set_density( 0 , "substrate0" , "dimensionless" , 1e3 , 0.1 ); 
+	for( int q=1 ; q < substrates ; q++ )
+	{ M.add_density( "substrate" + std::to_string(q) , "dimensionless" , 1e3 , 0.1 ); }
+	double L = 10.0 * nodes; 
+	M.resize_space( -L , L , -L , L , -L , L , 20.0 , 20.0 , 20.0 ); 
+	set_default_microenvironment( &M ); 
+	default_microenvironment_options.track_internalized_substrates_in_each_agent = true; 
+	
+	Agent_Container container; 
+	container.initialize( M.number_of_voxels() ); 
+	M.agent_container = &container; 
+	
+	for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+	{
+		for( int q=0 ; q < substrates ; q++ )
+		{ M(n)[q] = 10.0 * UniformRandom(); }
+	}
+	
+	// agents in random list order, packed into the middle of the domain so 
+	// that many of them share a voxel 
+	for( int i=0 ; i < number_of_agents ; i++ )
+	{
+		Basic_Agent* pAgent = create_basic_agent(); 
+		pAgent->set_total_volume( 500.0 + 2000.0*UniformRandom() ); 
+		for( int q=0 ; q < substrates ; q++ )
+		{
+			(*pAgent->secretion_rates)[q] = UniformRandom(); 
+			(*pAgent->saturation_densities)[q] = 20.0 * UniformRandom(); 
+			(*pAgent->uptake_rates)[q] = 0.1 * UniformRandom(); 
+			(*pAgent->net_export_rates)[q] = UniformRandom() - 0.5; 
+			(*pAgent->internalized_substrates)[q] = 100.0 * UniformRandom(); 
+		}
+		pAgent->assign_position( 0.5*L*(2*UniformRandom()-1) , 
+			0.5*L*(2*UniformRandom()-1) , 0.5*L*(2*UniformRandom()-1) ); 
+	}
+	
+	initial_densities.resize( M.number_of_voxels() ); 
+	for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+	{ initial_densities[n] = M(n); }
+	initial_internalized.resize( all_basic_agents.size() ); 
+	for( unsigned int i=0 ; i < all_basic_agents.size() ; i++ )
+	{ initial_internalized[i] = *(all_basic_agents[i]->internalized_substrates); }
+	
+	// reference: a serial sweep in list order 
+	reset( M ); 
+	for( int s=0 ; s < steps ; s++ )
+	{ serial_sweep( M ); }
+	std::vector< std::vector<double> > reference_densities( M.number_of_voxels() ); 
+	for( unsigned int n=0 ; n < M.number_of_voxels() ; n++ )
+	{ reference_densities[n] = M(n); }
+	std::vector< std::vector<double> > reference_internalized( all_basic_agents.size() ); 
+	for( unsigned int i=0 ; i < all_basic_agents.size() ; i++ )
+	{ reference_internalized[i] = *(all_basic_agents[i]->internalized_substrates); }
+	
+	int failures = 0; 
+	int thread_counts [] = {1,4,8}; 
+	for( int t : thread_counts )
+	{
+		omp_set_num_threads( t ); 
+		reset( M ); 
+		for( int s=0 ; s < steps ; s++ )
+		{ M.simulate_cell_sources_and_sinks( all_basic_agents , dt ); }
+		int mismatches = compare( M , reference_densities , reference_internalized ); 
+		
+		std::printf( "binned, %d threads: %d mismatched voxels and agents %s\n" , 
+			t , mismatches , mismatches == 0 ? "(bitwise identical)" : "FAILED" ); 
+		if( mismatches > 0 )
+		{ failures++; }
+	}
+	
+	omp_set_num_threads( max_threads ); 
+	// warm up both, then time them 
+	time_steps( M , false ); 
+	time_steps( M , true ); 
+	double baseline_time = time_steps( M , false ); 
+	double binned_time = time_steps( M , true ); 
+	std::printf( "baseline scatter: %9.4f s\n" , baseline_time ); 
+	std::printf( "binned          : %9.4f s (speedup %.2fx)\n" , binned_time , baseline_time / binned_time ); 
+	
+	return failures; 
+}